@@ -47,6 +47,7 @@ static void PRIV_PlatformInitialize() {
 // =========================================================
 
 extern void INTERNAL_BC_MemoryInitialize();
+extern void INTERNAL_BC_SlabInitialize();
 
 static BC_bool BC_IsInitialized = BC_false;
 
@@ -59,6 +60,7 @@ void BC_Initialize(const int argc, char** argv) {
 	PRIV_PlatformInitialize();
 
 	INTERNAL_BC_MemoryInitialize();
+	INTERNAL_BC_SlabInitialize();
 
 	BC_IsInitialized = BC_true;
 }
@@ -67,11 +69,25 @@ void BC_Initialize(const int argc, char** argv) {
 // MARK: DEINITIALIZE
 // =========================================================
 
+extern void INTERNAL_BC_SlabDeinitialize();
+extern void INTERNAL_BC_ThreadCacheDeinitialize();
+extern void INTERNAL_BC_MemoryMonitorDeinitialize();
+extern void INTERNAL_BC_TaskPoolDeinitialize();
+extern void INTERNAL_BC_EpochDeinitialize();
+extern void INTERNAL_BC_FiberDeinitialize();
+
 static BC_bool BC_IsDeinitialized = BC_false;
 
 void BC_Deinitialize(void) {
 	if (BC_IsDeinitialized || !BC_IsInitialized) return;
 
+	INTERNAL_BC_TaskPoolDeinitialize();
+	INTERNAL_BC_EpochDeinitialize();
+	INTERNAL_BC_FiberDeinitialize();
+	INTERNAL_BC_MemoryMonitorDeinitialize();
+	INTERNAL_BC_SlabDeinitialize();
+	INTERNAL_BC_ThreadCacheDeinitialize();
+
 	BC_MemoryInfoPrint();
 
 	BC_IsDeinitialized = BC_true;
@@ -5,4 +5,17 @@
 
 #define BC_SETTINGS_DEBUG_ALLOCATION_TRACK 1
 
+// Records the call stack of every tracked allocation, see BC_MemoryProfile.h. Requires allocation tracking.
+#define BC_SETTINGS_DEBUG_ALLOCATION_PROFILE 0
+
+// Compiles in the allocation sampler, see BC_MemorySampler.h. Sampling stays off until an interval is set.
+#define BC_SETTINGS_ALLOCATION_SAMPLING 1
+
+// Counts acquisitions, contended acquisitions and time spent waiting on every BCLock, see BC_LockGetStats
+#define BC_SETTINGS_LOCK_STATS 0
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_PROFILE == 1 && BC_SETTINGS_DEBUG_ALLOCATION_TRACK != 1
+#error "BC_SETTINGS_DEBUG_ALLOCATION_PROFILE requires BC_SETTINGS_DEBUG_ALLOCATION_TRACK"
+#endif
+
 #endif //BCORE_SETTINGS_H
@@ -14,6 +14,14 @@ typedef _Bool BC_bool;
 // =========================================================
 
 typedef struct BC_Allocator* BC_AllocatorRef;
+typedef struct BC_AllocatorTracker* BC_AllocatorTrackerRef;
 typedef struct BC_Arena* BC_ArenaRef;
+typedef struct BC_Fiber* BC_FiberRef;
+typedef struct BC_MPMCQueue* BC_MPMCQueueRef;
+typedef struct BC_Pool* BC_PoolRef;
+typedef struct BC_RunLoop* BC_RunLoopRef;
+typedef struct BC_SPSCQueue* BC_SPSCQueueRef;
+typedef struct BC_Slab* BC_SlabRef;
+typedef struct BC_TaskPool* BC_TaskPoolRef;
 
 #endif //BCORE_TYPES_H
\ No newline at end of file
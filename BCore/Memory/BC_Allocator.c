@@ -3,6 +3,7 @@
 #include "BC_Memory.h"
 #include "../BC_Keywords.h"
 
+#include <stdint.h>
 #include <string.h>
 
 // =========================================================
@@ -19,7 +20,35 @@ static void IMPL_AllocatorDefaultFree(void* ptr, const void* ctx) {
 	BC_Free(ptr);
 }
 
-static BC_Allocator const PRIV_kAllocatorSystem = {IMPL_AllocatorDefaultAlloc, IMPL_AllocatorDefaultFree, NULL};
+#if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1 || !defined(_WIN32)
+static void* IMPL_AllocatorDefaultAllocAligned(const size_t size, const size_t alignment, const void* ctx) {
+	(void)ctx;
+	return BC_MallocAligned(size, alignment);
+}
+#else
+// _aligned_malloc memory can not be released by BC_Free, use the generic fallback
+#define IMPL_AllocatorDefaultAllocAligned NULL
+#endif
+
+static void IMPL_AllocatorDefaultFreeSized(void* ptr, const size_t size, const void* ctx) {
+	(void)ctx;
+	BC_FreeSized(ptr, size);
+}
+
+static void* IMPL_AllocatorDefaultRealloc(void* ptr, const size_t oldSize, const size_t newSize, const void* ctx) {
+	(void)oldSize;
+	(void)ctx;
+	return BC_Realloc(ptr, newSize);
+}
+
+static BC_Allocator const PRIV_kAllocatorSystem = {
+	IMPL_AllocatorDefaultAlloc,
+	IMPL_AllocatorDefaultFree,
+	NULL,
+	IMPL_AllocatorDefaultAllocAligned,
+	IMPL_AllocatorDefaultRealloc,
+	IMPL_AllocatorDefaultFreeSized
+};
 const BC_AllocatorRef kBC_AllocatorRefSystem = (BC_AllocatorRef)&PRIV_kAllocatorSystem;
 
 BC_TLS BC_AllocatorRef PRIV_gAllocatorDefault = kBC_AllocatorRefSystem;
@@ -33,14 +62,25 @@ void* BC_AllocatorAlloc(BC_AllocatorRef allocator, const size_t size) {
 	return allocator->alloc(size, allocator->context);
 }
 
-void* BC_AllocatorRealloc(const BC_AllocatorRef allocator, void* ptr, const size_t oldSize, const size_t newSize) {
-	char* newBuffer = BC_AllocatorAlloc(allocator, newSize);
+void* BC_AllocatorRealloc(BC_AllocatorRef allocator, void* ptr, const size_t oldSize, const size_t newSize) {
+	if (!allocator) allocator = kBC_AllocatorRefSystem;
+	if (!ptr) return BC_AllocatorAlloc(allocator, newSize);
+
+	char* newBuffer;
+	if (allocator->realloc) {
+		newBuffer = allocator->realloc(ptr, oldSize, newSize, allocator->context);
+	} else {
+		newBuffer = BC_AllocatorAlloc(allocator, newSize);
+		if (newBuffer) {
+			memcpy(newBuffer, ptr, oldSize < newSize ? oldSize : newSize);
+			BC_AllocatorFreeSized(allocator, ptr, oldSize);
+		}
+	}
+
 	if (!newBuffer) {
 		fprintf(stderr, "BC_AllocatorRealloc: Failed to allocate buffer\n");
 		return NULL;
 	}
-	memcpy(newBuffer, ptr, oldSize);
-	BC_AllocatorFree(allocator, ptr);
 	return newBuffer;
 }
 
@@ -49,6 +89,46 @@ void BC_AllocatorFree(BC_AllocatorRef allocator, void* ptr) {
 	allocator->free(ptr, allocator->context);
 }
 
+void BC_AllocatorFreeSized(BC_AllocatorRef allocator, void* ptr, const size_t size) {
+	if (!allocator) allocator = kBC_AllocatorRefSystem;
+	if (allocator->freeSized) {
+		allocator->freeSized(ptr, size, allocator->context);
+	} else {
+		allocator->free(ptr, allocator->context);
+	}
+}
+
+void* BC_AllocatorAllocAligned(BC_AllocatorRef allocator, const size_t size, const size_t alignment) {
+	if (!allocator) allocator = kBC_AllocatorRefSystem;
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+		fprintf(stderr, "BC_AllocatorAllocAligned: Alignment %zu is not a power of two\n", alignment);
+		return NULL;
+	}
+
+	if (allocator->allocAligned) {
+		return allocator->allocAligned(size, alignment, allocator->context);
+	}
+
+	// Fallback: over-allocate and keep the original pointer right before the aligned one
+	char* raw = allocator->alloc(size + alignment - 1 + sizeof(void*), allocator->context);
+	if (!raw) return NULL;
+
+	void** aligned = (void**)(((uintptr_t)raw + sizeof(void*) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	aligned[-1] = raw;
+	return aligned;
+}
+
+void BC_AllocatorFreeAligned(BC_AllocatorRef allocator, void* ptr) {
+	if (!ptr) return;
+	if (!allocator) allocator = kBC_AllocatorRefSystem;
+
+	if (allocator->allocAligned) {
+		allocator->free(ptr, allocator->context);
+	} else {
+		allocator->free(((void**)ptr)[-1], allocator->context);
+	}
+}
+
 BC_AllocatorRef BC_AllocatorGetDefault() {
 	return PRIV_gAllocatorDefault;
 }
@@ -5,10 +5,22 @@
 
 #include <string.h>
 
+#define BC_CACHE_LINE_SIZE 64
+
 typedef struct BC_Allocator {
 	void* (*alloc)(size_t size, const void* ctx);
 	void (*free)(void* ptr, const void* ctx);
 	void* context;
+	// Optional, memory it returns is released with free. When NULL,
+	// BC_AllocatorAllocAligned over-allocates through alloc instead.
+	void* (*allocAligned)(size_t size, size_t alignment, const void* ctx);
+	// Optional, resizes in place when possible. When NULL,
+	// BC_AllocatorRealloc does alloc + memcpy + free instead.
+	void* (*realloc)(void* ptr, size_t oldSize, size_t newSize, const void* ctx);
+	// Optional, `size` is the size the block was allocated or last resized with, so
+	// size class allocators can find the class without a header. When NULL,
+	// BC_AllocatorFreeSized calls free instead.
+	void (*freeSized)(void* ptr, size_t size, const void* ctx);
 } BC_Allocator;
 
 extern const BC_AllocatorRef kBC_AllocatorRefSystem;
@@ -16,6 +28,11 @@ extern const BC_AllocatorRef kBC_AllocatorRefSystem;
 void* BC_AllocatorAlloc(BC_AllocatorRef allocator, size_t size);
 void* BC_AllocatorRealloc(BC_AllocatorRef allocator, void* ptr, size_t oldSize, size_t newSize);
 void BC_AllocatorFree(BC_AllocatorRef allocator, void* ptr);
+void BC_AllocatorFreeSized(BC_AllocatorRef allocator, void* ptr, size_t size);
+
+// Alignment must be a power of two, memory must be released with BC_AllocatorFreeAligned
+void* BC_AllocatorAllocAligned(BC_AllocatorRef allocator, size_t size, size_t alignment);
+void BC_AllocatorFreeAligned(BC_AllocatorRef allocator, void* ptr);
 
 void BC_AllocatorSetDefault(BC_AllocatorRef allocator);
 BC_AllocatorRef BC_AllocatorGetDefault();
@@ -0,0 +1,270 @@
+#include "BC_AllocatorTracker.h"
+
+#include "BC_Memory.h"
+#include "../BC_Types.h"
+#include "../Thread/BC_Atomics.h"
+#include "../Thread/BC_Threads.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// =========================================================
+// MARK: Structures
+// =========================================================
+
+// Keeps blocks 16 bytes aligned past the header
+#define PRIV_TRACKER_HEADER_SIZE sizeof(PRIV_TrackerHeader)
+
+typedef struct PRIV_TrackerHeader {
+	size_t size;
+	uint32_t offset;    // Distance from the wrapped allocator block to the user block
+	uint32_t aligned;   // Block came from BC_AllocatorAllocAligned on the wrapped allocator
+} PRIV_TrackerHeader;
+
+typedef struct BC_AllocatorTracker {
+	BC_Allocator allocator;        // The allocator interface for this tracker
+	BC_AllocatorRef wrapped;
+	char* name;
+	struct BC_AllocatorTracker* next;
+
+	BC_atomic_size allocationCount;
+	BC_atomic_size freeCount;
+	BC_atomic_size totalAllocated;
+	BC_atomic_size currentUsage;
+	BC_atomic_size peakUsage;
+	BC_atomic_size histogram[BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS];
+} BC_AllocatorTracker;
+
+// Only create, destroy and print take the lock, allocations never do
+static BC_AllocatorTracker* gTrackers = NULL;
+BC_MUTEX_MAYBE(gTrackersMutex)
+BC_ONCE_MAYBE_STATIC(gTrackersOnce)
+
+static void PRIV_TrackerSetup(void) {
+	BC_MutexInit(&gTrackersMutex);
+}
+
+// =========================================================
+// MARK: Counters
+// =========================================================
+
+static inline size_t PRIV_TrackerBucket(const size_t size) {
+	if (size <= 16) return 0;
+	// Index of the smallest power of two holding `size`, 16 bytes being bucket 0
+	const size_t bucket = (size_t)(64 - __builtin_clzll((unsigned long long)(size - 1))) - 4;
+	return bucket < BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS ? bucket : BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS - 1;
+}
+
+static void PRIV_TrackerAccountAlloc(BC_AllocatorTracker* tracker, const size_t size) {
+	BC_atomic_fetch_add(&tracker->allocationCount, 1);
+	BC_atomic_fetch_add(&tracker->totalAllocated, size);
+	BC_atomic_fetch_add(&tracker->histogram[PRIV_TrackerBucket(size)], 1);
+
+	const size_t usage = BC_atomic_fetch_add(&tracker->currentUsage, size) + size;
+	size_t peak = BC_atomic_load_relaxed(&tracker->peakUsage);
+	while (usage > peak && !BC_atomic_compare_exchange(&tracker->peakUsage, &peak, usage)) {}
+}
+
+static void PRIV_TrackerAccountFree(BC_AllocatorTracker* tracker, const size_t size) {
+	BC_atomic_fetch_add(&tracker->freeCount, 1);
+	BC_atomic_fetch_sub(&tracker->currentUsage, size);
+}
+
+static inline PRIV_TrackerHeader* PRIV_TrackerHeaderOf(void* ptr) {
+	return (PRIV_TrackerHeader*)ptr - 1;
+}
+
+// =========================================================
+// MARK: Allocator Implementation
+// =========================================================
+
+static void* IMPL_TrackerAlloc(const size_t size, const void* ctx) {
+	BC_AllocatorTracker* tracker = (BC_AllocatorTracker*)ctx;
+	if (size == 0) return NULL;
+
+	PRIV_TrackerHeader* header = BC_AllocatorAlloc(tracker->wrapped, PRIV_TRACKER_HEADER_SIZE + size);
+	if (!header) return NULL;
+
+	*header = (PRIV_TrackerHeader){size, PRIV_TRACKER_HEADER_SIZE, 0};
+	PRIV_TrackerAccountAlloc(tracker, size);
+	return header + 1;
+}
+
+static void* IMPL_TrackerAllocAligned(const size_t size, size_t alignment, const void* ctx) {
+	BC_AllocatorTracker* tracker = (BC_AllocatorTracker*)ctx;
+	if (size == 0) return NULL;
+
+	// The header takes a whole alignment step so the block keeps the requested alignment
+	if (alignment < PRIV_TRACKER_HEADER_SIZE) alignment = PRIV_TRACKER_HEADER_SIZE;
+	char* base = BC_AllocatorAllocAligned(tracker->wrapped, alignment + size, alignment);
+	if (!base) return NULL;
+
+	char* ptr = base + alignment;
+	*PRIV_TrackerHeaderOf(ptr) = (PRIV_TrackerHeader){size, (uint32_t)alignment, 1};
+	PRIV_TrackerAccountAlloc(tracker, size);
+	return ptr;
+}
+
+static void IMPL_TrackerFree(void* ptr, const void* ctx) {
+	BC_AllocatorTracker* tracker = (BC_AllocatorTracker*)ctx;
+	if (!ptr) return;
+
+	const PRIV_TrackerHeader header = *PRIV_TrackerHeaderOf(ptr);
+	PRIV_TrackerAccountFree(tracker, header.size);
+
+	char* base = (char*)ptr - header.offset;
+	if (header.aligned) {
+		BC_AllocatorFreeAligned(tracker->wrapped, base);
+	} else {
+		BC_AllocatorFreeSized(tracker->wrapped, base, PRIV_TRACKER_HEADER_SIZE + header.size);
+	}
+}
+
+static void IMPL_TrackerFreeSized(void* ptr, const size_t size, const void* ctx) {
+	// The header already knows the size, the wrapped allocator gets it either way
+	(void)size;
+	IMPL_TrackerFree(ptr, ctx);
+}
+
+static void* IMPL_TrackerRealloc(void* ptr, const size_t oldSize, const size_t newSize, const void* ctx) {
+	BC_AllocatorTracker* tracker = (BC_AllocatorTracker*)ctx;
+	PRIV_TrackerHeader* header = PRIV_TrackerHeaderOf(ptr);
+
+	if (header->aligned || newSize == 0) {
+		void* newPtr = IMPL_TrackerAlloc(newSize, ctx);
+		if (!newPtr) return NULL;
+		memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+		IMPL_TrackerFree(ptr, ctx);
+		return newPtr;
+	}
+
+	// Let the wrapped allocator resize in place, the header moves along with the block
+	const size_t previousSize = header->size;
+	header = BC_AllocatorRealloc(tracker->wrapped, header, PRIV_TRACKER_HEADER_SIZE + previousSize, PRIV_TRACKER_HEADER_SIZE + newSize);
+	if (!header) return NULL;
+
+	header->size = newSize;
+	PRIV_TrackerAccountFree(tracker, previousSize);
+	PRIV_TrackerAccountAlloc(tracker, newSize);
+	return header + 1;
+}
+
+// =========================================================
+// MARK: Public API
+// =========================================================
+
+BC_AllocatorTrackerRef BC_AllocatorTrackerCreate(const char* name, BC_AllocatorRef wrapped) {
+	if (!wrapped) wrapped = kBC_AllocatorRefSystem;
+
+	BC_AllocatorTracker* tracker = BC_Calloc(1, sizeof(BC_AllocatorTracker));
+	if (!tracker) {
+		fprintf(stderr, "BC_AllocatorTrackerCreate: Failed to allocate tracker structure\n");
+		return NULL;
+	}
+
+	tracker->allocator.alloc = IMPL_TrackerAlloc;
+	tracker->allocator.free = IMPL_TrackerFree;
+	tracker->allocator.context = tracker;
+	tracker->allocator.allocAligned = IMPL_TrackerAllocAligned;
+	tracker->allocator.realloc = IMPL_TrackerRealloc;
+	tracker->allocator.freeSized = IMPL_TrackerFreeSized;
+	tracker->wrapped = wrapped;
+	tracker->name = BC_Strdup(name ? name : "<unnamed>");
+
+	BC_RunOnce(&gTrackersOnce, PRIV_TrackerSetup);
+	BC_MutexLock(&gTrackersMutex);
+	tracker->next = gTrackers;
+	gTrackers = tracker;
+	BC_MutexUnlock(&gTrackersMutex);
+
+	return tracker;
+}
+
+void BC_AllocatorTrackerDestroy(const BC_AllocatorTrackerRef tracker) {
+	if (!tracker) return;
+
+	BC_MutexLock(&gTrackersMutex);
+	BC_AllocatorTracker** link = &gTrackers;
+	while (*link && *link != tracker) link = &(*link)->next;
+	if (*link) *link = tracker->next;
+	BC_MutexUnlock(&gTrackersMutex);
+
+	BC_Free(tracker->name);
+	BC_Free(tracker);
+}
+
+BC_AllocatorRef BC_AllocatorTrackerAllocator(const BC_AllocatorTrackerRef tracker) {
+	if (!tracker) return NULL;
+	return &tracker->allocator;
+}
+
+const char* BC_AllocatorTrackerName(const BC_AllocatorTrackerRef tracker) {
+	if (!tracker) return NULL;
+	return tracker->name;
+}
+
+void BC_AllocatorTrackerGetStats(const BC_AllocatorTrackerRef tracker, BC_AllocatorTrackerStats* stats) {
+	if (!tracker || !stats) return;
+
+	// Counters are read one by one, a snapshot taken under load can be off by in flight calls
+	stats->allocationCount = BC_atomic_load(&tracker->allocationCount);
+	stats->freeCount = BC_atomic_load(&tracker->freeCount);
+	stats->totalAllocated = BC_atomic_load(&tracker->totalAllocated);
+	stats->currentUsage = BC_atomic_load(&tracker->currentUsage);
+	stats->peakUsage = BC_atomic_load(&tracker->peakUsage);
+	for (size_t i = 0; i < BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS; i++) {
+		stats->histogram[i] = BC_atomic_load(&tracker->histogram[i]);
+	}
+}
+
+void BC_AllocatorTrackerReset(const BC_AllocatorTrackerRef tracker) {
+	if (!tracker) return;
+
+	// Live blocks are still freed later, so current usage is kept
+	BC_atomic_store(&tracker->allocationCount, 0);
+	BC_atomic_store(&tracker->freeCount, 0);
+	BC_atomic_store(&tracker->totalAllocated, 0);
+	BC_atomic_store(&tracker->peakUsage, BC_atomic_load(&tracker->currentUsage));
+	for (size_t i = 0; i < BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS; i++) {
+		BC_atomic_store(&tracker->histogram[i], 0);
+	}
+}
+
+// =========================================================
+// MARK: Print
+// =========================================================
+
+void BC_AllocatorTrackerPrint(const BC_AllocatorTrackerRef tracker) {
+	if (!tracker) return;
+
+	BC_AllocatorTrackerStats stats;
+	BC_AllocatorTrackerGetStats(tracker, &stats);
+
+	char current[32], peak[32], total[32];
+	INTERNAL_BC_MemoryFormatBytes(stats.currentUsage, current, sizeof(current));
+	INTERNAL_BC_MemoryFormatBytes(stats.peakUsage, peak, sizeof(peak));
+	INTERNAL_BC_MemoryFormatBytes(stats.totalAllocated, total, sizeof(total));
+
+	printf("%s: %s live, %s peak, %s total, %zu allocations, %zu frees\n",
+		tracker->name, current, peak, total, stats.allocationCount, stats.freeCount);
+
+	for (size_t i = 0; i < BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS; i++) {
+		if (stats.histogram[i] == 0) continue;
+
+		// The last bucket is labelled by the limit of the one before it
+		const BC_bool isLast = i + 1 == BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS;
+		char limit[32];
+		INTERNAL_BC_MemoryFormatBytes((size_t)16 << (isLast ? i - 1 : i), limit, sizeof(limit));
+		printf("    %-2s %-10s %zu\n", isLast ? ">" : "<=", limit, stats.histogram[i]);
+	}
+}
+
+void BC_AllocatorTrackerPrintAll(void) {
+	BC_RunOnce(&gTrackersOnce, PRIV_TrackerSetup);
+	BC_MutexLock(&gTrackersMutex);
+	for (BC_AllocatorTracker* tracker = gTrackers; tracker; tracker = tracker->next) {
+		BC_AllocatorTrackerPrint(tracker);
+	}
+	BC_MutexUnlock(&gTrackersMutex);
+}
@@ -0,0 +1,49 @@
+#ifndef BCORE_ALLOCATOR_TRACKER_H
+#define BCORE_ALLOCATOR_TRACKER_H
+
+#include "BC_Allocator.h"
+
+#include <stddef.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Bucket i counts allocations up to 16 << i bytes, the last one everything larger
+#define BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS 16
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef struct BC_AllocatorTrackerStats {
+	size_t allocationCount;
+	size_t freeCount;
+	size_t totalAllocated;
+	size_t currentUsage;
+	size_t peakUsage;
+	size_t histogram[BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS];
+} BC_AllocatorTrackerStats;
+
+// =========================================================
+// MARK: Tracker
+// =========================================================
+
+// Allocator that forwards to `wrapped` and counts what goes through it, with atomic counters
+// only. Every block gets a 16 bytes header holding its size. Trackers are listed under `name`
+// by BC_AllocatorTrackerPrintAll, so subsystems can be told apart.
+BC_AllocatorTrackerRef BC_AllocatorTrackerCreate(const char* name, BC_AllocatorRef wrapped);
+void BC_AllocatorTrackerDestroy(BC_AllocatorTrackerRef tracker);
+
+BC_AllocatorRef BC_AllocatorTrackerAllocator(BC_AllocatorTrackerRef tracker);
+const char* BC_AllocatorTrackerName(BC_AllocatorTrackerRef tracker);
+
+void BC_AllocatorTrackerGetStats(BC_AllocatorTrackerRef tracker, BC_AllocatorTrackerStats* stats);
+
+// Clears counters and the histogram, the peak restarts from the current usage
+void BC_AllocatorTrackerReset(BC_AllocatorTrackerRef tracker);
+
+void BC_AllocatorTrackerPrint(BC_AllocatorTrackerRef tracker);
+void BC_AllocatorTrackerPrintAll(void);
+
+#endif //BCORE_ALLOCATOR_TRACKER_H
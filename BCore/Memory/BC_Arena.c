@@ -1,51 +1,213 @@
 #include "BC_Arena.h"
 
 #include "BC_Allocator.h"
+#include "BC_VirtualMemory.h"
 #include "../BC_Types.h"
+#include "../Thread/BC_Atomics.h"
 
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 // =========================================================
 // MARK: Arena Structure
 // =========================================================
 
-typedef struct BC_Arena {
-	void* buffer;
+typedef struct PRIV_ArenaChunk {
+	struct PRIV_ArenaChunk* prev;  // Previous chunk in the active chain, next one in the spare list
+	char* base;
 	size_t size;
-	size_t offset;
-	BC_AllocatorRef allocatorRef;  // Allocator for fallback and for freeing
+} PRIV_ArenaChunk;
+
+typedef struct BC_Arena {
+	PRIV_ArenaChunk* chunk;        // Chunk currently bump allocating
+	PRIV_ArenaChunk* spare;        // Chunks kept by reset for reuse
+	size_t offset;                 // Offset inside the current chunk
+	size_t usedBefore;             // Bytes consumed in the chunks before the current one
+	size_t capacity;               // Bytes held by every chunk, spare ones included
+	size_t spareSize;              // Bytes held by spare chunks
+	size_t retainLimit;            // Maximum bytes of spare chunks kept by reset, committed bytes for virtual arenas
+	size_t committed;              // Committed bytes at the start of the reserved range, virtual arenas only
+	size_t commitStep;             // Commit and decommit granularity, virtual arenas only
+	BC_AllocatorRef allocatorRef;  // Allocator for chunks and for freeing
 	BC_Allocator allocator;        // The allocator interface for this arena
-	BC_bool ownsBuffer;           //
+	BC_bool ownsBuffer;            //
+	BC_bool isVirtual;             // First chunk is a reserved range committed on demand, never chained
+	PRIV_ArenaChunk first;         // Initial buffer, only released by destroy
 } BC_Arena;
 
+// Sum of every live arena capacity, read by monitoring threads
+static BC_atomic_size gArenaTotalCapacity = 0;
+
+// Keeps the process wide total in step, the unsigned difference wraps around when shrinking
+static inline void PRIV_ArenaSetCapacity(const BC_ArenaRef arena, const size_t capacity) {
+	BC_atomic_fetch_add(&gArenaTotalCapacity, capacity - arena->capacity);
+	arena->capacity = capacity;
+}
+
+// =========================================================
+// MARK: Chunks
+// =========================================================
+
+static void PRIV_ArenaFreeChunk(const BC_ArenaRef arena, PRIV_ArenaChunk* chunk) {
+	PRIV_ArenaSetCapacity(arena, arena->capacity - chunk->size);
+	BC_AllocatorFree(arena->allocatorRef, chunk);
+}
+
+static void PRIV_ArenaRecycleChunk(const BC_ArenaRef arena, PRIV_ArenaChunk* chunk) {
+	if (arena->spareSize + chunk->size > arena->retainLimit) {
+		PRIV_ArenaFreeChunk(arena, chunk);
+		return;
+	}
+	chunk->prev = arena->spare;
+	arena->spare = chunk;
+	arena->spareSize += chunk->size;
+}
+
+static PRIV_ArenaChunk* PRIV_ArenaTakeSpareChunk(const BC_ArenaRef arena, const size_t minSize) {
+	PRIV_ArenaChunk** link = &arena->spare;
+	while (*link) {
+		PRIV_ArenaChunk* chunk = *link;
+		if (chunk->size >= minSize) {
+			*link = chunk->prev;
+			arena->spareSize -= chunk->size;
+			return chunk;
+		}
+		link = &chunk->prev;
+	}
+	return NULL;
+}
+
+static BC_bool PRIV_ArenaGrow(const BC_ArenaRef arena, const size_t minSize) {
+	// The reserved range is all a virtual arena gets, pointers never leave it
+	if (arena->isVirtual) return BC_false;
+
+	PRIV_ArenaChunk* chunk = PRIV_ArenaTakeSpareChunk(arena, minSize);
+
+	if (!chunk) {
+		// Geometric growth, each chunk doubles the previous one
+		size_t size = arena->chunk->size < BC_ARENA_MAX_CHUNK_SIZE / 2 ? arena->chunk->size * 2 : BC_ARENA_MAX_CHUNK_SIZE;
+		if (size < minSize) size = minSize;
+
+		chunk = BC_AllocatorAlloc(arena->allocatorRef, sizeof(PRIV_ArenaChunk) + size);
+		if (!chunk) return BC_false;
+
+		chunk->base = (char*)(chunk + 1);
+		chunk->size = size;
+		PRIV_ArenaSetCapacity(arena, arena->capacity + size);
+	}
+
+	arena->usedBefore += arena->offset;
+	chunk->prev = arena->chunk;
+	arena->chunk = chunk;
+	arena->offset = 0;
+
+	return BC_true;
+}
+
+// Pop every chunk allocated after `stop`, making `stop` the current chunk again
+static void PRIV_ArenaUnwindTo(const BC_ArenaRef arena, PRIV_ArenaChunk* stop) {
+	PRIV_ArenaChunk* chunk = arena->chunk;
+	while (chunk != stop) {
+		PRIV_ArenaChunk* prev = chunk->prev;
+		PRIV_ArenaRecycleChunk(arena, chunk);
+		chunk = prev;
+	}
+	arena->chunk = stop;
+}
+
+// =========================================================
+// MARK: Virtual Range
+// =========================================================
+
+static inline size_t PRIV_ArenaCommitRound(const size_t size, const size_t step) {
+	return (size + step - 1) & ~(step - 1);
+}
+
+// Commits the reserved range up to `end`, in steps of commitStep
+static BC_bool PRIV_ArenaCommit(const BC_ArenaRef arena, const size_t end) {
+	size_t target = PRIV_ArenaCommitRound(end, arena->commitStep);
+	if (target > arena->first.size) target = arena->first.size;
+
+	if (!BC_VirtualCommit(arena->first.base + arena->committed, target - arena->committed)) {
+		fprintf(stderr, "BC_Arena: Failed to commit %zu bytes\n", target - arena->committed);
+		return BC_false;
+	}
+	arena->committed = target;
+	PRIV_ArenaSetCapacity(arena, target);
+	return BC_true;
+}
+
+// Returns committed pages past `keep` to the OS
+static void PRIV_ArenaDecommit(const BC_ArenaRef arena, const size_t keep) {
+	const size_t target = PRIV_ArenaCommitRound(keep, arena->commitStep);
+	if (target >= arena->committed) return;
+
+	BC_VirtualDecommit(arena->first.base + target, arena->committed - target);
+	arena->committed = target;
+	PRIV_ArenaSetCapacity(arena, target);
+}
+
 // =========================================================
 // MARK: Arena Allocator Implementation
 // =========================================================
 
-static void* IMPL_ArenaAlloc(const size_t size, const void* ctx) {
+static inline size_t PRIV_ArenaAlignedOffset(const BC_ArenaRef arena, const size_t alignment) {
+	// Align the address, not the offset, chunk bases are only 8 bytes aligned
+	const uintptr_t cursor = (uintptr_t)arena->chunk->base + arena->offset;
+	const uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	return arena->offset + (aligned - cursor);
+}
+
+static void* IMPL_ArenaAllocAligned(const size_t size, const size_t alignment, const void* ctx) {
 	const BC_ArenaRef arena = (BC_ArenaRef)ctx;
 
-	// Align to 8 bytes
-	const size_t alignment = 8;
-	const size_t alignedOffset = (arena->offset + alignment - 1) & ~(alignment - 1);
-
-	// Check if we have enough space
-	if (alignedOffset + size > arena->size) {
-		// Try to allocate from allocator if available
-		if (arena->allocatorRef) {
-			return BC_AllocatorAlloc(arena->allocatorRef, size);
+	size_t alignedOffset = PRIV_ArenaAlignedOffset(arena, alignment);
+
+	// Check if we have enough space, chain a new chunk otherwise
+	if (alignedOffset + size > arena->chunk->size) {
+		if (!PRIV_ArenaGrow(arena, size + alignment)) {
+			fprintf(stderr, "BC_Arena: Out of memory (requested %zu bytes, failed to grow arena)\n", size);
+			return NULL;
 		}
-		fprintf(stderr, "BC_Arena: Out of memory (requested %zu bytes, available %zu bytes)\n",
-			size, arena->size - alignedOffset);
+		alignedOffset = PRIV_ArenaAlignedOffset(arena, alignment);
+	}
+
+	if (arena->isVirtual && alignedOffset + size > arena->committed && !PRIV_ArenaCommit(arena, alignedOffset + size)) {
 		return NULL;
 	}
 
-	void* ptr = (char*)arena->buffer + alignedOffset;
+	void* ptr = arena->chunk->base + alignedOffset;
 	arena->offset = alignedOffset + size;
 
 	return ptr;
 }
 
+static void* IMPL_ArenaAlloc(const size_t size, const void* ctx) {
+	// Align to 8 bytes
+	return IMPL_ArenaAllocAligned(size, 8, ctx);
+}
+
+static void* IMPL_ArenaRealloc(void* ptr, const size_t oldSize, const size_t newSize, const void* ctx) {
+	const BC_ArenaRef arena = (BC_ArenaRef)ctx;
+	char* block = ptr;
+
+	// The most recent allocation can grow or shrink in place while it fits its chunk
+	if (block + oldSize == arena->chunk->base + arena->offset
+		&& newSize <= arena->chunk->size - (size_t)(block - arena->chunk->base)) {
+		const size_t end = (size_t)(block - arena->chunk->base) + newSize;
+		if (arena->isVirtual && end > arena->committed && !PRIV_ArenaCommit(arena, end)) return NULL;
+		arena->offset = (size_t)(block - arena->chunk->base) + newSize;
+		return ptr;
+	}
+
+	if (newSize <= oldSize) return ptr;
+
+	void* newPtr = IMPL_ArenaAlloc(newSize, ctx);
+	if (newPtr) memcpy(newPtr, ptr, oldSize);
+	return newPtr;
+}
+
 static void IMPL_ArenaFree(void* ptr, const void* ctx) {
 	// Arena allocations are freed all at once when the arena is reset or destroyed
 	// Individual frees are no-ops
@@ -92,25 +254,88 @@ BC_ArenaRef BC_ArenaCreateWithBuffer(BC_AllocatorRef allocator, void* buffer, co
 		arena->ownsBuffer = BC_false;
 	}
 
-	arena->buffer = buffer;
-	arena->size = size;
+	arena->first.prev = NULL;
+	arena->first.base = buffer;
+	arena->first.size = size;
+	arena->chunk = &arena->first;
+	arena->spare = NULL;
 	arena->offset = 0;
+	arena->usedBefore = 0;
+	arena->capacity = 0;
+	PRIV_ArenaSetCapacity(arena, size);
+	arena->spareSize = 0;
+	arena->retainLimit = BC_ARENA_DEFAULT_RETAIN_LIMIT;
+	arena->committed = 0;
+	arena->commitStep = 0;
+	arena->isVirtual = BC_false;
 	arena->allocatorRef = allocator;
 	arena->allocator.alloc = IMPL_ArenaAlloc;
 	arena->allocator.free = IMPL_ArenaFree;
 	arena->allocator.context = arena;
+	arena->allocator.allocAligned = IMPL_ArenaAllocAligned;
+	arena->allocator.realloc = IMPL_ArenaRealloc;
+	arena->allocator.freeSized = NULL;
 
 	return arena;
 }
 
+BC_ArenaRef BC_ArenaCreateVirtual(const size_t reserveSize, const BC_ArenaFlags flags) {
+	if (reserveSize == 0) {
+		fprintf(stderr, "BC_ArenaCreateVirtual: Invalid size (must be > 0)\n");
+		return NULL;
+	}
+
+	// Huge pages are committed and decommitted whole so reset never splits one
+	const BC_bool hugePages = (flags & BC_ArenaFlagHugePages) != 0;
+	const size_t step = hugePages ? BC_VIRTUAL_HUGE_PAGE_SIZE : BC_ARENA_VIRTUAL_COMMIT_SIZE;
+
+	const size_t size = PRIV_ArenaCommitRound(reserveSize, step);
+	void* range = hugePages ? BC_VirtualReserveAligned(size, BC_VIRTUAL_HUGE_PAGE_SIZE) : BC_VirtualReserve(size);
+	if (!range) return NULL;
+	if (hugePages) BC_VirtualAdviseHugePages(range, size);
+
+	const BC_ArenaRef arena = BC_ArenaCreateWithBuffer(kBC_AllocatorRefSystem, range, size);
+	if (!arena) {
+		BC_VirtualRelease(range, size);
+		return NULL;
+	}
+
+	// Nothing is committed until the first allocation
+	arena->isVirtual = BC_true;
+	arena->commitStep = step;
+	PRIV_ArenaSetCapacity(arena, 0);
+	return arena;
+}
+
 void BC_ArenaDestroy(const BC_ArenaRef arena) {
 	if (!arena) return;
 
 	const BC_AllocatorRef allocator = arena->allocatorRef ? arena->allocatorRef : kBC_AllocatorRefSystem;
+	PRIV_ArenaSetCapacity(arena, 0);
+
+	if (arena->isVirtual) {
+		BC_VirtualRelease(arena->first.base, arena->first.size);
+		BC_AllocatorFree(allocator, arena);
+		return;
+	}
+
+	// Free every chained chunk, active and spare
+	PRIV_ArenaChunk* chunk = arena->chunk;
+	while (chunk != &arena->first) {
+		PRIV_ArenaChunk* prev = chunk->prev;
+		BC_AllocatorFree(allocator, chunk);
+		chunk = prev;
+	}
+	chunk = arena->spare;
+	while (chunk) {
+		PRIV_ArenaChunk* next = chunk->prev;
+		BC_AllocatorFree(allocator, chunk);
+		chunk = next;
+	}
 
 	// Free the buffer if we allocated it
-	if (arena->ownsBuffer && arena->buffer) {
-		BC_AllocatorFree(allocator, arena->buffer);
+	if (arena->ownsBuffer && arena->first.base) {
+		BC_AllocatorFree(allocator, arena->first.base);
 	}
 
 	// Free the arena structure itself
@@ -124,15 +349,57 @@ BC_AllocatorRef BC_ArenaAllocator(const BC_ArenaRef arena) {
 
 void BC_ArenaReset(const BC_ArenaRef arena) {
 	if (!arena) return;
+	PRIV_ArenaUnwindTo(arena, &arena->first);
 	arena->offset = 0;
+	arena->usedBefore = 0;
+
+	// Pages touched by a spike above the retain limit go back to the OS
+	if (arena->isVirtual) PRIV_ArenaDecommit(arena, arena->retainLimit);
+}
+
+void BC_ArenaSetRetainLimit(const BC_ArenaRef arena, const size_t retainLimit) {
+	if (!arena) return;
+	arena->retainLimit = retainLimit;
+
+	if (arena->isVirtual) {
+		PRIV_ArenaDecommit(arena, arena->offset > retainLimit ? arena->offset : retainLimit);
+		return;
+	}
+
+	// Drop spare chunks that no longer fit
+	while (arena->spare && arena->spareSize > retainLimit) {
+		PRIV_ArenaChunk* chunk = arena->spare;
+		arena->spare = chunk->prev;
+		arena->spareSize -= chunk->size;
+		PRIV_ArenaFreeChunk(arena, chunk);
+	}
+}
+
+BC_ArenaSavepoint BC_ArenaMark(const BC_ArenaRef arena) {
+	if (!arena) return (BC_ArenaSavepoint){NULL, NULL, 0, 0};
+	return (BC_ArenaSavepoint){arena, arena->chunk, arena->offset, arena->usedBefore};
+}
+
+void BC_ArenaRewind(const BC_ArenaSavepoint savepoint) {
+	const BC_ArenaRef arena = savepoint.arena;
+	if (!arena) return;
+
+	// Chunks chained after the savepoint go back to the spare list
+	PRIV_ArenaUnwindTo(arena, savepoint.chunk);
+	arena->offset = savepoint.offset;
+	arena->usedBefore = savepoint.usedBefore;
 }
 
 size_t BC_ArenaCapacity(const BC_ArenaRef arena) {
 	if (!arena) return 0;
-	return arena->size;
+	return arena->capacity;
+}
+
+size_t BC_ArenaTotalCapacity(void) {
+	return BC_atomic_load(&gArenaTotalCapacity);
 }
 
 size_t BC_ArenaUsed(const BC_ArenaRef arena) {
 	if (!arena) return 0;
-	return arena->offset;
+	return arena->usedBefore + arena->offset;
 }
@@ -2,15 +2,75 @@
 #define BCORE_ARENA_H
 
 #include "BC_Allocator.h"
+#include "../BC_Macro.h"
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Bytes of chained chunks kept by BC_ArenaReset for reuse, the rest goes back to the allocator
+#define BC_ARENA_DEFAULT_RETAIN_LIMIT BC_MB(4)
+
+// Upper bound for the geometric growth of chained chunks
+#define BC_ARENA_MAX_CHUNK_SIZE BC_MB(64)
+
+// Step in which virtual arenas commit and decommit their reserved range, a multiple of the page size
+#define BC_ARENA_VIRTUAL_COMMIT_SIZE BC_KB(64)
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef enum {
+	BC_ArenaFlagNone = 0,
+	BC_ArenaFlagHugePages = 1 << 0,  // 2MB aligned range with transparent huge pages advised, committed in 2MB steps
+} BC_ArenaFlags;
+
+// Position in an arena, allocations made after it are released by BC_ArenaRewind.
+// A savepoint is invalidated by BC_ArenaReset and by rewinding to an older savepoint.
+typedef struct BC_ArenaSavepoint {
+	BC_ArenaRef arena;
+	void* chunk;
+	size_t offset;
+	size_t usedBefore;
+} BC_ArenaSavepoint;
+
+// =========================================================
+// MARK: Arena
+// =========================================================
 
 BC_ArenaRef BC_ArenaCreate(BC_AllocatorRef allocator, size_t size);
 BC_ArenaRef BC_ArenaCreateWithBuffer(BC_AllocatorRef allocator, void* buffer, size_t size);
 void BC_ArenaDestroy(BC_ArenaRef arena);
 
+// Reserves `reserveSize` bytes of address space and commits it as the arena grows. Allocations are
+// contiguous and never move to another chunk, running past the reserved range fails instead.
+// BC_ArenaReset decommits pages above the retain limit, capacity reports committed bytes.
+// Chained arenas get huge pages by passing kBC_AllocatorRefHugePages to BC_ArenaCreate instead.
+BC_ArenaRef BC_ArenaCreateVirtual(size_t reserveSize, BC_ArenaFlags flags);
+
 BC_AllocatorRef BC_ArenaAllocator(BC_ArenaRef arena);
 void BC_ArenaReset(BC_ArenaRef arena);
+void BC_ArenaSetRetainLimit(BC_ArenaRef arena, size_t retainLimit);
 
 size_t BC_ArenaCapacity(BC_ArenaRef arena);
 size_t BC_ArenaUsed(BC_ArenaRef arena);
 
+// Capacity summed over every live arena, safe to read from any thread
+size_t BC_ArenaTotalCapacity(void);
+
+// =========================================================
+// MARK: Savepoints
+// =========================================================
+
+BC_ArenaSavepoint BC_ArenaMark(BC_ArenaRef arena);
+void BC_ArenaRewind(BC_ArenaSavepoint savepoint);
+
+#define INTERNAL_BC_ArenaScopeImpl(__arena__, __name__) for ( \
+    BC_ArenaSavepoint __name__ = BC_ArenaMark(__arena__), *BC_M_CAT(__name__, _once) = &__name__; \
+    BC_M_CAT(__name__, _once); \
+    BC_M_CAT(__name__, _once) = NULL, BC_ArenaRewind(__name__) \
+)
+#define BC_ArenaScope(arena) INTERNAL_BC_ArenaScopeImpl(arena, BC_M_CAT(___temp_arena_scope_, __COUNTER__))
+
 #endif //BCORE_ARENA_H
@@ -2,30 +2,196 @@
 
 #include "../Thread/BC_Threads.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1
 
+#include "BC_Allocator.h"
+#include "BC_MemoryProfile.h"
+#include "../BC_Keywords.h"
+#include "../BC_Macro.h"
+#include "../Thread/BC_Atomics.h"
+
+// =========================================================
+// MARK: Sharded Stats
+// =========================================================
+
+// Net bytes a thread allocates or frees before publishing them for the peak, bounds the peak error per thread
+#define PRIV_MEMORY_PEAK_FLUSH_THRESHOLD BC_KB(64)
+
+// Each thread only writes to its own shard with relaxed stores, BC_MemoryInfoGet sums every shard.
+// Usage is kept modulo 2^64, a shard can free more than it allocated but the sum stays exact.
+typedef struct PRIV_MemoryShard {
+    BC_atomic_size totalAllocated;
+    BC_atomic_size currentUsage;
+    BC_atomic_size allocationCount;
+    BC_atomic_size freeCount;
+    size_t unflushed;                  // Net bytes not yet added to gMemoryFlushedUsage, owner thread only
+    BC_bool inUse;                     // Guarded by gMemoryMutex
+    struct PRIV_MemoryShard* next;
+} PRIV_MemoryShard;
+
 typedef struct {
     size_t totalAllocated;
     size_t currentUsage;
-    size_t peakUsage;
     size_t allocationCount;
     size_t freeCount;
 } MemoryStats;
 
-static MemoryStats gMemoryStats = {0};
+static PRIV_MemoryShard* gMemoryShards = NULL;
+static BC_atomic_size gMemoryFlushedUsage = 0;  // Sum of flushed usage, lags behind by the unflushed bytes
+static BC_atomic_size gMemoryPeakUsage = 0;
+static MemoryStats gMemoryBaseline = {0};       // Sums at the last BC_MemoryInfoHeapReset
 BC_MUTEX_MAYBE(gMemoryMutex)
 
+static BC_TLS PRIV_MemoryShard* gMemoryShard = NULL;
+
 typedef struct {
     size_t size;
-    void* data;
+    void* base; // Pointer returned by malloc, differs from the block for aligned allocations
+#if BC_SETTINGS_DEBUG_ALLOCATION_PROFILE == 1
+    INTERNAL_BC_MemorySiteRef site;
+    size_t reserved; // Keeps the header a multiple of 16 bytes
+#endif
 } BC_MemoryBlock;
 
+#if BC_SETTINGS_DEBUG_ALLOCATION_PROFILE == 1
+#define PRIV_MemoryProfileAlloc(_block_) ((_block_)->site = INTERNAL_BC_MemoryProfileAlloc((_block_)->size))
+#define PRIV_MemoryProfileFree(_block_) INTERNAL_BC_MemoryProfileFree((_block_)->site, (_block_)->size)
+#else
+#define PRIV_MemoryProfileAlloc(_block_)
+#define PRIV_MemoryProfileFree(_block_)
+#endif
+
+static void PRIV_MemoryPeakUpdate(const size_t usage) {
+    size_t peak = BC_atomic_load_relaxed(&gMemoryPeakUsage);
+    while (usage > peak && !BC_atomic_compare_exchange(&gMemoryPeakUsage, &peak, usage)) {}
+}
+
+static void PRIV_MemoryShardFlush(PRIV_MemoryShard* shard) {
+    if (shard->unflushed == 0) return;
+    const size_t usage = BC_atomic_fetch_add(&gMemoryFlushedUsage, shard->unflushed) + shard->unflushed;
+    shard->unflushed = 0;
+    PRIV_MemoryPeakUpdate(usage);
+}
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+#if defined(_WIN32)
+static DWORD gMemoryShardKey;
+#define PRIV_MemoryShardKeySet(_shard_) FlsSetValue(gMemoryShardKey, _shard_)
+#else
+static pthread_key_t gMemoryShardKey;
+#define PRIV_MemoryShardKeySet(_shard_) pthread_setspecific(gMemoryShardKey, _shard_)
+#endif
+
+// Called on thread exit, the shard keeps its counts and is handed to the next new thread
+static void
+#if defined(_WIN32)
+WINAPI
+#endif
+PRIV_MemoryShardRetire(void* ptr) {
+    PRIV_MemoryShard* shard = ptr;
+    if (!shard) return;
+    PRIV_MemoryShardFlush(shard);
+    gMemoryShard = NULL;
+    BC_MutexLock(&gMemoryMutex);
+    shard->inUse = BC_false;
+    BC_MutexUnlock(&gMemoryMutex);
+}
+
+BC_ONCE_MAYBE_STATIC(gMemoryOnce)
+
+static void PRIV_MemorySetup(void) {
+    BC_MutexInit(&gMemoryMutex);
+#if defined(_WIN32)
+    gMemoryShardKey = FlsAlloc(PRIV_MemoryShardRetire);
+#else
+    pthread_key_create(&gMemoryShardKey, PRIV_MemoryShardRetire);
+#endif
+}
+
+#else
+
+#define PRIV_MemoryShardKeySet(_shard_)
+static void PRIV_MemorySetup(void) {}
+
+#endif
+
+// Slow path, runs once per thread
+static PRIV_MemoryShard* PRIV_MemoryShardAcquire(void) {
+    BC_RunOnce(&gMemoryOnce, PRIV_MemorySetup);
+
+    BC_MutexLock(&gMemoryMutex);
+    PRIV_MemoryShard* shard = gMemoryShards;
+    while (shard && shard->inUse) shard = shard->next;
+
+    if (!shard) {
+        // Untracked and never released, padded to a cache line so threads do not share one
+        char* raw = calloc(1, sizeof(PRIV_MemoryShard) + 2 * BC_CACHE_LINE_SIZE);
+        if (!raw) {
+            BC_MutexUnlock(&gMemoryMutex);
+            fprintf(stderr, "BC_Memory: Failed to allocate tracking shard\n");
+            abort();
+        }
+        shard = (PRIV_MemoryShard*)(((uintptr_t)raw + BC_CACHE_LINE_SIZE - 1) & ~(uintptr_t)(BC_CACHE_LINE_SIZE - 1));
+        shard->next = gMemoryShards;
+        gMemoryShards = shard;
+    }
+    shard->inUse = BC_true;
+    BC_MutexUnlock(&gMemoryMutex);
+
+    PRIV_MemoryShardKeySet(shard);
+    gMemoryShard = shard;
+    return shard;
+}
+
+static inline PRIV_MemoryShard* PRIV_MemoryShardGet(void) {
+    PRIV_MemoryShard* shard = gMemoryShard;
+    return shard ? shard : PRIV_MemoryShardAcquire();
+}
+
+// Only the owner thread writes a shard, so load + relaxed store is enough and avoids locked instructions
+#define PRIV_MemoryShardAdd(_field_, _value_) \
+    BC_atomic_store_relaxed(&(_field_), BC_atomic_load_relaxed(&(_field_)) + (_value_))
+
+static inline void PRIV_MemoryShardUsage(PRIV_MemoryShard* shard, const size_t delta) {
+    PRIV_MemoryShardAdd(shard->currentUsage, delta);
+    shard->unflushed += delta;
+    const intptr_t unflushed = (intptr_t)shard->unflushed;
+    if (unflushed > PRIV_MEMORY_PEAK_FLUSH_THRESHOLD || unflushed < -PRIV_MEMORY_PEAK_FLUSH_THRESHOLD) {
+        PRIV_MemoryShardFlush(shard);
+    }
+}
+
+static void PRIV_MemoryStatsSum(MemoryStats* stats) {
+    *stats = (MemoryStats){0};
+    BC_MutexLock(&gMemoryMutex);
+    for (const PRIV_MemoryShard* shard = gMemoryShards; shard; shard = shard->next) {
+        stats->totalAllocated += BC_atomic_load_relaxed(&shard->totalAllocated);
+        stats->currentUsage += BC_atomic_load_relaxed(&shard->currentUsage);
+        stats->allocationCount += BC_atomic_load_relaxed(&shard->allocationCount);
+        stats->freeCount += BC_atomic_load_relaxed(&shard->freeCount);
+    }
+    BC_MutexUnlock(&gMemoryMutex);
+}
+
+// =========================================================
+// MARK: Tracked Allocation
+// =========================================================
+
 void INTERNAL_BC_MemoryInitialize() {
-	BC_MutexInit(&gMemoryMutex);
+    BC_RunOnce(&gMemoryOnce, PRIV_MemorySetup);
+}
+
+static void PRIV_MemoryTrackAlloc(const size_t size) {
+    PRIV_MemoryShard* shard = PRIV_MemoryShardGet();
+    PRIV_MemoryShardAdd(shard->totalAllocated, size);
+    PRIV_MemoryShardAdd(shard->allocationCount, 1);
+    PRIV_MemoryShardUsage(shard, size);
 }
 
 void* BC_Malloc(const size_t size) {
@@ -35,19 +201,32 @@ void* BC_Malloc(const size_t size) {
     if (!block) return NULL;
 
     block->size = size;
-    block->data = (char*)block + sizeof(BC_MemoryBlock);
+    block->base = block;
 
-    BC_MutexLock(&gMemoryMutex);
-    gMemoryStats.totalAllocated += size;
-    gMemoryStats.currentUsage += size;
-    gMemoryStats.allocationCount++;
+    PRIV_MemoryTrackAlloc(size);
+    PRIV_MemoryProfileAlloc(block);
+    INTERNAL_BC_MemorySamplerAccount(size);
 
-    if (gMemoryStats.currentUsage > gMemoryStats.peakUsage) {
-        gMemoryStats.peakUsage = gMemoryStats.currentUsage;
-    }
-    BC_MutexUnlock(&gMemoryMutex);
+    return block + 1;
+}
 
-    return block->data;
+void* BC_MallocAligned(const size_t size, const size_t alignment) {
+    if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0) return NULL;
+
+    // Over-allocate so the data can be aligned with the header right before it
+    char* base = malloc(sizeof(BC_MemoryBlock) + size + alignment - 1);
+    if (!base) return NULL;
+
+    const uintptr_t data = ((uintptr_t)base + sizeof(BC_MemoryBlock) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    BC_MemoryBlock* block = (BC_MemoryBlock*)data - 1;
+    block->size = size;
+    block->base = base;
+
+    PRIV_MemoryTrackAlloc(size);
+    PRIV_MemoryProfileAlloc(block);
+    INTERNAL_BC_MemorySamplerAccount(size);
+
+    return (void*)data;
 }
 
 void* BC_Calloc(const size_t count, const size_t size) {
@@ -71,22 +250,30 @@ void* BC_Realloc(void* ptr, const size_t newSize) {
     BC_MemoryBlock* oldBlock = (BC_MemoryBlock*)((char*)ptr - sizeof(BC_MemoryBlock));
     const size_t oldSize = oldBlock->size;
 
+    // Aligned blocks do not start at their malloc pointer, move them like realloc would
+    if (oldBlock->base != oldBlock) {
+        void* newPtr = BC_Malloc(newSize);
+        if (!newPtr) return NULL;
+        memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+        BC_Free(ptr);
+        return newPtr;
+    }
+
     BC_MemoryBlock* newBlock = realloc(oldBlock, sizeof(BC_MemoryBlock) + newSize);
     if (!newBlock) return NULL;
 
+    // The resized block is attributed to the site that resized it
+    PRIV_MemoryProfileFree(newBlock);
     newBlock->size = newSize;
-    newBlock->data = (char*)newBlock + sizeof(BC_MemoryBlock);
-
-    BC_MutexLock(&gMemoryMutex);
-    gMemoryStats.currentUsage = gMemoryStats.currentUsage - oldSize + newSize;
-    gMemoryStats.totalAllocated += (newSize > oldSize) ? (newSize - oldSize) : 0;
+    newBlock->base = newBlock;
+    PRIV_MemoryProfileAlloc(newBlock);
+    INTERNAL_BC_MemorySamplerAccount(newSize);
 
-    if (gMemoryStats.currentUsage > gMemoryStats.peakUsage) {
-        gMemoryStats.peakUsage = gMemoryStats.currentUsage;
-    }
-    BC_MutexUnlock(&gMemoryMutex);
+    PRIV_MemoryShard* shard = PRIV_MemoryShardGet();
+    PRIV_MemoryShardAdd(shard->totalAllocated, (newSize > oldSize) ? (newSize - oldSize) : 0);
+    PRIV_MemoryShardUsage(shard, newSize - oldSize);
 
-    return newBlock->data;
+    return newBlock + 1;
 }
 
 void BC_Free(void* ptr) {
@@ -94,12 +281,22 @@ void BC_Free(void* ptr) {
 
     BC_MemoryBlock* block = (BC_MemoryBlock*)((char*)ptr - sizeof(BC_MemoryBlock));
 
-    BC_MutexLock(&gMemoryMutex);
-    gMemoryStats.currentUsage -= block->size;
-    gMemoryStats.freeCount++;
-    BC_MutexUnlock(&gMemoryMutex);
+    PRIV_MemoryShard* shard = PRIV_MemoryShardGet();
+    PRIV_MemoryShardAdd(shard->freeCount, 1);
+    PRIV_MemoryShardUsage(shard, -block->size);
+    PRIV_MemoryProfileFree(block);
+
+    free(block->base);
+}
+
+void BC_FreeSized(void* ptr, const size_t size) {
+    if (!ptr) return;
 
-    free(block);
+    const BC_MemoryBlock* block = (BC_MemoryBlock*)((char*)ptr - sizeof(BC_MemoryBlock));
+    if (block->size != size) {
+        fprintf(stderr, "BC_FreeSized: Size mismatch for %p (freed as %zu bytes, allocated %zu bytes)\n", ptr, size, block->size);
+    }
+    BC_Free(ptr);
 }
 
 char* BC_Strdup(const char* str) {
@@ -113,14 +310,23 @@ char* BC_Strdup(const char* str) {
 	return dup;
 }
 
+size_t BC_MemoryHeapUsage(void) {
+	MemoryStats stats;
+	PRIV_MemoryStatsSum(&stats);
+	BC_MutexLock(&gMemoryMutex);
+	const size_t baseline = gMemoryBaseline.currentUsage;
+	BC_MutexUnlock(&gMemoryMutex);
+	return stats.currentUsage - baseline;
+}
+
 void BC_MemoryInfoHeapReset(void) {
+	// Shards are never cleared, reset moves the baseline the sums are reported against
+	MemoryStats stats;
+	PRIV_MemoryStatsSum(&stats);
 	BC_MutexLock(&gMemoryMutex);
-	gMemoryStats.totalAllocated = 0;
-	gMemoryStats.currentUsage = 0;
-	gMemoryStats.peakUsage = 0;
-	gMemoryStats.allocationCount = 0;
-	gMemoryStats.freeCount = 0;
+	gMemoryBaseline = stats;
 	BC_MutexUnlock(&gMemoryMutex);
+	BC_atomic_store(&gMemoryPeakUsage, stats.currentUsage);
 }
 #else
 void INTERNAL_BC_MemoryInitialize() {}
@@ -137,22 +343,82 @@ void INTERNAL_BC_MemoryInitialize() {}
 #include <sys/resource.h>
 #endif
 
+#if defined(__linux__)
+// Resident and file backed resident bytes, from the page counts of /proc/self/statm
+static BC_bool PRIV_MemoryReadStatm(size_t* resident, size_t* shared) {
+	FILE* file = fopen("/proc/self/statm", "r");
+	if (!file) return BC_false;
+
+	unsigned long long sizePages = 0, residentPages = 0, sharedPages = 0;
+	const int fields = fscanf(file, "%llu %llu %llu", &sizePages, &residentPages, &sharedPages);
+	fclose(file);
+	if (fields != 3) return BC_false;
+
+	const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	*resident = residentPages * pageSize;
+	*shared = sharedPages * pageSize;
+	return BC_true;
+}
+
+// Pss and AnonHugePages need a walk of every mapping, only done by BC_MemoryInfoGet
+static void PRIV_MemoryReadSmapsRollup(BC_MemoryInfo* info) {
+	FILE* file = fopen("/proc/self/smaps_rollup", "r");
+	if (!file) return;
+
+	char line[256];
+	while (fgets(line, sizeof(line), file)) {
+		// Lines look like `Pss:   123 kB`
+		if (strncmp(line, "Pss:", 4) == 0) {
+			info->system_pss = strtoull(line + 4, NULL, 10) * 1024;
+		} else if (strncmp(line, "AnonHugePages:", 14) == 0) {
+			info->system_huge_pages = strtoull(line + 14, NULL, 10) * 1024;
+		}
+	}
+	fclose(file);
+}
+#endif
+
+size_t BC_MemoryCurrentRss(void) {
+#if defined(_WIN32) || defined(_WIN64)
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.WorkingSetSize;
+#elif defined(__APPLE__)
+	struct mach_task_basic_info minfo;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) & minfo, &count) == KERN_SUCCESS) return minfo.resident_size;
+#elif defined(__linux__)
+	size_t resident, shared;
+	if (PRIV_MemoryReadStatm(&resident, &shared)) return resident;
+#endif
+	return 0;
+}
+
 int BC_MemoryInfoGet(BC_MemoryInfo* info) {
 	if (!info) return -1;
 
 	info->system_current_rss = 0;
 	info->system_peak_rss = 0;
+	info->system_pss = 0;
+	info->system_rss_anonymous = 0;
+	info->system_rss_file = 0;
+	info->system_huge_pages = 0;
 
 #if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1
 
+	MemoryStats stats;
+	PRIV_MemoryStatsSum(&stats);
+	PRIV_MemoryPeakUpdate(stats.currentUsage);
+
 	BC_MutexLock(&gMemoryMutex);
-	info->freeCount = gMemoryStats.freeCount;
-	info->allocationCount = gMemoryStats.allocationCount;
-	info->totalAllocated = gMemoryStats.totalAllocated;
-	info->currentAllocUsage = gMemoryStats.currentUsage;
-	info->peakAllocUsage = gMemoryStats.peakUsage;
+	const MemoryStats baseline = gMemoryBaseline;
 	BC_MutexUnlock(&gMemoryMutex);
 
+	info->freeCount = stats.freeCount - baseline.freeCount;
+	info->allocationCount = stats.allocationCount - baseline.allocationCount;
+	info->totalAllocated = stats.totalAllocated - baseline.totalAllocated;
+	info->currentAllocUsage = stats.currentUsage - baseline.currentUsage;
+	info->peakAllocUsage = BC_atomic_load(&gMemoryPeakUsage) - baseline.currentUsage;
+
 #endif
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -160,6 +426,7 @@ int BC_MemoryInfoGet(BC_MemoryInfo* info) {
 	if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
 		info->system_current_rss = pmc.WorkingSetSize;
 		info->system_peak_rss = pmc.PeakWorkingSetSize;
+		info->system_pss = pmc.WorkingSetSize;
 		return 1;
 	}
 #elif defined(__APPLE__)
@@ -167,17 +434,24 @@ int BC_MemoryInfoGet(BC_MemoryInfo* info) {
 	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
 	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) & minfo, &count) == KERN_SUCCESS) {
 		info->system_current_rss = minfo.resident_size;
+		info->system_pss = minfo.resident_size;
 		struct rusage usage;
 		getrusage(RUSAGE_SELF, &usage);
 		info->system_peak_rss = usage.ru_maxrss;
 		return 1;
 	}
 #elif defined(__linux__)
-	struct rusage usage;
-	if (getrusage(RUSAGE_SELF, &usage) == 0) {
-		// Reported in KB
-		info->system_current_rss = usage.ru_maxrss * 1024;
-		info->system_peak_rss = usage.ru_maxrss * 1024;
+	size_t resident, shared;
+	if (PRIV_MemoryReadStatm(&resident, &shared)) {
+		info->system_current_rss = resident;
+		info->system_rss_anonymous = resident - shared;
+		info->system_rss_file = shared;
+		info->system_pss = resident;
+		PRIV_MemoryReadSmapsRollup(info);
+
+		// ru_maxrss is the peak, reported in KB
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0) info->system_peak_rss = usage.ru_maxrss * 1024;
 		return 1;
 	}
 #endif
@@ -194,7 +468,7 @@ int BC_MemoryInfoGet(BC_MemoryInfo* info) {
 #define RESET "\033[0m"
 #define BOLD "\033[1m"
 
-static void PRIV_FormatBytes(const size_t bytes, char *out, const size_t out_size)
+void INTERNAL_BC_MemoryFormatBytes(const size_t bytes, char *out, const size_t out_size)
 {
 	const char *units[] = { "B", "KB", "MB", "GB", "TB" };
 	double value = (double)bytes;
@@ -227,15 +501,23 @@ void BC_MemoryInfoPrint(void) {
 				(double) info.system_current_rss / (1024.0 * 1024.0));
 		printf("│"BLACK" System Peak RSS       │ %34.2f MB "RESET"│\n",
 				(double) info.system_peak_rss / (1024.0 * 1024.0));
+		printf("│"DGRAY" System PSS            │ %34.2f MB "RESET"│\n",
+				(double) info.system_pss / (1024.0 * 1024.0));
+		printf("│"BLACK" System RSS Anonymous  │ %34.2f MB "RESET"│\n",
+				(double) info.system_rss_anonymous / (1024.0 * 1024.0));
+		printf("│"DGRAY" System RSS File       │ %34.2f MB "RESET"│\n",
+				(double) info.system_rss_file / (1024.0 * 1024.0));
+		printf("│"BLACK" System Huge Pages     │ %34.2f MB "RESET"│\n",
+				(double) info.system_huge_pages / (1024.0 * 1024.0));
 #if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1
 		printf("├"DGRAY"───────────────────────┼───────────────────────────────────────"RESET"┤\n");
 	}
 
 	// Heap Statistics
 	char cur[37], peak[37], total[37];
-	PRIV_FormatBytes(info.currentAllocUsage, cur, sizeof(cur));
-	PRIV_FormatBytes(info.peakAllocUsage, peak, sizeof(peak));
-	PRIV_FormatBytes(info.totalAllocated, total, sizeof(total));
+	INTERNAL_BC_MemoryFormatBytes(info.currentAllocUsage, cur, sizeof(cur));
+	INTERNAL_BC_MemoryFormatBytes(info.peakAllocUsage, peak, sizeof(peak));
+	INTERNAL_BC_MemoryFormatBytes(info.totalAllocated, total, sizeof(total));
 	printf("│" DGRAY " Current Heap Usage    │ %37s " RESET "│\n", cur);
 	printf("│" BLACK " Peak Heap Usage       │ %37s " RESET "│\n", peak);
 	printf("│" DGRAY " Total Heap Allocated  │ %37s " RESET "│\n", total);
@@ -2,6 +2,7 @@
 #define BCORE_MEMORY_H
 
 #include "../BC_Settings.h"
+#include "BC_MemorySampler.h"
 
 #include <stdio.h>
 
@@ -16,7 +17,15 @@ void* BC_Calloc(size_t count, size_t size);
 __attribute__((alloc_size(2)))
 void* BC_Realloc(void* ptr, size_t newSize);
 
+// Alignment must be a power of two, memory is released with BC_Free or BC_FreeAligned
+__attribute__((malloc, alloc_size(1), alloc_align(2)))
+void* BC_MallocAligned(size_t size, size_t alignment);
+
 void BC_Free(void* ptr);
+#define BC_FreeAligned(_ptr_) BC_Free(_ptr_)
+
+// Same as BC_Free, reports blocks freed with another size than they were allocated with
+void BC_FreeSized(void* ptr, size_t size);
 
 char* BC_Strdup(const char* str);
 
@@ -24,21 +33,61 @@ char* BC_Strdup(const char* str);
 
 #include <stdlib.h>
 
+#if BC_SETTINGS_ALLOCATION_SAMPLING == 1
+
+static inline void* INTERNAL_BC_SampledMalloc(const size_t size) {
+	INTERNAL_BC_MemorySamplerAccount(size);
+	return malloc(size);
+}
+
+static inline void* INTERNAL_BC_SampledCalloc(const size_t count, const size_t size) {
+	INTERNAL_BC_MemorySamplerAccount(count * size);
+	return calloc(count, size);
+}
+
+static inline void* INTERNAL_BC_SampledRealloc(void* ptr, const size_t newSize) {
+	INTERNAL_BC_MemorySamplerAccount(newSize);
+	return realloc(ptr, newSize);
+}
+
+#define BC_Malloc(_size_) INTERNAL_BC_SampledMalloc(_size_)
+#define BC_Calloc(_count_, _size_) INTERNAL_BC_SampledCalloc(_count_, _size_)
+#define BC_Realloc(_ptr_, _newSize_) INTERNAL_BC_SampledRealloc(_ptr_, _newSize_)
+
+#else
+
 #define BC_Malloc(_size_) malloc(_size_)
 #define BC_Calloc(_count_, _size_) calloc(_count_, _size_)
 #define BC_Realloc(_ptr_, _newSize_) realloc(_ptr_, _newSize_)
+
+#endif
+
 #define BC_Free(_ptr_) free(_ptr_)
+#define BC_FreeSized(_ptr_, _size_) ((void)(_size_), free(_ptr_))
 #define BC_Strdup(_str_) strdup(_str_)
 
+#if defined(_WIN32)
+#include <malloc.h>
+#define BC_MallocAligned(_size_, _alignment_) (INTERNAL_BC_MemorySamplerAccount(_size_), _aligned_malloc(_size_, _alignment_))
+#define BC_FreeAligned(_ptr_) _aligned_free(_ptr_)
+#else
+#define BC_MallocAligned(_size_, _alignment_) (INTERNAL_BC_MemorySamplerAccount(_size_), aligned_alloc(_alignment_, ((_size_) + (_alignment_) - 1) & ~((_alignment_) - 1)))
+#define BC_FreeAligned(_ptr_) free(_ptr_)
+#endif
+
 #endif
 
 typedef struct BC_MemoryInfo {
 	size_t system_current_rss;
 	size_t system_peak_rss;
+	size_t system_pss;            // Resident bytes with shared pages split between their users, RSS where unavailable
+	size_t system_rss_anonymous;  // Resident heap, stack and anonymous mappings, Linux only
+	size_t system_rss_file;       // Resident file backed and shared memory pages, Linux only
+	size_t system_huge_pages;     // Bytes backed by transparent huge pages, 0 where the OS does not report it
 #if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1
 	size_t totalAllocated;
 	size_t currentAllocUsage;
-	size_t peakAllocUsage;
+	size_t peakAllocUsage;     // Threads publish usage every 64KB, so it can miss up to that much per thread
 	size_t allocationCount;
 	size_t freeCount;
 #endif
@@ -53,4 +102,15 @@ int BC_MemoryInfoGet(BC_MemoryInfo* info);
 void BC_MemoryInfoPrint();
 void BC_MemoryInfoHeapReset();
 
+// Current resident set size alone, cheap enough to poll (one read of /proc/self/statm on Linux)
+size_t BC_MemoryCurrentRss(void);
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1
+// Same as BC_MemoryInfo.currentAllocUsage without the system queries
+size_t BC_MemoryHeapUsage(void);
+#endif
+
+// Writes `bytes` as "12.34 MB" for the memory reports
+void INTERNAL_BC_MemoryFormatBytes(size_t bytes, char* out, size_t outSize);
+
 #endif //BCRUNTIME_BC_Memory_H
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "BC_MemoryMonitor.h"
+
+#include "BC_Arena.h"
+#include "BC_Memory.h"
+#include "../Thread/BC_Atomics.h"
+#include "../Thread/BC_Threads.h"
+
+#include <stdio.h>
+
+// =========================================================
+// MARK: State
+// =========================================================
+
+// Longest the background thread sleeps before checking it should stop
+#define PRIV_MONITOR_STOP_LATENCY 10000000ull
+
+static struct {
+	BC_MemorySample* samples;  // Ring buffer, guarded by gMonitorMutex
+	size_t capacity;
+	size_t head;               // Next slot to write
+	size_t count;
+	uint64_t interval;         // Nanoseconds between background samples
+	BC_atomic_bool running;    // Keeps the background thread going
+	BC_atomic_bool started;    // Claimed by the start that owns the thread, released once it is joined
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BCThread thread;
+#endif
+} gMonitor;
+
+BC_MUTEX_MAYBE(gMonitorMutex)
+BC_ONCE_MAYBE_STATIC(gMonitorOnce)
+
+static void PRIV_MonitorSetup(void) {
+	BC_MutexInit(&gMonitorMutex);
+}
+
+// =========================================================
+// MARK: Sampling
+// =========================================================
+
+static void PRIV_MonitorTake(BC_MemorySample* sample) {
+	sample->timestamp = BC_TimeMonotonicNanoseconds();
+#if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1
+	sample->heapUsage = BC_MemoryHeapUsage();
+#else
+	sample->heapUsage = 0;
+#endif
+	sample->rss = BC_MemoryCurrentRss();
+	sample->arenaCapacity = BC_ArenaTotalCapacity();
+}
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+static void PRIV_MonitorMain(void* arg) {
+	(void)arg;
+	while (BC_atomic_load(&gMonitor.running)) {
+		BC_MemoryMonitorRecord();
+
+		// Sleep in slices so stop does not wait for a whole interval
+		uint64_t remaining = gMonitor.interval;
+		while (remaining > 0 && BC_atomic_load(&gMonitor.running)) {
+			const uint64_t slice = remaining < PRIV_MONITOR_STOP_LATENCY ? remaining : PRIV_MONITOR_STOP_LATENCY;
+			BC_ThreadSleep(slice);
+			remaining -= slice;
+		}
+	}
+}
+#endif
+
+// =========================================================
+// MARK: Public API
+// =========================================================
+
+BC_bool BC_MemoryMonitorStart(const uint32_t intervalMs, const size_t capacity) {
+	if (intervalMs == 0 || capacity == 0) {
+		fprintf(stderr, "BC_MemoryMonitorStart: Invalid interval or capacity (must be > 0)\n");
+		return BC_false;
+	}
+	BC_RunOnce(&gMonitorOnce, PRIV_MonitorSetup);
+	BC_MemoryMonitorStop();
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	// Two racing starts would both spawn a thread and leak one of them
+	BC_bool started = BC_false;
+	if (!BC_atomic_compare_exchange(&gMonitor.started, &started, BC_true)) {
+		fprintf(stderr, "BC_MemoryMonitorStart: Already started by another thread\n");
+		return BC_false;
+	}
+#endif
+
+	BC_MemorySample* samples = BC_Malloc(capacity * sizeof(BC_MemorySample));
+	if (!samples) {
+		fprintf(stderr, "BC_MemoryMonitorStart: Failed to allocate %zu samples\n", capacity);
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		BC_atomic_store(&gMonitor.started, BC_false);
+#endif
+		return BC_false;
+	}
+
+	BC_MutexLock(&gMonitorMutex);
+	BC_MemorySample* previous = gMonitor.samples;
+	gMonitor.samples = samples;
+	gMonitor.capacity = capacity;
+	gMonitor.head = 0;
+	gMonitor.count = 0;
+	gMonitor.interval = (uint64_t)intervalMs * 1000000ull;
+	BC_MutexUnlock(&gMonitorMutex);
+	BC_Free(previous);
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BC_atomic_store(&gMonitor.running, BC_true);
+	if (!BC_ThreadCreate(&gMonitor.thread, PRIV_MonitorMain, NULL)) {
+		BC_atomic_store(&gMonitor.running, BC_false);
+		BC_atomic_store(&gMonitor.started, BC_false);
+		return BC_false;
+	}
+#endif
+	return BC_true;
+}
+
+void BC_MemoryMonitorStop(void) {
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BC_bool running = BC_true;
+	if (BC_atomic_compare_exchange(&gMonitor.running, &running, BC_false)) {
+		BC_ThreadJoin(gMonitor.thread);
+		BC_atomic_store(&gMonitor.started, BC_false);
+	}
+#endif
+}
+
+void BC_MemoryMonitorRecord(void) {
+	BC_RunOnce(&gMonitorOnce, PRIV_MonitorSetup);
+
+	// System queries run outside the lock, readers only wait for the copy
+	BC_MemorySample sample;
+	PRIV_MonitorTake(&sample);
+
+	BC_MutexLock(&gMonitorMutex);
+	if (gMonitor.samples) {
+		gMonitor.samples[gMonitor.head] = sample;
+		gMonitor.head = (gMonitor.head + 1) % gMonitor.capacity;
+		if (gMonitor.count < gMonitor.capacity) gMonitor.count++;
+	}
+	BC_MutexUnlock(&gMonitorMutex);
+}
+
+size_t BC_MemoryMonitorQuery(const uint64_t since, BC_MemorySample* out, const size_t maxCount) {
+	if (!out || maxCount == 0) return 0;
+	BC_RunOnce(&gMonitorOnce, PRIV_MonitorSetup);
+
+	BC_MutexLock(&gMonitorMutex);
+	const size_t oldest = (gMonitor.head + gMonitor.capacity - gMonitor.count) % (gMonitor.capacity ? gMonitor.capacity : 1);
+	size_t copied = 0;
+	for (size_t i = 0; i < gMonitor.count && copied < maxCount; i++) {
+		const BC_MemorySample* sample = &gMonitor.samples[(oldest + i) % gMonitor.capacity];
+		if (sample->timestamp >= since) out[copied++] = *sample;
+	}
+	BC_MutexUnlock(&gMonitorMutex);
+	return copied;
+}
+
+void INTERNAL_BC_MemoryMonitorDeinitialize(void) {
+	BC_RunOnce(&gMonitorOnce, PRIV_MonitorSetup);
+	BC_MemoryMonitorStop();
+
+	BC_MutexLock(&gMonitorMutex);
+	BC_Free(gMonitor.samples);
+	gMonitor.samples = NULL;
+	gMonitor.capacity = 0;
+	gMonitor.head = 0;
+	gMonitor.count = 0;
+	BC_MutexUnlock(&gMonitorMutex);
+}
@@ -0,0 +1,40 @@
+#ifndef BCORE_MEMORY_MONITOR_H
+#define BCORE_MEMORY_MONITOR_H
+
+#include "../BC_Types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef struct BC_MemorySample {
+	uint64_t timestamp;      // BC_TimeMonotonicNanoseconds when the sample was taken
+	size_t heapUsage;        // Tracked heap bytes, 0 without BC_SETTINGS_DEBUG_ALLOCATION_TRACK
+	size_t rss;
+	size_t arenaCapacity;    // BC_ArenaTotalCapacity
+} BC_MemorySample;
+
+// =========================================================
+// MARK: Monitor
+// =========================================================
+
+// Keeps the last `capacity` samples in a ring buffer, replacing the previous one. A background
+// thread records a sample every `intervalMs`, without thread safety no thread is started and
+// samples are only taken by BC_MemoryMonitorRecord. When two threads start it at once only
+// one wins, the other returns BC_false.
+BC_bool BC_MemoryMonitorStart(uint32_t intervalMs, size_t capacity);
+
+// Stops the background thread, recorded samples stay queryable
+void BC_MemoryMonitorStop(void);
+
+// Records one sample right away, for example around a slow request
+void BC_MemoryMonitorRecord(void);
+
+// Copies samples taken at or after `since`, oldest first, and returns how many were copied.
+// Pass 0 for every sample still in the ring buffer.
+size_t BC_MemoryMonitorQuery(uint64_t since, BC_MemorySample* out, size_t maxCount);
+
+#endif //BCORE_MEMORY_MONITOR_H
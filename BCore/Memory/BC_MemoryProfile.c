@@ -0,0 +1,280 @@
+#include "BC_MemoryProfile.h"
+
+#include "../Thread/BC_Threads.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__has_include)
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define PRIV_MEMORY_HAS_EXECINFO 1
+#endif
+#endif
+
+// =========================================================
+// MARK: Call Stacks
+// =========================================================
+
+#define PRIV_MEMORY_BACKTRACE_MAX 64
+
+__attribute__((noinline))
+size_t BC_MemoryBacktrace(void** frames, const size_t maxFrames, const size_t skip) {
+	if (!frames || maxFrames == 0) return 0;
+
+#if defined(_WIN32)
+	// Skip this function as well
+	return CaptureStackBackTrace((DWORD)(skip + 1), (DWORD)maxFrames, frames, NULL);
+#elif defined(PRIV_MEMORY_HAS_EXECINFO)
+	void* buffer[PRIV_MEMORY_BACKTRACE_MAX];
+	size_t wanted = maxFrames + skip + 1;
+	if (wanted > PRIV_MEMORY_BACKTRACE_MAX) wanted = PRIV_MEMORY_BACKTRACE_MAX;
+
+	const int count = backtrace(buffer, (int)wanted);
+	if (count <= (int)(skip + 1)) return 0;
+
+	size_t written = (size_t)count - (skip + 1);
+	if (written > maxFrames) written = maxFrames;
+	memcpy(frames, buffer + skip + 1, written * sizeof(void*));
+	return written;
+#else
+	(void)skip;
+	return 0;
+#endif
+}
+
+void BC_MemoryBacktracePrint(void* const* frames, const size_t frameCount, const char* indent) {
+	if (!indent) indent = "";
+
+#if defined(PRIV_MEMORY_HAS_EXECINFO)
+	char** symbols = backtrace_symbols(frames, (int)frameCount);
+	for (size_t i = 0; i < frameCount; i++) {
+		printf("%s%s\n", indent, symbols ? symbols[i] : "?");
+	}
+	free(symbols);
+#else
+	for (size_t i = 0; i < frameCount; i++) {
+		printf("%s%p\n", indent, frames[i]);
+	}
+#endif
+}
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_PROFILE == 1
+
+// =========================================================
+// MARK: Sites
+// =========================================================
+
+typedef struct INTERNAL_BC_MemorySite {
+	uint64_t hash;
+	void* frames[BC_MEMORY_PROFILE_DEPTH];
+	size_t frameCount;
+	size_t liveBytes;
+	size_t liveCount;
+} INTERNAL_BC_MemorySite;
+
+// Open addressing table twice as large as the site storage keeps probes short
+#define PRIV_MEMORY_SITE_TABLE_SIZE (BC_MEMORY_PROFILE_MAX_SITES * 2)
+
+static INTERNAL_BC_MemorySite gMemorySites[BC_MEMORY_PROFILE_MAX_SITES];
+static size_t gMemorySiteCount = 0;
+static INTERNAL_BC_MemorySite* gMemorySiteTable[PRIV_MEMORY_SITE_TABLE_SIZE];
+static INTERNAL_BC_MemorySite gMemorySiteOverflow;
+BC_MUTEX_MAYBE(gMemoryProfileMutex)
+BC_ONCE_MAYBE_STATIC(gMemoryProfileOnce)
+
+static void PRIV_MemoryProfileSetup(void) {
+	BC_MutexInit(&gMemoryProfileMutex);
+}
+
+static uint64_t PRIV_MemorySiteHash(void* const* frames, const size_t frameCount) {
+	// FNV-1a over the frame addresses
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < frameCount; i++) {
+		hash ^= (uint64_t)(uintptr_t)frames[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+// Must be called with gMemoryProfileMutex held
+static INTERNAL_BC_MemorySite* PRIV_MemorySiteFind(void* const* frames, const size_t frameCount) {
+	const uint64_t hash = PRIV_MemorySiteHash(frames, frameCount);
+	size_t slot = hash & (PRIV_MEMORY_SITE_TABLE_SIZE - 1);
+
+	while (gMemorySiteTable[slot]) {
+		INTERNAL_BC_MemorySite* site = gMemorySiteTable[slot];
+		if (site->hash == hash && site->frameCount == frameCount
+			&& memcmp(site->frames, frames, frameCount * sizeof(void*)) == 0) {
+			return site;
+		}
+		slot = (slot + 1) & (PRIV_MEMORY_SITE_TABLE_SIZE - 1);
+	}
+
+	if (gMemorySiteCount == BC_MEMORY_PROFILE_MAX_SITES) {
+		return &gMemorySiteOverflow;
+	}
+
+	INTERNAL_BC_MemorySite* site = &gMemorySites[gMemorySiteCount++];
+	site->hash = hash;
+	site->frameCount = frameCount;
+	memcpy(site->frames, frames, frameCount * sizeof(void*));
+	gMemorySiteTable[slot] = site;
+	return site;
+}
+
+INTERNAL_BC_MemorySiteRef INTERNAL_BC_MemoryProfileAlloc(const size_t size) {
+	void* frames[BC_MEMORY_PROFILE_DEPTH];
+	// Skip this hook, the stack is walked outside the lock
+	const size_t frameCount = BC_MemoryBacktrace(frames, BC_MEMORY_PROFILE_DEPTH, 1);
+
+	BC_RunOnce(&gMemoryProfileOnce, PRIV_MemoryProfileSetup);
+	BC_MutexLock(&gMemoryProfileMutex);
+	INTERNAL_BC_MemorySite* site = PRIV_MemorySiteFind(frames, frameCount);
+	site->liveBytes += size;
+	site->liveCount++;
+	BC_MutexUnlock(&gMemoryProfileMutex);
+
+	return site;
+}
+
+void INTERNAL_BC_MemoryProfileFree(const INTERNAL_BC_MemorySiteRef site, const size_t size) {
+	if (!site) return;
+	BC_MutexLock(&gMemoryProfileMutex);
+	site->liveBytes -= size;
+	site->liveCount--;
+	BC_MutexUnlock(&gMemoryProfileMutex);
+}
+
+// =========================================================
+// MARK: Snapshots
+// =========================================================
+
+typedef struct PRIV_MemorySnapshotEntry {
+	size_t liveBytes;
+	size_t liveCount;
+} PRIV_MemorySnapshotEntry;
+
+// Sites are never removed, so the entry index is the site index. The last entry is the overflow site.
+typedef struct BC_MemorySnapshot {
+	size_t count;
+	PRIV_MemorySnapshotEntry entries[];
+} BC_MemorySnapshot;
+
+static INTERNAL_BC_MemorySite* PRIV_MemorySiteAt(const size_t index, const size_t snapshotCount) {
+	return index == snapshotCount - 1 ? &gMemorySiteOverflow : &gMemorySites[index];
+}
+
+static PRIV_MemorySnapshotEntry PRIV_MemorySnapshotEntryFor(const BC_MemorySnapshotRef snapshot, const INTERNAL_BC_MemorySite* site) {
+	const size_t index = site == &gMemorySiteOverflow ? snapshot->count - 1 : (size_t)(site - gMemorySites);
+	if (site != &gMemorySiteOverflow && index >= snapshot->count - 1) {
+		return (PRIV_MemorySnapshotEntry){0, 0};
+	}
+	return snapshot->entries[index];
+}
+
+BC_MemorySnapshotRef BC_MemorySnapshotTake(void) {
+	BC_RunOnce(&gMemoryProfileOnce, PRIV_MemoryProfileSetup);
+	BC_MutexLock(&gMemoryProfileMutex);
+
+	// Snapshots are not tracked so they do not show up in the profile they capture
+	const size_t count = gMemorySiteCount + 1;
+	BC_MemorySnapshot* snapshot = malloc(sizeof(BC_MemorySnapshot) + count * sizeof(PRIV_MemorySnapshotEntry));
+	if (!snapshot) {
+		BC_MutexUnlock(&gMemoryProfileMutex);
+		fprintf(stderr, "BC_MemorySnapshotTake: Failed to allocate snapshot\n");
+		return NULL;
+	}
+
+	snapshot->count = count;
+	for (size_t i = 0; i < count; i++) {
+		const INTERNAL_BC_MemorySite* site = PRIV_MemorySiteAt(i, count);
+		snapshot->entries[i].liveBytes = site->liveBytes;
+		snapshot->entries[i].liveCount = site->liveCount;
+	}
+
+	BC_MutexUnlock(&gMemoryProfileMutex);
+	return snapshot;
+}
+
+void BC_MemorySnapshotDestroy(const BC_MemorySnapshotRef snapshot) {
+	free(snapshot);
+}
+
+size_t BC_MemorySnapshotLiveBytes(const BC_MemorySnapshotRef snapshot) {
+	if (!snapshot) return 0;
+	size_t total = 0;
+	for (size_t i = 0; i < snapshot->count; i++) {
+		total += snapshot->entries[i].liveBytes;
+	}
+	return total;
+}
+
+static int PRIV_MemorySiteDiffCompare(const void* a, const void* b) {
+	const int64_t deltaA = ((const BC_MemorySiteDiff*)a)->bytesDelta;
+	const int64_t deltaB = ((const BC_MemorySiteDiff*)b)->bytesDelta;
+	return deltaA < deltaB ? 1 : deltaA > deltaB ? -1 : 0;
+}
+
+size_t BC_MemorySnapshotDiff(const BC_MemorySnapshotRef before, const BC_MemorySnapshotRef after, BC_MemorySiteDiff* out, const size_t maxSites) {
+	if (!before || !after || !out || maxSites == 0) return 0;
+
+	BC_MemorySiteDiff* diffs = malloc(after->count * sizeof(BC_MemorySiteDiff));
+	if (!diffs) {
+		fprintf(stderr, "BC_MemorySnapshotDiff: Failed to allocate diff\n");
+		return 0;
+	}
+
+	size_t count = 0;
+	for (size_t i = 0; i < after->count; i++) {
+		const INTERNAL_BC_MemorySite* site = PRIV_MemorySiteAt(i, after->count);
+		const PRIV_MemorySnapshotEntry old = PRIV_MemorySnapshotEntryFor(before, site);
+		const PRIV_MemorySnapshotEntry current = after->entries[i];
+		if (old.liveBytes == current.liveBytes && old.liveCount == current.liveCount) continue;
+
+		diffs[count++] = (BC_MemorySiteDiff){
+			.frames = site->frames,
+			.frameCount = site->frameCount,
+			.bytesDelta = (int64_t)current.liveBytes - (int64_t)old.liveBytes,
+			.countDelta = (int64_t)current.liveCount - (int64_t)old.liveCount,
+			.liveBytes = current.liveBytes,
+			.liveCount = current.liveCount,
+		};
+	}
+
+	qsort(diffs, count, sizeof(BC_MemorySiteDiff), PRIV_MemorySiteDiffCompare);
+
+	if (count > maxSites) count = maxSites;
+	memcpy(out, diffs, count * sizeof(BC_MemorySiteDiff));
+	free(diffs);
+	return count;
+}
+
+void BC_MemorySnapshotDiffPrint(const BC_MemorySnapshotRef before, const BC_MemorySnapshotRef after, const size_t top) {
+	if (!before || !after || top == 0) return;
+
+	BC_MemorySiteDiff* diffs = malloc(top * sizeof(BC_MemorySiteDiff));
+	if (!diffs) return;
+
+	const size_t count = BC_MemorySnapshotDiff(before, after, diffs, top);
+	printf("\nHeap growth by allocation site (%zu -> %zu live bytes)\n",
+		BC_MemorySnapshotLiveBytes(before), BC_MemorySnapshotLiveBytes(after));
+
+	for (size_t i = 0; i < count; i++) {
+		printf("#%zu %+lld bytes, %+lld allocations (live: %zu bytes in %zu allocations)\n",
+			i + 1, (long long)diffs[i].bytesDelta, (long long)diffs[i].countDelta, diffs[i].liveBytes, diffs[i].liveCount);
+		if (diffs[i].frameCount == 0) {
+			printf("    <unknown site>\n");
+		} else {
+			BC_MemoryBacktracePrint(diffs[i].frames, diffs[i].frameCount, "    ");
+		}
+	}
+	printf("\n");
+
+	free(diffs);
+}
+
+#endif
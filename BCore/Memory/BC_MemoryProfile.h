@@ -0,0 +1,76 @@
+#ifndef BCORE_MEMORY_PROFILE_H
+#define BCORE_MEMORY_PROFILE_H
+
+#include "../BC_Settings.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Frames recorded per allocation site, the innermost ones identify the site
+#define BC_MEMORY_PROFILE_DEPTH 8
+
+// Distinct allocation sites tracked, allocations from sites past that are counted in an overflow site
+#define BC_MEMORY_PROFILE_MAX_SITES 4096
+
+// =========================================================
+// MARK: Call Stacks
+// =========================================================
+
+// Fills frames with up to maxFrames return addresses of the caller, skipping the `skip` innermost ones.
+// Returns the number of frames written, 0 when the platform can not walk the stack.
+size_t BC_MemoryBacktrace(void** frames, size_t maxFrames, size_t skip);
+
+// Prints one frame per line, symbolized when the platform allows it (link with -rdynamic for names on Linux)
+void BC_MemoryBacktracePrint(void* const* frames, size_t frameCount, const char* indent);
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_PROFILE == 1
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef struct BC_MemorySnapshot* BC_MemorySnapshotRef;
+
+typedef struct BC_MemorySiteDiff {
+	void* const* frames;
+	size_t frameCount;
+	int64_t bytesDelta;   // Live bytes growth between the two snapshots
+	int64_t countDelta;   // Live allocations growth between the two snapshots
+	size_t liveBytes;     // Live bytes in the later snapshot
+	size_t liveCount;     // Live allocations in the later snapshot
+} BC_MemorySiteDiff;
+
+// =========================================================
+// MARK: Snapshots
+// =========================================================
+
+// Copies the live bytes and allocation count of every site
+BC_MemorySnapshotRef BC_MemorySnapshotTake(void);
+void BC_MemorySnapshotDestroy(BC_MemorySnapshotRef snapshot);
+
+size_t BC_MemorySnapshotLiveBytes(BC_MemorySnapshotRef snapshot);
+
+// Writes the sites whose live bytes changed, sorted by growth (largest first), up to maxSites.
+// Returns the number of entries written. Frames stay valid for the lifetime of the process.
+size_t BC_MemorySnapshotDiff(BC_MemorySnapshotRef before, BC_MemorySnapshotRef after, BC_MemorySiteDiff* out, size_t maxSites);
+
+// Prints the `top` growers between the two snapshots
+void BC_MemorySnapshotDiffPrint(BC_MemorySnapshotRef before, BC_MemorySnapshotRef after, size_t top);
+
+// =========================================================
+// MARK: Internal
+// =========================================================
+
+typedef struct INTERNAL_BC_MemorySite* INTERNAL_BC_MemorySiteRef;
+
+// Hooks used by the tracked allocator
+INTERNAL_BC_MemorySiteRef INTERNAL_BC_MemoryProfileAlloc(size_t size);
+void INTERNAL_BC_MemoryProfileFree(INTERNAL_BC_MemorySiteRef site, size_t size);
+
+#endif
+
+#endif //BCORE_MEMORY_PROFILE_H
@@ -0,0 +1,330 @@
+#include "BC_MemorySampler.h"
+
+#if BC_SETTINGS_ALLOCATION_SAMPLING == 1
+
+#include "BC_MemoryProfile.h"
+#include "../BC_Macro.h"
+#include "../Thread/BC_Atomics.h"
+#include "../Thread/BC_Threads.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && defined(__has_include)
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define PRIV_SAMPLER_HAS_EXECINFO 1
+#endif
+#endif
+
+// How often a thread checks the interval again while sampling is disabled
+#define PRIV_SAMPLER_DISABLED_RECHECK BC_MB(1)
+
+// =========================================================
+// MARK: Stacks
+// =========================================================
+
+typedef struct PRIV_SamplerStack {
+	uint64_t hash;
+	void* frames[BC_MEMORY_SAMPLER_DEPTH];
+	size_t frameCount;
+	size_t count;        // Samples taken from this stack
+	size_t bytes;        // Bytes of the sampled allocations
+	double weight;       // Estimated bytes allocated from this stack, samples scaled by their probability
+} PRIV_SamplerStack;
+
+#define PRIV_SAMPLER_TABLE_SIZE (BC_MEMORY_SAMPLER_MAX_STACKS * 2)
+
+static PRIV_SamplerStack gSamplerStacks[BC_MEMORY_SAMPLER_MAX_STACKS];
+static size_t gSamplerStackCount = 0;
+static PRIV_SamplerStack* gSamplerTable[PRIV_SAMPLER_TABLE_SIZE];
+static PRIV_SamplerStack gSamplerOverflow;
+static size_t gSamplerSampleCount = 0;
+static size_t gSamplerSampleInterval = 0; // Interval of the last sample, the one the profile header reports
+static BC_atomic_size gSamplerInterval = 0;
+BC_MUTEX_MAYBE(gSamplerMutex)
+BC_ONCE_MAYBE_STATIC(gSamplerOnce)
+
+BC_TLS int64_t INTERNAL_BC_MemorySamplerCountdown = 0;
+static BC_TLS BC_bool gSamplerArmed = BC_false;
+static BC_TLS uint64_t gSamplerRandom = 0;
+
+static void PRIV_SamplerSetup(void) {
+	BC_MutexInit(&gSamplerMutex);
+}
+
+// =========================================================
+// MARK: Math
+// =========================================================
+
+// libm free approximations, samples only need a few digits of precision
+
+static double PRIV_SamplerLog2(const double x) {
+	union { double d; uint64_t u; } bits = {x};
+	const int exponent = (int)((bits.u >> 52) & 0x7FF) - 1023;
+	bits.u = (bits.u & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+	// ln(m) = 2 * atanh((m - 1) / (m + 1)), the series converges fast for m in [1, 2)
+	const double t = (bits.d - 1.0) / (bits.d + 1.0);
+	const double t2 = t * t;
+	const double ln = 2.0 * t * (1.0 + t2 * (1.0 / 3.0 + t2 * (1.0 / 5.0 + t2 * (1.0 / 7.0 + t2 / 9.0))));
+	return exponent + ln * 1.4426950408889634;
+}
+
+static double PRIV_SamplerExp2(const double y) {
+	if (y < -1022.0) return 0.0;
+	const int integer = (int)y - (y < (int)y ? 1 : 0);
+	const double f = y - integer;
+	union { double d; uint64_t u; } bits;
+	bits.d = 1.0 + f * (0.6931472 + f * (0.2402265 + f * (0.0555041 + f * 0.0096181)));
+	bits.u += (uint64_t)(int64_t)integer << 52;
+	return bits.d;
+}
+
+static uint64_t PRIV_SamplerRandom(void) {
+	if (gSamplerRandom == 0) {
+		gSamplerRandom = (uint64_t)(uintptr_t)&gSamplerRandom ^ 0x9E3779B97F4A7C15ULL;
+	}
+	// xorshift64*
+	gSamplerRandom ^= gSamplerRandom >> 12;
+	gSamplerRandom ^= gSamplerRandom << 25;
+	gSamplerRandom ^= gSamplerRandom >> 27;
+	return gSamplerRandom * 0x2545F4914F6CDD1DULL;
+}
+
+// Exponentially distributed gaps make every byte equally likely to be sampled
+static int64_t PRIV_SamplerNextGap(const size_t interval) {
+	const double u = ((PRIV_SamplerRandom() >> 11) + 1) * (1.0 / 9007199254740993.0);
+	const double gap = -PRIV_SamplerLog2(u) * 0.6931471805599453 * (double)interval;
+	return (int64_t)gap + 1;
+}
+
+// =========================================================
+// MARK: Sampling
+// =========================================================
+
+// Must be called with gSamplerMutex held
+static PRIV_SamplerStack* PRIV_SamplerStackFind(void* const* frames, const size_t frameCount) {
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < frameCount; i++) {
+		hash ^= (uint64_t)(uintptr_t)frames[i];
+		hash *= 1099511628211ULL;
+	}
+
+	size_t slot = hash & (PRIV_SAMPLER_TABLE_SIZE - 1);
+	while (gSamplerTable[slot]) {
+		PRIV_SamplerStack* stack = gSamplerTable[slot];
+		if (stack->hash == hash && stack->frameCount == frameCount
+			&& memcmp(stack->frames, frames, frameCount * sizeof(void*)) == 0) {
+			return stack;
+		}
+		slot = (slot + 1) & (PRIV_SAMPLER_TABLE_SIZE - 1);
+	}
+
+	if (gSamplerStackCount == BC_MEMORY_SAMPLER_MAX_STACKS) {
+		return &gSamplerOverflow;
+	}
+
+	PRIV_SamplerStack* stack = &gSamplerStacks[gSamplerStackCount++];
+	stack->hash = hash;
+	stack->frameCount = frameCount;
+	memcpy(stack->frames, frames, frameCount * sizeof(void*));
+	// The slot may have been used before the last reset
+	stack->count = 0;
+	stack->bytes = 0;
+	stack->weight = 0.0;
+	gSamplerTable[slot] = stack;
+	return stack;
+}
+
+void INTERNAL_BC_MemorySamplerSample(const size_t size) {
+	const size_t interval = BC_atomic_load_relaxed(&gSamplerInterval);
+	if (interval == 0) {
+		gSamplerArmed = BC_false;
+		INTERNAL_BC_MemorySamplerCountdown = PRIV_SAMPLER_DISABLED_RECHECK;
+		return;
+	}
+
+	// First check after enabling only draws the gap, otherwise every thread would sample its next allocation
+	if (!gSamplerArmed) {
+		gSamplerArmed = BC_true;
+		INTERNAL_BC_MemorySamplerCountdown = PRIV_SamplerNextGap(interval);
+		return;
+	}
+
+	INTERNAL_BC_MemorySamplerCountdown = PRIV_SamplerNextGap(interval);
+
+	void* frames[BC_MEMORY_SAMPLER_DEPTH];
+	// Skip this function, the innermost frame left is the allocation function or its caller once inlined
+	const size_t frameCount = BC_MemoryBacktrace(frames, BC_MEMORY_SAMPLER_DEPTH, 1);
+
+	// An allocation of `size` bytes is sampled with probability 1 - e^(-size / interval)
+	const double probability = 1.0 - PRIV_SamplerExp2(-(double)size / (double)interval * 1.4426950408889634);
+	const double weight = probability > 0.0 ? (double)size / probability : (double)interval;
+
+	BC_RunOnce(&gSamplerOnce, PRIV_SamplerSetup);
+	BC_MutexLock(&gSamplerMutex);
+	PRIV_SamplerStack* stack = PRIV_SamplerStackFind(frames, frameCount);
+	stack->count++;
+	stack->bytes += size;
+	stack->weight += weight;
+	gSamplerSampleCount++;
+	gSamplerSampleInterval = interval;
+	BC_MutexUnlock(&gSamplerMutex);
+}
+
+// =========================================================
+// MARK: Output
+// =========================================================
+
+static void PRIV_SamplerWritePprofStack(FILE* file, const PRIV_SamplerStack* stack) {
+	fprintf(file, "%6zu: %8zu [%6zu: %8zu] @", (size_t)0, (size_t)0, stack->count, stack->bytes);
+	for (size_t i = 0; i < stack->frameCount; i++) {
+		fprintf(file, " %p", stack->frames[i]);
+	}
+	fprintf(file, "\n");
+}
+
+static void PRIV_SamplerWritePprof(FILE* file, const size_t interval) {
+	size_t totalCount = gSamplerOverflow.count;
+	size_t totalBytes = gSamplerOverflow.bytes;
+	for (size_t i = 0; i < gSamplerStackCount; i++) {
+		totalCount += gSamplerStacks[i].count;
+		totalBytes += gSamplerStacks[i].bytes;
+	}
+
+	// Only allocations are sampled, in use counts are left at zero
+	fprintf(file, "heap profile: %6zu: %8zu [%6zu: %8zu] @ heap_v2/%zu\n", (size_t)0, (size_t)0, totalCount, totalBytes, interval);
+	for (size_t i = 0; i < gSamplerStackCount; i++) {
+		PRIV_SamplerWritePprofStack(file, &gSamplerStacks[i]);
+	}
+	if (gSamplerOverflow.count) {
+		PRIV_SamplerWritePprofStack(file, &gSamplerOverflow);
+	}
+
+	// Lets pprof map addresses back to binaries
+	fprintf(file, "\nMAPPED_LIBRARIES:\n");
+#if defined(__linux__)
+	FILE* maps = fopen("/proc/self/maps", "r");
+	if (maps) {
+		char buffer[4096];
+		size_t read;
+		while ((read = fread(buffer, 1, sizeof(buffer), maps)) > 0) {
+			fwrite(buffer, 1, read, file);
+		}
+		fclose(maps);
+	}
+#endif
+}
+
+static void PRIV_SamplerWriteFrameName(FILE* file, void* frame, const char* symbol) {
+	// backtrace_symbols gives "binary(function+0x12) [0x...]", keep the function name
+	if (symbol) {
+		const char* open = strchr(symbol, '(');
+		if (open) {
+			const char* end = open + 1;
+			while (*end && *end != '+' && *end != ')') end++;
+			if (end > open + 1) {
+				fprintf(file, "%.*s", (int)(end - open - 1), open + 1);
+				return;
+			}
+		}
+	}
+	fprintf(file, "%p", frame);
+}
+
+static void PRIV_SamplerWriteFoldedStack(FILE* file, const PRIV_SamplerStack* stack) {
+	if (stack->frameCount == 0) {
+		fprintf(file, "[unknown] %.0f\n", stack->weight);
+		return;
+	}
+
+	char** symbols = NULL;
+#if defined(PRIV_SAMPLER_HAS_EXECINFO)
+	symbols = backtrace_symbols(stack->frames, (int)stack->frameCount);
+#endif
+
+	// Folded stacks go from the root to the leaf
+	for (size_t i = stack->frameCount; i > 0; i--) {
+		PRIV_SamplerWriteFrameName(file, stack->frames[i - 1], symbols ? symbols[i - 1] : NULL);
+		fprintf(file, i > 1 ? ";" : " ");
+	}
+	fprintf(file, "%.0f\n", stack->weight);
+
+	free(symbols);
+}
+
+static void PRIV_SamplerWriteFolded(FILE* file) {
+	for (size_t i = 0; i < gSamplerStackCount; i++) {
+		PRIV_SamplerWriteFoldedStack(file, &gSamplerStacks[i]);
+	}
+	if (gSamplerOverflow.count) {
+		PRIV_SamplerWriteFoldedStack(file, &gSamplerOverflow);
+	}
+}
+
+// =========================================================
+// MARK: Public API
+// =========================================================
+
+void BC_MemorySamplerSetInterval(const size_t interval) {
+	BC_atomic_store(&gSamplerInterval, interval);
+	// The calling thread picks it up right away, others at their next check
+	gSamplerArmed = BC_false;
+	INTERNAL_BC_MemorySamplerCountdown = 0;
+}
+
+size_t BC_MemorySamplerGetInterval(void) {
+	return BC_atomic_load(&gSamplerInterval);
+}
+
+void BC_MemorySamplerReset(void) {
+	BC_RunOnce(&gSamplerOnce, PRIV_SamplerSetup);
+	BC_MutexLock(&gSamplerMutex);
+	memset(gSamplerTable, 0, sizeof(gSamplerTable));
+	memset(&gSamplerOverflow, 0, sizeof(gSamplerOverflow));
+	gSamplerStackCount = 0;
+	gSamplerSampleCount = 0;
+	gSamplerSampleInterval = 0;
+	BC_MutexUnlock(&gSamplerMutex);
+}
+
+size_t BC_MemorySamplerSampleCount(void) {
+	BC_RunOnce(&gSamplerOnce, PRIV_SamplerSetup);
+	BC_MutexLock(&gSamplerMutex);
+	const size_t count = gSamplerSampleCount;
+	BC_MutexUnlock(&gSamplerMutex);
+	return count;
+}
+
+BC_bool BC_MemorySamplerWriteProfileToFile(FILE* file, const BC_MemorySamplerFormat format) {
+	if (!file) return BC_false;
+
+	BC_RunOnce(&gSamplerOnce, PRIV_SamplerSetup);
+	BC_MutexLock(&gSamplerMutex);
+	switch (format) {
+		case BC_MemorySamplerFormatPprof:
+			// Samples were scaled by the interval they were taken at, not the one set now
+			PRIV_SamplerWritePprof(file, gSamplerSampleInterval ? gSamplerSampleInterval : BC_MemorySamplerGetInterval());
+			break;
+		case BC_MemorySamplerFormatFolded:
+			PRIV_SamplerWriteFolded(file);
+			break;
+	}
+	BC_MutexUnlock(&gSamplerMutex);
+
+	return ferror(file) ? BC_false : BC_true;
+}
+
+BC_bool BC_MemorySamplerWriteProfile(const char* path, const BC_MemorySamplerFormat format) {
+	FILE* file = path ? fopen(path, "w") : NULL;
+	if (!file) {
+		fprintf(stderr, "BC_MemorySamplerWriteProfile: Failed to open %s\n", path ? path : "(null)");
+		return BC_false;
+	}
+
+	const BC_bool result = BC_MemorySamplerWriteProfileToFile(file, format);
+	fclose(file);
+	return result;
+}
+
+#endif
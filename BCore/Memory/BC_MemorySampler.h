@@ -0,0 +1,72 @@
+#ifndef BCORE_MEMORY_SAMPLER_H
+#define BCORE_MEMORY_SAMPLER_H
+
+#include "../BC_Keywords.h"
+#include "../BC_Settings.h"
+#include "../BC_Types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if BC_SETTINGS_ALLOCATION_SAMPLING == 1
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Frames recorded per sampled allocation
+#define BC_MEMORY_SAMPLER_DEPTH 32
+
+// Distinct call stacks kept, samples from stacks past that are merged in an overflow stack
+#define BC_MEMORY_SAMPLER_MAX_STACKS 4096
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef enum {
+	BC_MemorySamplerFormatPprof = 0,   // Legacy heap profile text (heap_v2), read by `pprof -sample_index=alloc_space`
+	BC_MemorySamplerFormatFolded = 1,  // One `root;...;leaf bytes` line per stack, for flame graph tools
+} BC_MemorySamplerFormat;
+
+// =========================================================
+// MARK: Sampler
+// =========================================================
+
+// Samples one allocation every `interval` bytes on average, 0 disables sampling (the default).
+// Threads pick up a new interval within 1MB of allocations.
+void BC_MemorySamplerSetInterval(size_t interval);
+size_t BC_MemorySamplerGetInterval(void);
+
+// Drops every recorded sample
+void BC_MemorySamplerReset(void);
+size_t BC_MemorySamplerSampleCount(void);
+
+// Writes the allocation profile recorded since the last reset. The pprof header carries the
+// interval the samples were taken at, reset after changing it to keep profiles consistent.
+BC_bool BC_MemorySamplerWriteProfile(const char* path, BC_MemorySamplerFormat format);
+BC_bool BC_MemorySamplerWriteProfileToFile(FILE* file, BC_MemorySamplerFormat format);
+
+// =========================================================
+// MARK: Internal
+// =========================================================
+
+// Bytes left before the next sample of the current thread, the only cost when nothing is sampled
+extern BC_TLS int64_t INTERNAL_BC_MemorySamplerCountdown;
+
+void INTERNAL_BC_MemorySamplerSample(size_t size);
+
+static inline void INTERNAL_BC_MemorySamplerAccount(const size_t size) {
+	if ((INTERNAL_BC_MemorySamplerCountdown -= (int64_t)size) < 0) {
+		INTERNAL_BC_MemorySamplerSample(size);
+	}
+}
+
+#else
+
+#define INTERNAL_BC_MemorySamplerAccount(_size_) ((void)0)
+
+#endif
+
+#endif //BCORE_MEMORY_SAMPLER_H
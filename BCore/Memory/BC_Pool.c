@@ -0,0 +1,267 @@
+#include "BC_Pool.h"
+
+#include "BC_Allocator.h"
+#include "../BC_Types.h"
+#include "../Thread/BC_Threads.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// =========================================================
+// MARK: Pool Structure
+// =========================================================
+
+#define PRIV_POOL_ALIGNMENT 16
+
+typedef struct PRIV_PoolObject {
+	struct PRIV_PoolObject* next;
+} PRIV_PoolObject;
+
+typedef struct PRIV_PoolPage {
+	struct PRIV_PoolPage* next;
+	size_t reserved; // Keeps objects 16 bytes aligned from the page start
+} PRIV_PoolPage;
+
+typedef struct BC_Pool {
+	BC_AllocatorRef allocatorRef;  // Allocator for pages
+	BC_Allocator allocator;        // The allocator interface for this pool
+	BC_SPINLOCK_MAYBE(lock)
+	size_t objectSize;
+	size_t objectsPerPage;
+	PRIV_PoolObject* freeList;
+	char* cursor;                  // Next never used object of the current page
+	char* end;
+	PRIV_PoolPage* pages;          // In allocation order so BC_PoolReleaseAll can carve them again
+	PRIV_PoolPage* lastPage;
+	PRIV_PoolPage* nextPage;       // First page not carved yet
+	size_t pageCount;
+	size_t availableCount;
+} BC_Pool;
+
+// =========================================================
+// MARK: Private
+// =========================================================
+
+static inline size_t PRIV_PoolPageSize(const BC_PoolRef pool) {
+	return sizeof(PRIV_PoolPage) + pool->objectSize * pool->objectsPerPage;
+}
+
+// Runs outside the lock so other threads keep allocating while the parent works
+static PRIV_PoolPage* PRIV_PoolPageCreate(const BC_PoolRef pool) {
+	PRIV_PoolPage* page = BC_AllocatorAllocAligned(pool->allocatorRef, PRIV_PoolPageSize(pool), PRIV_POOL_ALIGNMENT);
+	if (!page) {
+		fprintf(stderr, "BC_Pool: Failed to allocate pool page of %zu bytes\n", PRIV_PoolPageSize(pool));
+	}
+	return page;
+}
+
+// Called with the lock held
+static void PRIV_PoolPageLink(const BC_PoolRef pool, PRIV_PoolPage* page) {
+	page->next = NULL;
+	if (pool->lastPage) {
+		pool->lastPage->next = page;
+	} else {
+		pool->pages = page;
+	}
+	pool->lastPage = page;
+	if (!pool->nextPage) pool->nextPage = page;
+
+	pool->pageCount++;
+	pool->availableCount += pool->objectsPerPage;
+}
+
+// =========================================================
+// MARK: Pool Allocator Implementation
+// =========================================================
+
+static void* IMPL_PoolAlloc(const size_t size, const void* ctx) {
+	const BC_PoolRef pool = (BC_PoolRef)ctx;
+	if (size == 0) return NULL;
+	if (size > pool->objectSize) {
+		fprintf(stderr, "BC_Pool: Requested %zu bytes from a pool of %zu byte objects\n", size, pool->objectSize);
+		return NULL;
+	}
+
+	BC_SpinlockLock(&pool->lock);
+
+	// Grow without holding the lock, another thread may free or grow in between so check again
+	while (!pool->freeList && pool->cursor == pool->end && !pool->nextPage) {
+		BC_SpinlockUnlock(&pool->lock);
+		PRIV_PoolPage* page = PRIV_PoolPageCreate(pool);
+		if (!page) return NULL;
+		BC_SpinlockLock(&pool->lock);
+		PRIV_PoolPageLink(pool, page);
+	}
+
+	void* object;
+	if (pool->freeList) {
+		object = pool->freeList;
+		pool->freeList = pool->freeList->next;
+	} else {
+		if (pool->cursor == pool->end) {
+			pool->cursor = (char*)pool->nextPage + sizeof(PRIV_PoolPage);
+			pool->end = (char*)pool->nextPage + PRIV_PoolPageSize(pool);
+			pool->nextPage = pool->nextPage->next;
+		}
+		object = pool->cursor;
+		pool->cursor += pool->objectSize;
+	}
+	pool->availableCount--;
+
+	BC_SpinlockUnlock(&pool->lock);
+	return object;
+}
+
+static void* IMPL_PoolAllocAligned(const size_t size, const size_t alignment, const void* ctx) {
+	if (alignment > PRIV_POOL_ALIGNMENT) {
+		fprintf(stderr, "BC_Pool: Alignment %zu is above the %d bytes pool objects are aligned to\n", alignment, PRIV_POOL_ALIGNMENT);
+		return NULL;
+	}
+	return IMPL_PoolAlloc(size, ctx);
+}
+
+static void IMPL_PoolFree(void* ptr, const void* ctx) {
+	if (!ptr) return;
+	const BC_PoolRef pool = (BC_PoolRef)ctx;
+	PRIV_PoolObject* object = ptr;
+
+	BC_SpinlockLock(&pool->lock);
+	object->next = pool->freeList;
+	pool->freeList = object;
+	pool->availableCount++;
+	BC_SpinlockUnlock(&pool->lock);
+}
+
+static void IMPL_PoolFreeSized(void* ptr, const size_t size, const void* ctx) {
+	(void)size;
+	IMPL_PoolFree(ptr, ctx);
+}
+
+static void* IMPL_PoolRealloc(void* ptr, const size_t oldSize, const size_t newSize, const void* ctx) {
+	(void)oldSize;
+	const BC_PoolRef pool = (BC_PoolRef)ctx;
+
+	// Every object already spans the whole object size
+	if (newSize > pool->objectSize) {
+		fprintf(stderr, "BC_Pool: Can not grow an object to %zu bytes in a pool of %zu byte objects\n", newSize, pool->objectSize);
+		return NULL;
+	}
+	return ptr;
+}
+
+// =========================================================
+// MARK: Public API
+// =========================================================
+
+BC_PoolRef BC_PoolCreate(BC_AllocatorRef allocator, const size_t objectSize, size_t objectsPerPage) {
+	if (objectSize == 0) {
+		fprintf(stderr, "BC_PoolCreate: Invalid object size (must be > 0)\n");
+		return NULL;
+	}
+
+	// Use system allocator if none provided
+	if (!allocator) {
+		allocator = kBC_AllocatorRefSystem;
+	}
+	if (objectsPerPage == 0) {
+		objectsPerPage = BC_POOL_DEFAULT_OBJECTS_PER_PAGE;
+	}
+
+	const BC_PoolRef pool = BC_AllocatorAlloc(allocator, sizeof(BC_Pool));
+	if (!pool) {
+		fprintf(stderr, "BC_PoolCreate: Failed to allocate pool structure\n");
+		return NULL;
+	}
+
+	pool->allocatorRef = allocator;
+	pool->allocator.alloc = IMPL_PoolAlloc;
+	pool->allocator.free = IMPL_PoolFree;
+	pool->allocator.context = pool;
+	pool->allocator.allocAligned = IMPL_PoolAllocAligned;
+	pool->allocator.realloc = IMPL_PoolRealloc;
+	pool->allocator.freeSized = IMPL_PoolFreeSized;
+
+	BC_SpinlockInit(&pool->lock);
+	pool->objectSize = (objectSize + PRIV_POOL_ALIGNMENT - 1) & ~(size_t)(PRIV_POOL_ALIGNMENT - 1);
+	pool->objectsPerPage = objectsPerPage;
+	pool->freeList = NULL;
+	pool->cursor = NULL;
+	pool->end = NULL;
+	pool->pages = NULL;
+	pool->lastPage = NULL;
+	pool->nextPage = NULL;
+	pool->pageCount = 0;
+	pool->availableCount = 0;
+
+	return pool;
+}
+
+void BC_PoolDestroy(const BC_PoolRef pool) {
+	if (!pool) return;
+
+	PRIV_PoolPage* page = pool->pages;
+	while (page) {
+		PRIV_PoolPage* next = page->next;
+		BC_AllocatorFreeAligned(pool->allocatorRef, page);
+		page = next;
+	}
+
+	BC_SpinlockDestroy(&pool->lock);
+	BC_AllocatorFreeSized(pool->allocatorRef, pool, sizeof(BC_Pool));
+}
+
+BC_AllocatorRef BC_PoolAllocator(const BC_PoolRef pool) {
+	if (!pool) return NULL;
+	return &pool->allocator;
+}
+
+BC_bool BC_PoolPrefill(const BC_PoolRef pool, const size_t count) {
+	if (!pool) return BC_false;
+
+	BC_SpinlockLock(&pool->lock);
+	while (pool->availableCount < count) {
+		BC_SpinlockUnlock(&pool->lock);
+		PRIV_PoolPage* page = PRIV_PoolPageCreate(pool);
+		if (!page) return BC_false;
+		BC_SpinlockLock(&pool->lock);
+		PRIV_PoolPageLink(pool, page);
+	}
+	BC_SpinlockUnlock(&pool->lock);
+	return BC_true;
+}
+
+void BC_PoolReleaseAll(const BC_PoolRef pool) {
+	if (!pool) return;
+
+	// Pages are carved again from the first one instead of threading every object on the free list
+	BC_SpinlockLock(&pool->lock);
+	pool->freeList = NULL;
+	pool->cursor = NULL;
+	pool->end = NULL;
+	pool->nextPage = pool->pages;
+	pool->availableCount = pool->pageCount * pool->objectsPerPage;
+	BC_SpinlockUnlock(&pool->lock);
+}
+
+size_t BC_PoolObjectSize(const BC_PoolRef pool) {
+	if (!pool) return 0;
+	return pool->objectSize;
+}
+
+size_t BC_PoolPageCount(const BC_PoolRef pool) {
+	if (!pool) return 0;
+
+	BC_SpinlockLock(&pool->lock);
+	const size_t count = pool->pageCount;
+	BC_SpinlockUnlock(&pool->lock);
+	return count;
+}
+
+size_t BC_PoolAvailableCount(const BC_PoolRef pool) {
+	if (!pool) return 0;
+
+	BC_SpinlockLock(&pool->lock);
+	const size_t count = pool->availableCount;
+	BC_SpinlockUnlock(&pool->lock);
+	return count;
+}
@@ -0,0 +1,40 @@
+#ifndef BCORE_POOL_H
+#define BCORE_POOL_H
+
+#include "BC_Allocator.h"
+#include "../BC_Macro.h"
+
+#include <stddef.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Objects carved from each page when BC_PoolCreate is given 0
+#define BC_POOL_DEFAULT_OBJECTS_PER_PAGE 64
+
+// =========================================================
+// MARK: Pool
+// =========================================================
+
+// Pool of objects of a single size, free objects are chained through their own storage so
+// there is no per object header. Allocations larger than `objectSize` fail, `objectSize` is
+// rounded up to keep every object 16 bytes aligned.
+BC_PoolRef BC_PoolCreate(BC_AllocatorRef allocator, size_t objectSize, size_t objectsPerPage);
+void BC_PoolDestroy(BC_PoolRef pool);
+
+BC_AllocatorRef BC_PoolAllocator(BC_PoolRef pool);
+
+// Grows the pool until at least `count` objects can be handed out without touching the parent allocator
+BC_bool BC_PoolPrefill(BC_PoolRef pool, size_t count);
+
+// Takes back every object at once, pages are kept for reuse. Objects still in use become invalid.
+void BC_PoolReleaseAll(BC_PoolRef pool);
+
+size_t BC_PoolObjectSize(BC_PoolRef pool);
+size_t BC_PoolPageCount(BC_PoolRef pool);
+
+// Objects that can be handed out before a new page is needed
+size_t BC_PoolAvailableCount(BC_PoolRef pool);
+
+#endif //BCORE_POOL_H
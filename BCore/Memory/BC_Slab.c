@@ -0,0 +1,292 @@
+#include "BC_Slab.h"
+
+#include "BC_Allocator.h"
+#include "../BC_Types.h"
+#include "../Thread/BC_Threads.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// =========================================================
+// MARK: Size Classes
+// =========================================================
+
+// Block sizes include the 8 byte header storing the size class
+static const size_t PRIV_kSlabClassSizes[] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256, 320, 384, 448, 512
+};
+
+#define PRIV_SLAB_CLASS_COUNT (sizeof(PRIV_kSlabClassSizes) / sizeof(PRIV_kSlabClassSizes[0]))
+_Static_assert(PRIV_SLAB_CLASS_COUNT == INTERNAL_BC_SLAB_CLASS_COUNT, "Slab class count mismatch");
+#define PRIV_SLAB_CLASS_LARGE SIZE_MAX
+#define PRIV_SLAB_HEADER_SIZE sizeof(size_t)
+
+// Blocks are handed out max_align_t aligned, large ones pad their header up to it
+#define PRIV_SLAB_ALIGNMENT 16
+#define PRIV_SLAB_LARGE_HEADER_SIZE PRIV_SLAB_ALIGNMENT
+
+// Maps (blockSize + 15) / 16 to its size class, so lookup is a single load
+static const uint8_t PRIV_kSlabClassForSlot[(BC_SLAB_MAX_BLOCK_SIZE >> 4) + 1] = {
+	0, 0, 1, 2, 3, 4, 5, 6, 7,
+	8, 8, 9, 9, 10, 10, 11, 11,
+	12, 12, 12, 12, 13, 13, 13, 13,
+	14, 14, 14, 14, 15, 15, 15, 15
+};
+
+size_t INTERNAL_BC_SlabClassIndex(const size_t blockSize) {
+	return PRIV_kSlabClassForSlot[(blockSize + 15) >> 4];
+}
+
+size_t INTERNAL_BC_SlabClassSize(const size_t classIndex) {
+	return PRIV_kSlabClassSizes[classIndex];
+}
+
+// =========================================================
+// MARK: Slab Structure
+// =========================================================
+
+typedef struct PRIV_SlabBlock {
+	struct PRIV_SlabBlock* next;
+} PRIV_SlabBlock;
+
+typedef struct PRIV_SlabPage {
+	struct PRIV_SlabPage* next;
+	size_t reserved; // Keeps the page header a multiple of 16 bytes
+} PRIV_SlabPage;
+
+typedef struct PRIV_SlabClass {
+	BC_SPINLOCK_MAYBE(lock)
+	PRIV_SlabBlock* freeList;
+	char* cursor;
+	char* end;
+	PRIV_SlabPage* pages;
+	size_t pageCount;
+} PRIV_SlabClass;
+
+typedef struct BC_Slab {
+	BC_AllocatorRef allocatorRef;  // Allocator for pages and large blocks
+	BC_Allocator allocator;        // The allocator interface for this slab
+	PRIV_SlabClass classes[PRIV_SLAB_CLASS_COUNT];
+} BC_Slab;
+
+// =========================================================
+// MARK: Private
+// =========================================================
+
+static BC_bool PRIV_SlabClassGrow(const BC_SlabRef slab, PRIV_SlabClass* sizeClass) {
+	PRIV_SlabPage* page = BC_AllocatorAllocAligned(slab->allocatorRef, BC_SLAB_PAGE_SIZE, PRIV_SLAB_ALIGNMENT);
+	if (!page) {
+		fprintf(stderr, "BC_Slab: Failed to allocate slab page of %d bytes\n", BC_SLAB_PAGE_SIZE);
+		return BC_false;
+	}
+
+	page->next = sizeClass->pages;
+	sizeClass->pages = page;
+	sizeClass->pageCount++;
+	// Class sizes are multiples of 16, starting the first header 8 bytes short of a 16 byte
+	// boundary puts the user data of every block on one
+	sizeClass->cursor = (char*)page + sizeof(PRIV_SlabPage) + PRIV_SLAB_ALIGNMENT - PRIV_SLAB_HEADER_SIZE;
+	sizeClass->end = (char*)page + BC_SLAB_PAGE_SIZE;
+
+	return BC_true;
+}
+
+static void PRIV_SlabClassInit(PRIV_SlabClass* sizeClass) {
+	BC_SpinlockInit(&sizeClass->lock);
+	sizeClass->freeList = NULL;
+	sizeClass->cursor = NULL;
+	sizeClass->end = NULL;
+	sizeClass->pages = NULL;
+	sizeClass->pageCount = 0;
+}
+
+static void PRIV_SlabClassRelease(const BC_SlabRef slab, PRIV_SlabClass* sizeClass) {
+	BC_SpinlockLock(&sizeClass->lock);
+	PRIV_SlabPage* page = sizeClass->pages;
+	while (page) {
+		PRIV_SlabPage* next = page->next;
+		BC_AllocatorFreeAligned(slab->allocatorRef, page);
+		page = next;
+	}
+	sizeClass->freeList = NULL;
+	sizeClass->cursor = NULL;
+	sizeClass->end = NULL;
+	sizeClass->pages = NULL;
+	sizeClass->pageCount = 0;
+	BC_SpinlockUnlock(&sizeClass->lock);
+}
+
+// =========================================================
+// MARK: Slab Allocator Implementation
+// =========================================================
+
+static void* IMPL_SlabAlloc(const size_t size, const void* ctx) {
+	const BC_SlabRef slab = (BC_SlabRef)ctx;
+	if (size == 0) return NULL;
+
+	const size_t blockSize = size + PRIV_SLAB_HEADER_SIZE;
+
+	// Large blocks bypass the size classes but keep a header so free can tell them apart
+	if (blockSize > BC_SLAB_MAX_BLOCK_SIZE) {
+		char* base = BC_AllocatorAllocAligned(slab->allocatorRef, size + PRIV_SLAB_LARGE_HEADER_SIZE, PRIV_SLAB_ALIGNMENT);
+		if (!base) return NULL;
+		char* ptr = base + PRIV_SLAB_LARGE_HEADER_SIZE;
+		*((size_t*)ptr - 1) = PRIV_SLAB_CLASS_LARGE;
+		return ptr;
+	}
+
+	const size_t classIndex = PRIV_kSlabClassForSlot[(blockSize + 15) >> 4];
+	PRIV_SlabClass* sizeClass = &slab->classes[classIndex];
+
+	BC_SpinlockLock(&sizeClass->lock);
+
+	size_t* header;
+	if (sizeClass->freeList) {
+		header = (size_t*)sizeClass->freeList;
+		sizeClass->freeList = sizeClass->freeList->next;
+	} else {
+		const size_t classSize = PRIV_kSlabClassSizes[classIndex];
+		if (!sizeClass->cursor || sizeClass->cursor + classSize > sizeClass->end) {
+			if (!PRIV_SlabClassGrow(slab, sizeClass)) {
+				BC_SpinlockUnlock(&sizeClass->lock);
+				return NULL;
+			}
+		}
+		header = (size_t*)sizeClass->cursor;
+		sizeClass->cursor += classSize;
+	}
+
+	BC_SpinlockUnlock(&sizeClass->lock);
+
+	*header = classIndex;
+	return header + 1;
+}
+
+static void IMPL_SlabFree(void* ptr, const void* ctx) {
+	if (!ptr) return;
+	const BC_SlabRef slab = (BC_SlabRef)ctx;
+
+	size_t* header = (size_t*)ptr - 1;
+	const size_t classIndex = *header;
+
+	if (classIndex == PRIV_SLAB_CLASS_LARGE) {
+		BC_AllocatorFreeAligned(slab->allocatorRef, (char*)ptr - PRIV_SLAB_LARGE_HEADER_SIZE);
+		return;
+	}
+
+	PRIV_SlabClass* sizeClass = &slab->classes[classIndex];
+	PRIV_SlabBlock* block = (PRIV_SlabBlock*)header;
+
+	BC_SpinlockLock(&sizeClass->lock);
+	block->next = sizeClass->freeList;
+	sizeClass->freeList = block;
+	BC_SpinlockUnlock(&sizeClass->lock);
+}
+
+static void IMPL_SlabFreeSized(void* ptr, const size_t size, const void* ctx) {
+	// The header tells the class, large blocks come from the parent aligned and go back the same way
+	(void)size;
+	IMPL_SlabFree(ptr, ctx);
+}
+
+static void* IMPL_SlabRealloc(void* ptr, const size_t oldSize, const size_t newSize, const void* ctx) {
+	const size_t classIndex = *((size_t*)ptr - 1);
+
+	// Stay in place while the new size still fits the block size class
+	if (classIndex != PRIV_SLAB_CLASS_LARGE && newSize > 0
+		&& newSize + PRIV_SLAB_HEADER_SIZE <= PRIV_kSlabClassSizes[classIndex]) {
+		return ptr;
+	}
+
+	void* newPtr = IMPL_SlabAlloc(newSize, ctx);
+	if (!newPtr) return NULL;
+	memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+	IMPL_SlabFree(ptr, ctx);
+	return newPtr;
+}
+
+// =========================================================
+// MARK: Shared Slab
+// =========================================================
+
+static BC_Slab PRIV_gSlabShared = {
+	.allocatorRef = NULL,
+	.allocator = {IMPL_SlabAlloc, IMPL_SlabFree, &PRIV_gSlabShared, NULL, IMPL_SlabRealloc, IMPL_SlabFreeSized},
+};
+
+const BC_AllocatorRef kBC_AllocatorRefSlab = &PRIV_gSlabShared.allocator;
+
+void INTERNAL_BC_SlabInitialize(void) {
+	PRIV_gSlabShared.allocatorRef = kBC_AllocatorRefSystem;
+	for (size_t i = 0; i < PRIV_SLAB_CLASS_COUNT; i++) {
+		PRIV_SlabClassInit(&PRIV_gSlabShared.classes[i]);
+	}
+}
+
+void INTERNAL_BC_SlabDeinitialize(void) {
+	for (size_t i = 0; i < PRIV_SLAB_CLASS_COUNT; i++) {
+		PRIV_SlabClassRelease(&PRIV_gSlabShared, &PRIV_gSlabShared.classes[i]);
+		BC_SpinlockDestroy(&PRIV_gSlabShared.classes[i].lock);
+	}
+}
+
+// =========================================================
+// MARK: Public API
+// =========================================================
+
+BC_SlabRef BC_SlabCreate(BC_AllocatorRef allocator) {
+	// Use system allocator if none provided
+	if (!allocator) {
+		allocator = kBC_AllocatorRefSystem;
+	}
+
+	const BC_SlabRef slab = BC_AllocatorAlloc(allocator, sizeof(BC_Slab));
+	if (!slab) {
+		fprintf(stderr, "BC_SlabCreate: Failed to allocate slab structure\n");
+		return NULL;
+	}
+
+	slab->allocatorRef = allocator;
+	slab->allocator.alloc = IMPL_SlabAlloc;
+	slab->allocator.free = IMPL_SlabFree;
+	slab->allocator.context = slab;
+	slab->allocator.allocAligned = NULL;
+	slab->allocator.realloc = IMPL_SlabRealloc;
+	slab->allocator.freeSized = IMPL_SlabFreeSized;
+
+	for (size_t i = 0; i < PRIV_SLAB_CLASS_COUNT; i++) {
+		PRIV_SlabClassInit(&slab->classes[i]);
+	}
+
+	return slab;
+}
+
+void BC_SlabDestroy(const BC_SlabRef slab) {
+	if (!slab || slab == &PRIV_gSlabShared) return;
+
+	for (size_t i = 0; i < PRIV_SLAB_CLASS_COUNT; i++) {
+		PRIV_SlabClassRelease(slab, &slab->classes[i]);
+		BC_SpinlockDestroy(&slab->classes[i].lock);
+	}
+
+	BC_AllocatorFree(slab->allocatorRef, slab);
+}
+
+BC_AllocatorRef BC_SlabAllocator(const BC_SlabRef slab) {
+	if (!slab) return NULL;
+	return &slab->allocator;
+}
+
+size_t BC_SlabPageCount(const BC_SlabRef slab) {
+	if (!slab) return 0;
+
+	size_t count = 0;
+	for (size_t i = 0; i < PRIV_SLAB_CLASS_COUNT; i++) {
+		BC_SpinlockLock(&slab->classes[i].lock);
+		count += slab->classes[i].pageCount;
+		BC_SpinlockUnlock(&slab->classes[i].lock);
+	}
+	return count;
+}
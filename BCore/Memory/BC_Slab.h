@@ -0,0 +1,45 @@
+#ifndef BCORE_SLAB_H
+#define BCORE_SLAB_H
+
+#include "BC_Allocator.h"
+#include "../BC_Macro.h"
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Size of each slab page carved into blocks of one size class
+#define BC_SLAB_PAGE_SIZE BC_KB(64)
+
+// Largest block (header included) served from a size class, bigger ones go to the parent allocator
+#define BC_SLAB_MAX_BLOCK_SIZE 512
+
+// =========================================================
+// MARK: Shared Slab
+// =========================================================
+
+// Process wide slab allocator, backed by the system allocator
+extern const BC_AllocatorRef kBC_AllocatorRefSlab;
+
+// =========================================================
+// MARK: Slab
+// =========================================================
+
+BC_SlabRef BC_SlabCreate(BC_AllocatorRef allocator);
+void BC_SlabDestroy(BC_SlabRef slab);
+
+BC_AllocatorRef BC_SlabAllocator(BC_SlabRef slab);
+
+size_t BC_SlabPageCount(BC_SlabRef slab);
+
+// =========================================================
+// MARK: Internal
+// =========================================================
+
+// Size classes shared with the thread cache, block sizes include an 8 byte header. Every class
+// size is a multiple of 16 so blocks carved back to back keep their user data 16 bytes aligned.
+#define INTERNAL_BC_SLAB_CLASS_COUNT 16
+size_t INTERNAL_BC_SlabClassIndex(size_t blockSize);
+size_t INTERNAL_BC_SlabClassSize(size_t classIndex);
+
+#endif //BCORE_SLAB_H
@@ -0,0 +1,305 @@
+#include "BC_ThreadCache.h"
+
+#include "BC_Slab.h"
+#include "../BC_Keywords.h"
+#include "../BC_Types.h"
+#include "../Thread/BC_Atomics.h"
+#include "../Thread/BC_Threads.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// =========================================================
+// MARK: Structures
+// =========================================================
+
+// Every block starts with the page it was carved from, NULL for large blocks
+#define PRIV_CACHE_HEADER_SIZE sizeof(void*)
+
+// Blocks are handed out max_align_t aligned, large ones pad their header up to it
+#define PRIV_CACHE_ALIGNMENT 16
+#define PRIV_CACHE_LARGE_HEADER_SIZE PRIV_CACHE_ALIGNMENT
+
+struct PRIV_CachePage;
+
+typedef struct PRIV_CacheBlock {
+	struct PRIV_CachePage* page;   // Header, kept while the block is free
+	struct PRIV_CacheBlock* next;  // Free list link, overlaps the user data
+} PRIV_CacheBlock;
+
+typedef struct PRIV_CachePage {
+	struct PRIV_CacheHeap* owner;
+	struct PRIV_CachePage* next;
+	size_t classIndex;
+	size_t reserved; // Keeps the page header a multiple of 16 bytes
+} PRIV_CachePage;
+
+typedef struct PRIV_CacheClass {
+	PRIV_CacheBlock* freeList;
+	PRIV_CachePage* page;         // Page the cursor carves from
+	char* cursor;
+	char* end;
+} PRIV_CacheClass;
+
+typedef struct PRIV_CacheHeap {
+	PRIV_CacheClass classes[INTERNAL_BC_SLAB_CLASS_COUNT];
+	PRIV_CachePage* pages;
+	size_t pageCount;
+	BC_bool inUse;                 // Guarded by gCacheMutex
+	struct PRIV_CacheHeap* next;
+	// Written by other threads, kept on its own cache line
+	_Alignas(BC_CACHE_LINE_SIZE) BC_atomic_ptr remoteFree;
+} PRIV_CacheHeap;
+
+static PRIV_CacheHeap* gCacheHeaps = NULL;
+static size_t gCacheHeapCount = 0;
+BC_MUTEX_MAYBE(gCacheMutex)
+BC_ONCE_MAYBE_STATIC(gCacheOnce)
+
+static BC_TLS PRIV_CacheHeap* gCacheHeap = NULL;
+
+// =========================================================
+// MARK: Heaps
+// =========================================================
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+#if defined(_WIN32)
+static DWORD gCacheHeapKey;
+#define PRIV_CacheHeapKeySet(_heap_) FlsSetValue(gCacheHeapKey, _heap_)
+#else
+static pthread_key_t gCacheHeapKey;
+#define PRIV_CacheHeapKeySet(_heap_) pthread_setspecific(gCacheHeapKey, _heap_)
+#endif
+
+// Called on thread exit, live blocks stay in the heap until a new thread adopts it
+static void
+#if defined(_WIN32)
+WINAPI
+#endif
+PRIV_CacheHeapRelease(void* ptr) {
+	PRIV_CacheHeap* heap = ptr;
+	if (!heap) return;
+	gCacheHeap = NULL;
+	BC_MutexLock(&gCacheMutex);
+	heap->inUse = BC_false;
+	BC_MutexUnlock(&gCacheMutex);
+}
+
+static void PRIV_CacheSetup(void) {
+	BC_MutexInit(&gCacheMutex);
+#if defined(_WIN32)
+	gCacheHeapKey = FlsAlloc(PRIV_CacheHeapRelease);
+#else
+	pthread_key_create(&gCacheHeapKey, PRIV_CacheHeapRelease);
+#endif
+}
+
+#else
+
+#define PRIV_CacheHeapKeySet(_heap_)
+static void PRIV_CacheSetup(void) {}
+
+#endif
+
+// Slow path, runs once per thread
+static PRIV_CacheHeap* PRIV_CacheHeapAcquire(void) {
+	BC_RunOnce(&gCacheOnce, PRIV_CacheSetup);
+
+	BC_MutexLock(&gCacheMutex);
+	PRIV_CacheHeap* heap = gCacheHeaps;
+	while (heap && heap->inUse) heap = heap->next;
+
+	if (!heap) {
+		heap = BC_AllocatorAllocAligned(kBC_AllocatorRefSystem, sizeof(PRIV_CacheHeap), BC_CACHE_LINE_SIZE);
+		if (!heap) {
+			BC_MutexUnlock(&gCacheMutex);
+			fprintf(stderr, "BC_ThreadCache: Failed to allocate thread heap\n");
+			return NULL;
+		}
+		memset(heap, 0, sizeof(PRIV_CacheHeap));
+		BC_atomic_store(&heap->remoteFree, NULL);
+		heap->next = gCacheHeaps;
+		gCacheHeaps = heap;
+		gCacheHeapCount++;
+	}
+	heap->inUse = BC_true;
+	BC_MutexUnlock(&gCacheMutex);
+
+	PRIV_CacheHeapKeySet(heap);
+	gCacheHeap = heap;
+	return heap;
+}
+
+static void PRIV_CacheHeapDestroy(PRIV_CacheHeap* heap) {
+	PRIV_CachePage* page = heap->pages;
+	while (page) {
+		PRIV_CachePage* next = page->next;
+		BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, page);
+		page = next;
+	}
+	BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, heap);
+}
+
+// Moves blocks freed by other threads back to their class free lists
+static BC_bool PRIV_CacheHeapDrainRemote(PRIV_CacheHeap* heap) {
+	PRIV_CacheBlock* block = BC_atomic_exchange(&heap->remoteFree, NULL);
+	if (!block) return BC_false;
+
+	while (block) {
+		PRIV_CacheBlock* next = block->next;
+		PRIV_CacheClass* sizeClass = &heap->classes[block->page->classIndex];
+		block->next = sizeClass->freeList;
+		sizeClass->freeList = block;
+		block = next;
+	}
+	return BC_true;
+}
+
+static BC_bool PRIV_CacheHeapGrow(PRIV_CacheHeap* heap, const size_t classIndex) {
+	PRIV_CachePage* page = BC_AllocatorAllocAligned(kBC_AllocatorRefSystem, BC_THREAD_CACHE_PAGE_SIZE, PRIV_CACHE_ALIGNMENT);
+	if (!page) {
+		fprintf(stderr, "BC_ThreadCache: Failed to allocate page of %d bytes\n", BC_THREAD_CACHE_PAGE_SIZE);
+		return BC_false;
+	}
+
+	page->owner = heap;
+	page->classIndex = classIndex;
+	page->next = heap->pages;
+	heap->pages = page;
+	heap->pageCount++;
+
+	PRIV_CacheClass* sizeClass = &heap->classes[classIndex];
+	sizeClass->page = page;
+	// Same layout as the slab, user data of every block lands on a 16 byte boundary
+	sizeClass->cursor = (char*)page + sizeof(PRIV_CachePage) + PRIV_CACHE_ALIGNMENT - PRIV_CACHE_HEADER_SIZE;
+	sizeClass->end = (char*)page + BC_THREAD_CACHE_PAGE_SIZE;
+	return BC_true;
+}
+
+// =========================================================
+// MARK: Allocator Implementation
+// =========================================================
+
+static void* IMPL_ThreadCacheAlloc(const size_t size, const void* ctx) {
+	(void)ctx;
+	if (size == 0) return NULL;
+
+	const size_t blockSize = size + PRIV_CACHE_HEADER_SIZE;
+
+	// Large blocks bypass the cache but keep a header so free can tell them apart
+	if (blockSize > BC_SLAB_MAX_BLOCK_SIZE) {
+		char* base = BC_AllocatorAllocAligned(kBC_AllocatorRefSystem, size + PRIV_CACHE_LARGE_HEADER_SIZE, PRIV_CACHE_ALIGNMENT);
+		if (!base) return NULL;
+		char* ptr = base + PRIV_CACHE_LARGE_HEADER_SIZE;
+		((PRIV_CacheBlock*)(ptr - PRIV_CACHE_HEADER_SIZE))->page = NULL;
+		return ptr;
+	}
+
+	PRIV_CacheHeap* heap = gCacheHeap;
+	if (!heap && !(heap = PRIV_CacheHeapAcquire())) return NULL;
+
+	const size_t classIndex = INTERNAL_BC_SlabClassIndex(blockSize);
+	PRIV_CacheClass* sizeClass = &heap->classes[classIndex];
+
+	PRIV_CacheBlock* block = sizeClass->freeList;
+	if (!block && PRIV_CacheHeapDrainRemote(heap)) {
+		block = sizeClass->freeList;
+	}
+
+	if (block) {
+		sizeClass->freeList = block->next;
+		return (char*)block + PRIV_CACHE_HEADER_SIZE;
+	}
+
+	const size_t classSize = INTERNAL_BC_SlabClassSize(classIndex);
+	if (!sizeClass->cursor || sizeClass->cursor + classSize > sizeClass->end) {
+		if (!PRIV_CacheHeapGrow(heap, classIndex)) return NULL;
+	}
+
+	block = (PRIV_CacheBlock*)sizeClass->cursor;
+	sizeClass->cursor += classSize;
+	block->page = sizeClass->page;
+	return (char*)block + PRIV_CACHE_HEADER_SIZE;
+}
+
+static void IMPL_ThreadCacheFree(void* ptr, const void* ctx) {
+	(void)ctx;
+	if (!ptr) return;
+
+	PRIV_CacheBlock* block = (PRIV_CacheBlock*)((char*)ptr - PRIV_CACHE_HEADER_SIZE);
+	PRIV_CachePage* page = block->page;
+
+	if (!page) {
+		BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, (char*)ptr - PRIV_CACHE_LARGE_HEADER_SIZE);
+		return;
+	}
+
+	PRIV_CacheHeap* owner = page->owner;
+	if (owner == gCacheHeap) {
+		PRIV_CacheClass* sizeClass = &owner->classes[page->classIndex];
+		block->next = sizeClass->freeList;
+		sizeClass->freeList = block;
+		return;
+	}
+
+	// Remote free, the owner only ever takes the whole list so a plain CAS push is ABA free
+	PRIV_CacheBlock* head = BC_atomic_load_relaxed(&owner->remoteFree);
+	do {
+		block->next = head;
+	} while (!BC_atomic_compare_exchange(&owner->remoteFree, (void**)&head, block));
+}
+
+static void IMPL_ThreadCacheFreeSized(void* ptr, const size_t size, const void* ctx) {
+	// Cached blocks find their class through the page, large blocks go back to the system aligned
+	(void)size;
+	IMPL_ThreadCacheFree(ptr, ctx);
+}
+
+static void* IMPL_ThreadCacheRealloc(void* ptr, const size_t oldSize, const size_t newSize, const void* ctx) {
+	const PRIV_CachePage* page = ((PRIV_CacheBlock*)((char*)ptr - PRIV_CACHE_HEADER_SIZE))->page;
+
+	// Stay in place while the new size still fits the block size class
+	if (page && newSize > 0 && newSize + PRIV_CACHE_HEADER_SIZE <= INTERNAL_BC_SlabClassSize(page->classIndex)) {
+		return ptr;
+	}
+
+	void* newPtr = IMPL_ThreadCacheAlloc(newSize, ctx);
+	if (!newPtr) return NULL;
+	memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+	IMPL_ThreadCacheFree(ptr, ctx);
+	return newPtr;
+}
+
+// =========================================================
+// MARK: Shared Thread Cache
+// =========================================================
+
+static BC_Allocator const PRIV_kAllocatorThreadCache = {IMPL_ThreadCacheAlloc, IMPL_ThreadCacheFree, NULL, NULL, IMPL_ThreadCacheRealloc, IMPL_ThreadCacheFreeSized};
+const BC_AllocatorRef kBC_AllocatorRefThreadCache = (BC_AllocatorRef)&PRIV_kAllocatorThreadCache;
+
+void INTERNAL_BC_ThreadCacheDeinitialize(void) {
+	// Only safe once no other thread allocates anymore
+	BC_RunOnce(&gCacheOnce, PRIV_CacheSetup);
+	BC_MutexLock(&gCacheMutex);
+	PRIV_CacheHeap* heap = gCacheHeaps;
+	while (heap) {
+		PRIV_CacheHeap* next = heap->next;
+		PRIV_CacheHeapDestroy(heap);
+		heap = next;
+	}
+	gCacheHeaps = NULL;
+	gCacheHeapCount = 0;
+	gCacheHeap = NULL;
+	BC_MutexUnlock(&gCacheMutex);
+	PRIV_CacheHeapKeySet(NULL);
+}
+
+size_t BC_ThreadCacheHeapCount(void) {
+	BC_RunOnce(&gCacheOnce, PRIV_CacheSetup);
+	BC_MutexLock(&gCacheMutex);
+	const size_t count = gCacheHeapCount;
+	BC_MutexUnlock(&gCacheMutex);
+	return count;
+}
@@ -0,0 +1,27 @@
+#ifndef BCORE_THREAD_CACHE_H
+#define BCORE_THREAD_CACHE_H
+
+#include "BC_Allocator.h"
+#include "../BC_Macro.h"
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Size of each page a thread carves into blocks of one size class
+#define BC_THREAD_CACHE_PAGE_SIZE BC_KB(64)
+
+// =========================================================
+// MARK: Thread Cache
+// =========================================================
+
+// Process wide allocator with one heap per thread for blocks up to BC_SLAB_MAX_BLOCK_SIZE.
+// Allocating and freeing on the owning thread takes no lock and no atomic operation, blocks
+// freed on another thread are pushed to the owner's remote queue and reclaimed on its next
+// allocation. Heaps of exited threads, with their live blocks, are adopted by new threads.
+extern const BC_AllocatorRef kBC_AllocatorRefThreadCache;
+
+// Number of heaps created so far, one per concurrently running thread that allocated
+size_t BC_ThreadCacheHeapCount(void);
+
+#endif //BCORE_THREAD_CACHE_H
@@ -0,0 +1,197 @@
+#include "BC_VirtualMemory.h"
+
+#include "BC_Memory.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// =========================================================
+// MARK: Virtual Memory
+// =========================================================
+
+size_t BC_VirtualPageSize(void) {
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwPageSize;
+#else
+	return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+void* BC_VirtualReserve(const size_t size) {
+#if defined(_WIN32)
+	void* ptr = VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+	if (!ptr) {
+		fprintf(stderr, "BC_VirtualReserve: Failed to reserve %zu bytes\n", size);
+		return NULL;
+	}
+#else
+	// No access and no swap reservation until pages are committed
+	void* ptr = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (ptr == MAP_FAILED) {
+		fprintf(stderr, "BC_VirtualReserve: Failed to reserve %zu bytes\n", size);
+		return NULL;
+	}
+#endif
+	return ptr;
+}
+
+void* BC_VirtualReserveAligned(size_t size, const size_t alignment) {
+	const size_t pageSize = BC_VirtualPageSize();
+	if (alignment <= pageSize) return BC_VirtualReserve(size);
+
+	// Whole pages, the tail unmapped below must start on a page boundary
+	size = (size + pageSize - 1) & ~(pageSize - 1);
+
+#if defined(_WIN32)
+	// Reserve a larger range to find an aligned address, then retry at that address until no other thread took it
+	for (int attempt = 0; attempt < 8; attempt++) {
+		void* probe = VirtualAlloc(NULL, size + alignment, MEM_RESERVE, PAGE_NOACCESS);
+		if (!probe) break;
+		VirtualFree(probe, 0, MEM_RELEASE);
+
+		void* aligned = (void*)(((uintptr_t)probe + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		void* ptr = VirtualAlloc(aligned, size, MEM_RESERVE, PAGE_NOACCESS);
+		if (ptr) return ptr;
+	}
+	fprintf(stderr, "BC_VirtualReserveAligned: Failed to reserve %zu bytes\n", size);
+	return NULL;
+#else
+	// Over-reserve and unmap the unaligned head and the tail
+	char* raw = BC_VirtualReserve(size + alignment);
+	if (!raw) return NULL;
+
+	char* aligned = (char*)(((uintptr_t)raw + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	const size_t head = (size_t)(aligned - raw);
+	if (head > 0) munmap(raw, head);
+	if (alignment - head > 0) munmap(raw + head + size, alignment - head);
+	return aligned;
+#endif
+}
+
+BC_bool BC_VirtualCommit(void* ptr, const size_t size) {
+#if defined(_WIN32)
+	return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+	return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void BC_VirtualDecommit(void* ptr, const size_t size) {
+#if defined(_WIN32)
+	VirtualFree(ptr, size, MEM_DECOMMIT);
+#else
+	// MADV_DONTNEED drops the pages right away, unlike MADV_FREE which leaves them in RSS until memory pressure
+	madvise(ptr, size, MADV_DONTNEED);
+	mprotect(ptr, size, PROT_NONE);
+#endif
+}
+
+void BC_VirtualRelease(void* ptr, const size_t size) {
+	if (!ptr) return;
+#if defined(_WIN32)
+	(void)size;
+	VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+	munmap(ptr, size);
+#endif
+}
+
+void BC_VirtualAdviseHugePages(void* ptr, const size_t size) {
+#if defined(MADV_HUGEPAGE)
+	madvise(ptr, size, MADV_HUGEPAGE);
+#else
+	(void)ptr;
+	(void)size;
+#endif
+}
+
+// =========================================================
+// MARK: Huge Page Allocator
+// =========================================================
+
+// Stored right before every block, `mappedSize` is 0 for blocks from BC_Malloc
+typedef struct PRIV_HugeHeader {
+	void* base;
+	size_t mappedSize;
+} PRIV_HugeHeader;
+
+static void* IMPL_HugePagesAllocAligned(const size_t size, size_t alignment, const void* ctx) {
+	(void)ctx;
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+		fprintf(stderr, "BC_AllocatorHugePages: Alignment %zu is not a power of two\n", alignment);
+		return NULL;
+	}
+	if (alignment < sizeof(PRIV_HugeHeader)) alignment = sizeof(PRIV_HugeHeader);
+
+	if (size < BC_VIRTUAL_HUGE_PAGE_THRESHOLD) {
+		char* base = BC_Calloc(1, size + alignment + sizeof(PRIV_HugeHeader));
+		if (!base) return NULL;
+		PRIV_HugeHeader* block = (PRIV_HugeHeader*)(((uintptr_t)base + sizeof(PRIV_HugeHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		block[-1] = (PRIV_HugeHeader){base, 0};
+		return block;
+	}
+
+	// The header takes the first `alignment` bytes so the block itself keeps the requested alignment
+	const size_t pageSize = BC_VirtualPageSize();
+	const size_t mappedSize = (size + alignment + pageSize - 1) & ~(pageSize - 1);
+	char* base = BC_VirtualReserveAligned(mappedSize, alignment > BC_VIRTUAL_HUGE_PAGE_SIZE ? alignment : BC_VIRTUAL_HUGE_PAGE_SIZE);
+	if (!base) return NULL;
+
+	if (!BC_VirtualCommit(base, mappedSize)) {
+		fprintf(stderr, "BC_AllocatorHugePages: Failed to commit %zu bytes\n", mappedSize);
+		BC_VirtualRelease(base, mappedSize);
+		return NULL;
+	}
+	BC_VirtualAdviseHugePages(base, mappedSize);
+
+	PRIV_HugeHeader* block = (PRIV_HugeHeader*)(base + alignment);
+	block[-1] = (PRIV_HugeHeader){base, mappedSize};
+	return block;
+}
+
+static void* IMPL_HugePagesAlloc(const size_t size, const void* ctx) {
+	return IMPL_HugePagesAllocAligned(size, sizeof(PRIV_HugeHeader), ctx);
+}
+
+static void IMPL_HugePagesFree(void* ptr, const void* ctx) {
+	(void)ctx;
+	if (!ptr) return;
+
+	const PRIV_HugeHeader header = ((PRIV_HugeHeader*)ptr)[-1];
+	if (header.mappedSize) {
+		BC_VirtualRelease(header.base, header.mappedSize);
+	} else {
+		BC_Free(header.base);
+	}
+}
+
+static BC_Allocator const PRIV_kAllocatorHugePages = {IMPL_HugePagesAlloc, IMPL_HugePagesFree, NULL, IMPL_HugePagesAllocAligned, NULL, NULL};
+const BC_AllocatorRef kBC_AllocatorRefHugePages = (BC_AllocatorRef)&PRIV_kAllocatorHugePages;
+
+void* BC_HugePagesArrayAlloc(const size_t count, const size_t elementSize) {
+	if (elementSize && count > SIZE_MAX / elementSize) {
+		fprintf(stderr, "BC_HugePagesArrayAlloc: %zu elements of %zu bytes overflow\n", count, elementSize);
+		return NULL;
+	}
+	const size_t size = count * elementSize;
+	return size < BC_VIRTUAL_HUGE_PAGE_THRESHOLD ? BC_Calloc(count, elementSize) : IMPL_HugePagesAlloc(size, NULL);
+}
+
+void BC_HugePagesArrayFree(void* ptr, const size_t count, const size_t elementSize) {
+	const size_t size = count * elementSize;
+	if (size < BC_VIRTUAL_HUGE_PAGE_THRESHOLD) {
+		BC_FreeSized(ptr, size);
+	} else {
+		IMPL_HugePagesFree(ptr, NULL);
+	}
+}
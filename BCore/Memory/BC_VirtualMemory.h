@@ -0,0 +1,61 @@
+#ifndef BCORE_VIRTUAL_MEMORY_H
+#define BCORE_VIRTUAL_MEMORY_H
+
+#include "BC_Allocator.h"
+#include "../BC_Macro.h"
+#include "../BC_Types.h"
+
+#include <stddef.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Transparent huge page size on x86_64 and most aarch64 kernels
+#define BC_VIRTUAL_HUGE_PAGE_SIZE BC_MB(2)
+
+// Smallest block kBC_AllocatorRefHugePages maps on its own, smaller ones come from BC_Malloc
+#define BC_VIRTUAL_HUGE_PAGE_THRESHOLD BC_MB(2)
+
+// =========================================================
+// MARK: Virtual Memory
+// =========================================================
+
+// Granularity of every call below, sizes and addresses are rounded to it
+size_t BC_VirtualPageSize(void);
+
+// Reserves address space without backing it, returns NULL on failure
+void* BC_VirtualReserve(size_t size);
+
+// Same as BC_VirtualReserve with the start of the range aligned to `alignment`, a power of two
+void* BC_VirtualReserveAligned(size_t size, size_t alignment);
+
+// Backs reserved pages with zeroed memory, they are only paid for once touched
+BC_bool BC_VirtualCommit(void* ptr, size_t size);
+
+// Returns the pages to the OS, the range stays reserved and can be committed again
+void BC_VirtualDecommit(void* ptr, size_t size);
+
+// Releases the whole range returned by BC_VirtualReserve
+void BC_VirtualRelease(void* ptr, size_t size);
+
+// Asks the kernel to back the range with transparent huge pages (MADV_HUGEPAGE), only aligned
+// 2MB extents qualify. No-op where transparent huge pages are not available.
+void BC_VirtualAdviseHugePages(void* ptr, size_t size);
+
+// =========================================================
+// MARK: Huge Page Allocator
+// =========================================================
+
+// Maps blocks of BC_VIRTUAL_HUGE_PAGE_THRESHOLD bytes or more 2MB aligned with huge pages advised,
+// meant for large tables and buffers where TLB misses dominate. Smaller blocks fall back to BC_Calloc.
+// Memory is always returned zeroed.
+extern const BC_AllocatorRef kBC_AllocatorRefHugePages;
+
+// Zeroed array for tables that grow large, mapped with huge pages once it reaches
+// BC_VIRTUAL_HUGE_PAGE_THRESHOLD bytes and a plain BC_Calloc block below, without any header.
+// Freeing needs the same count and element size, they pick the path the array came from.
+void* BC_HugePagesArrayAlloc(size_t count, size_t elementSize);
+void BC_HugePagesArrayFree(void* ptr, size_t count, size_t elementSize);
+
+#endif //BCORE_VIRTUAL_MEMORY_H
@@ -5,37 +5,138 @@
 #include <stdint.h>
 
 #include "../BC_Settings.h"
+#include "../BC_Types.h"
 
 #if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
 
 #include <stdatomic.h>
 
-#include "../BC_Types.h"
-
 typedef _Atomic(BC_bool) BC_atomic_bool;
 typedef _Atomic(uint8_t) BC_atomic_uint8;
 typedef _Atomic(uint16_t) BC_atomic_uint16;
+typedef _Atomic(uint32_t) BC_atomic_uint32;
+typedef _Atomic(uint64_t) BC_atomic_uint64;
+typedef _Atomic(int32_t) BC_atomic_int32;
+typedef _Atomic(int64_t) BC_atomic_int64;
 typedef atomic_uint_fast32_t BC_atomic_uint_fast32;
 typedef atomic_size_t BC_atomic_size;
+typedef atomic_uintptr_t BC_atomic_uintptr;
+typedef _Atomic(void*) BC_atomic_ptr;
+
+// Typed atomic pointer, BC_ATOMIC_PTR(BO_Object) next;
+#define BC_ATOMIC_PTR(TYPE) _Atomic(TYPE*)
+
+// =========================================================
+// MARK: Memory Orders
+// =========================================================
+
+typedef memory_order BC_memory_order;
+#define BC_memory_order_relaxed memory_order_relaxed
+#define BC_memory_order_acquire memory_order_acquire
+#define BC_memory_order_release memory_order_release
+#define BC_memory_order_acq_rel memory_order_acq_rel
+#define BC_memory_order_seq_cst memory_order_seq_cst
+
+// =========================================================
+// MARK: Explicit Order
+// =========================================================
+
+#define BC_atomic_load_explicit(PTR, ORDER) atomic_load_explicit(PTR, ORDER)
+#define BC_atomic_store_explicit(PTR, VAL, ORDER) atomic_store_explicit(PTR, VAL, ORDER)
+#define BC_atomic_fetch_add_explicit(PTR, VAL, ORDER) atomic_fetch_add_explicit(PTR, VAL, ORDER)
+#define BC_atomic_fetch_sub_explicit(PTR, VAL, ORDER) atomic_fetch_sub_explicit(PTR, VAL, ORDER)
+#define BC_atomic_fetch_and_explicit(PTR, VAL, ORDER) atomic_fetch_and_explicit(PTR, VAL, ORDER)
+#define BC_atomic_fetch_or_explicit(PTR, VAL, ORDER) atomic_fetch_or_explicit(PTR, VAL, ORDER)
+#define BC_atomic_exchange_explicit(PTR, VAL, ORDER) atomic_exchange_explicit(PTR, VAL, ORDER)
+// On failure *EXPECTED_PTR receives the current value. The weak form may fail spuriously and
+// belongs in a retry loop, where it is cheaper on LL/SC machines.
+#define BC_atomic_compare_exchange_explicit(PTR, EXPECTED_PTR, VAL, SUCCESS, FAILURE) \
+	atomic_compare_exchange_strong_explicit(PTR, EXPECTED_PTR, VAL, SUCCESS, FAILURE)
+#define BC_atomic_compare_exchange_weak_explicit(PTR, EXPECTED_PTR, VAL, SUCCESS, FAILURE) \
+	atomic_compare_exchange_weak_explicit(PTR, EXPECTED_PTR, VAL, SUCCESS, FAILURE)
+#define BC_atomic_fence(ORDER) atomic_thread_fence(ORDER)
+
+// =========================================================
+// MARK: Shorthands
+// =========================================================
 
 #define BC_atomic_fetch_add(PTR, VAL) atomic_fetch_add(PTR, VAL)
 #define BC_atomic_fetch_sub(PTR, VAL) atomic_fetch_sub(PTR, VAL)
+#define BC_atomic_fetch_and(PTR, VAL) atomic_fetch_and(PTR, VAL)
+#define BC_atomic_fetch_or(PTR, VAL) atomic_fetch_or(PTR, VAL)
 #define BC_atomic_load(PTR) atomic_load(PTR)
 #define BC_atomic_store(PTR, VAL) atomic_store(PTR, VAL)
+#define BC_atomic_compare_exchange(PTR, EXPECTED_PTR, VAL) atomic_compare_exchange_strong(PTR, EXPECTED_PTR, VAL)
+#define BC_atomic_compare_exchange_weak(PTR, EXPECTED_PTR, VAL) atomic_compare_exchange_weak(PTR, EXPECTED_PTR, VAL)
+#define BC_atomic_exchange(PTR, VAL) atomic_exchange(PTR, VAL)
 
 #else
 
 typedef BC_bool BC_atomic_bool;
 typedef uint8_t BC_atomic_uint8;
 typedef uint16_t BC_atomic_uint16;
+typedef uint32_t BC_atomic_uint32;
+typedef uint64_t BC_atomic_uint64;
+typedef int32_t BC_atomic_int32;
+typedef int64_t BC_atomic_int64;
 typedef uint_fast32_t BC_atomic_uint_fast32;
 typedef size_t BC_atomic_size;
+typedef uintptr_t BC_atomic_uintptr;
+typedef void* BC_atomic_ptr;
+
+#define BC_ATOMIC_PTR(TYPE) TYPE*
+
+// =========================================================
+// MARK: Memory Orders
+// =========================================================
+
+// Single threaded, orders are accepted and ignored
+typedef enum {
+	BC_memory_order_relaxed,
+	BC_memory_order_acquire,
+	BC_memory_order_release,
+	BC_memory_order_acq_rel,
+	BC_memory_order_seq_cst
+} BC_memory_order;
 
-#define BC_atomic_fetch_add(PTR, VAL) ({ int ____atomic_old = *(PTR); *(PTR) += (VAL); ____atomic_old; })
-#define BC_atomic_fetch_sub(PTR, VAL) ({ int ____atomic_old = *(PTR); *(PTR) -= (VAL); ____atomic_old; })
+// =========================================================
+// MARK: Explicit Order
+// =========================================================
+
+// Old values keep the operand type, so size_t and 64 bit counters are not truncated
+#define BC_atomic_load_explicit(PTR, ORDER) ((void)(ORDER), *(PTR))
+#define BC_atomic_store_explicit(PTR, VAL, ORDER) ((void)(ORDER), *(PTR) = (VAL))
+#define BC_atomic_fetch_add_explicit(PTR, VAL, ORDER) ({ (void)(ORDER); __typeof__(*(PTR)) ____atomic_old = *(PTR); *(PTR) += (VAL); ____atomic_old; })
+#define BC_atomic_fetch_sub_explicit(PTR, VAL, ORDER) ({ (void)(ORDER); __typeof__(*(PTR)) ____atomic_old = *(PTR); *(PTR) -= (VAL); ____atomic_old; })
+#define BC_atomic_fetch_and_explicit(PTR, VAL, ORDER) ({ (void)(ORDER); __typeof__(*(PTR)) ____atomic_old = *(PTR); *(PTR) &= (VAL); ____atomic_old; })
+#define BC_atomic_fetch_or_explicit(PTR, VAL, ORDER) ({ (void)(ORDER); __typeof__(*(PTR)) ____atomic_old = *(PTR); *(PTR) |= (VAL); ____atomic_old; })
+#define BC_atomic_exchange_explicit(PTR, VAL, ORDER) ({ (void)(ORDER); __typeof__(*(PTR)) ____atomic_old = *(PTR); *(PTR) = (VAL); ____atomic_old; })
+#define BC_atomic_compare_exchange_explicit(PTR, EXPECTED_PTR, VAL, SUCCESS, FAILURE) ({ (void)(SUCCESS); (void)(FAILURE); BC_bool ____atomic_ok = *(PTR) == *(EXPECTED_PTR); if (____atomic_ok) *(PTR) = (VAL); else *(EXPECTED_PTR) = *(PTR); ____atomic_ok; })
+#define BC_atomic_compare_exchange_weak_explicit(PTR, EXPECTED_PTR, VAL, SUCCESS, FAILURE) BC_atomic_compare_exchange_explicit(PTR, EXPECTED_PTR, VAL, SUCCESS, FAILURE)
+#define BC_atomic_fence(ORDER) ((void)(ORDER))
+
+// =========================================================
+// MARK: Shorthands
+// =========================================================
+
+#define BC_atomic_fetch_add(PTR, VAL) BC_atomic_fetch_add_explicit(PTR, VAL, BC_memory_order_seq_cst)
+#define BC_atomic_fetch_sub(PTR, VAL) BC_atomic_fetch_sub_explicit(PTR, VAL, BC_memory_order_seq_cst)
+#define BC_atomic_fetch_and(PTR, VAL) BC_atomic_fetch_and_explicit(PTR, VAL, BC_memory_order_seq_cst)
+#define BC_atomic_fetch_or(PTR, VAL) BC_atomic_fetch_or_explicit(PTR, VAL, BC_memory_order_seq_cst)
 #define BC_atomic_load(PTR) (*(PTR))
 #define BC_atomic_store(PTR, VAL) (*(PTR) = (VAL))
+#define BC_atomic_compare_exchange(PTR, EXPECTED_PTR, VAL) BC_atomic_compare_exchange_explicit(PTR, EXPECTED_PTR, VAL, BC_memory_order_seq_cst, BC_memory_order_seq_cst)
+#define BC_atomic_compare_exchange_weak(PTR, EXPECTED_PTR, VAL) BC_atomic_compare_exchange(PTR, EXPECTED_PTR, VAL)
+#define BC_atomic_exchange(PTR, VAL) BC_atomic_exchange_explicit(PTR, VAL, BC_memory_order_seq_cst)
 
 #endif
 
-#endif //BCORE_ATOMICS_H
\ No newline at end of file
+// Ordered shorthands shared by both builds
+#define BC_atomic_load_relaxed(PTR) BC_atomic_load_explicit(PTR, BC_memory_order_relaxed)
+#define BC_atomic_store_relaxed(PTR, VAL) BC_atomic_store_explicit(PTR, VAL, BC_memory_order_relaxed)
+#define BC_atomic_load_acquire(PTR) BC_atomic_load_explicit(PTR, BC_memory_order_acquire)
+#define BC_atomic_store_release(PTR, VAL) BC_atomic_store_explicit(PTR, VAL, BC_memory_order_release)
+#define BC_atomic_fence_acquire() BC_atomic_fence(BC_memory_order_acquire)
+#define BC_atomic_fence_release() BC_atomic_fence(BC_memory_order_release)
+
+#endif //BCORE_ATOMICS_H
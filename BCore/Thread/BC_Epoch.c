@@ -0,0 +1,292 @@
+#include "BC_Epoch.h"
+
+#include "BC_Atomics.h"
+#include "BC_Threads.h"
+#include "../BC_Keywords.h"
+#include "../Memory/BC_Allocator.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// =========================================================
+// MARK: Structures
+// =========================================================
+
+// A pointer is retired into the bucket of the epoch it was retired in. The epoch cannot move
+// more than one step past the oldest active reader, so a bucket is safe two epochs later and
+// the three buckets are reused round robin.
+#define PRIV_EPOCH_BUCKETS 3
+
+typedef struct PRIV_EpochRetired {
+	struct PRIV_EpochRetired* next;
+	void* pointer;
+	BC_EpochReclaimFunc reclaim;
+	void* context;
+} PRIV_EpochRetired;
+
+typedef struct PRIV_EpochBucket {
+	PRIV_EpochRetired* head;
+	size_t epoch;
+} PRIV_EpochBucket;
+
+typedef struct PRIV_EpochRecord {
+	// Read by every collecting thread, kept on its own cache line
+	_Alignas(BC_CACHE_LINE_SIZE) BC_atomic_size announced;  // Epoch << 1 | 1 inside a section, 0 outside
+	_Alignas(BC_CACHE_LINE_SIZE) size_t nesting;
+	size_t retiredCount;
+	PRIV_EpochBucket buckets[PRIV_EPOCH_BUCKETS];
+	BC_bool inUse;                   // Guarded by gEpochMutex
+	struct PRIV_EpochRecord* next;   // Never changes once published
+} PRIV_EpochRecord;
+
+static BC_atomic_size gEpochGlobal = 1;
+static BC_atomic_size gEpochPending = 0;
+static BC_ATOMIC_PTR(PRIV_EpochRecord) gEpochRecords = NULL;
+BC_MUTEX_MAYBE(gEpochMutex)
+BC_ONCE_MAYBE_STATIC(gEpochOnce)
+
+static BC_TLS PRIV_EpochRecord* gEpochRecord = NULL;
+
+// =========================================================
+// MARK: Records
+// =========================================================
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+#if defined(_WIN32)
+static DWORD gEpochRecordKey;
+#define PRIV_EpochRecordKeySet(_record_) FlsSetValue(gEpochRecordKey, _record_)
+#else
+static pthread_key_t gEpochRecordKey;
+#define PRIV_EpochRecordKeySet(_record_) pthread_setspecific(gEpochRecordKey, _record_)
+#endif
+
+// Called on thread exit, pointers still retired in the record wait for the thread adopting it
+static void
+#if defined(_WIN32)
+WINAPI
+#endif
+PRIV_EpochRecordRelease(void* ptr) {
+	PRIV_EpochRecord* record = ptr;
+	if (!record) return;
+	gEpochRecord = NULL;
+	BC_MutexLock(&gEpochMutex);
+	record->inUse = BC_false;
+	BC_MutexUnlock(&gEpochMutex);
+}
+
+static void PRIV_EpochSetup(void) {
+	BC_MutexInit(&gEpochMutex);
+#if defined(_WIN32)
+	gEpochRecordKey = FlsAlloc(PRIV_EpochRecordRelease);
+#else
+	pthread_key_create(&gEpochRecordKey, PRIV_EpochRecordRelease);
+#endif
+}
+
+#else
+
+#define PRIV_EpochRecordKeySet(_record_)
+static void PRIV_EpochSetup(void) {}
+
+#endif
+
+// Slow path, runs once per thread
+static PRIV_EpochRecord* PRIV_EpochRecordAcquire(void) {
+	BC_RunOnce(&gEpochOnce, PRIV_EpochSetup);
+
+	BC_MutexLock(&gEpochMutex);
+	PRIV_EpochRecord* record = BC_atomic_load_acquire(&gEpochRecords);
+	while (record && record->inUse) record = record->next;
+
+	if (!record) {
+		record = BC_AllocatorAllocAligned(kBC_AllocatorRefSystem, sizeof(PRIV_EpochRecord), BC_CACHE_LINE_SIZE);
+		if (!record) {
+			BC_MutexUnlock(&gEpochMutex);
+			fprintf(stderr, "BC_Epoch: Failed to allocate thread record\n");
+			return NULL;
+		}
+		memset(record, 0, sizeof(PRIV_EpochRecord));
+		BC_atomic_store_relaxed(&record->announced, 0);
+		// Collectors walk the list without the mutex, the record is complete before it is linked
+		record->next = BC_atomic_load_relaxed(&gEpochRecords);
+		BC_atomic_store_release(&gEpochRecords, record);
+	}
+	record->inUse = BC_true;
+	BC_MutexUnlock(&gEpochMutex);
+
+	PRIV_EpochRecordKeySet(record);
+	gEpochRecord = record;
+	return record;
+}
+
+static PRIV_EpochRecord* PRIV_EpochRecordCurrent(void) {
+	PRIV_EpochRecord* record = gEpochRecord;
+	return record ? record : PRIV_EpochRecordAcquire();
+}
+
+// =========================================================
+// MARK: Private
+// =========================================================
+
+static void PRIV_EpochBucketReclaim(PRIV_EpochRecord* record, PRIV_EpochBucket* bucket) {
+	PRIV_EpochRetired* retired = bucket->head;
+	bucket->head = NULL;
+
+	size_t count = 0;
+	while (retired) {
+		PRIV_EpochRetired* next = retired->next;
+		retired->reclaim(retired->pointer, retired->context);
+		BC_AllocatorFree(kBC_AllocatorRefSystem, retired);
+		retired = next;
+		count++;
+	}
+	record->retiredCount -= count;
+	BC_atomic_fetch_sub(&gEpochPending, count);
+}
+
+// Moves the global epoch one step when every reader inside a section has seen the current one
+static BC_bool PRIV_EpochTryAdvance(void) {
+	size_t epoch = BC_atomic_load(&gEpochGlobal);
+	const size_t current = epoch << 1 | 1;
+
+	PRIV_EpochRecord* record = BC_atomic_load_acquire(&gEpochRecords);
+	while (record) {
+		// Acquire pairs with the release in BC_EpochExit, the reader's accesses happen before
+		// anything reclaimed because of this load
+		const size_t announced = BC_atomic_load_acquire(&record->announced);
+		if (announced != 0 && announced != current) return BC_false;
+		record = record->next;
+	}
+
+	// Losing the exchange means another thread advanced it already
+	BC_atomic_compare_exchange(&gEpochGlobal, &epoch, epoch + 1);
+	return BC_true;
+}
+
+static void PRIV_EpochReclaimSafe(PRIV_EpochRecord* record) {
+	const size_t epoch = BC_atomic_load(&gEpochGlobal);
+	for (int i = 0; i < PRIV_EPOCH_BUCKETS; i++) {
+		PRIV_EpochBucket* bucket = &record->buckets[i];
+		if (bucket->head && bucket->epoch + 2 <= epoch) {
+			PRIV_EpochBucketReclaim(record, bucket);
+		}
+	}
+}
+
+// =========================================================
+// MARK: Public
+// =========================================================
+
+void BC_EpochEnter(void) {
+	PRIV_EpochRecord* record = PRIV_EpochRecordCurrent();
+	if (!record) return;
+	if (record->nesting++ > 0) return;
+
+	// Sequentially consistent so the announcement is visible before the section reads anything
+	const size_t epoch = BC_atomic_load(&gEpochGlobal);
+	BC_atomic_store(&record->announced, epoch << 1 | 1);
+	BC_atomic_fence(BC_memory_order_seq_cst);
+}
+
+void BC_EpochExit(void) {
+	PRIV_EpochRecord* record = gEpochRecord;
+	if (!record || record->nesting == 0) {
+		fprintf(stderr, "BC_EpochExit: Not inside a critical section\n");
+		return;
+	}
+	if (--record->nesting > 0) return;
+
+	BC_atomic_store_release(&record->announced, 0);
+}
+
+void BC_EpochRetire(void* pointer, const BC_EpochReclaimFunc reclaim, void* context) {
+	if (!pointer || !reclaim) return;
+
+	PRIV_EpochRecord* record = PRIV_EpochRecordCurrent();
+	PRIV_EpochRetired* retired = record ? BC_AllocatorAlloc(kBC_AllocatorRefSystem, sizeof(PRIV_EpochRetired)) : NULL;
+	if (!retired) {
+		fprintf(stderr, "BC_EpochRetire: Failed to retire %p, it is leaked\n", pointer);
+		return;
+	}
+
+	const size_t epoch = BC_atomic_load(&gEpochGlobal);
+	PRIV_EpochBucket* bucket = &record->buckets[epoch % PRIV_EPOCH_BUCKETS];
+
+	// Anything still in the bucket is from three or more epochs ago, already safe
+	if (bucket->head && bucket->epoch != epoch) {
+		PRIV_EpochBucketReclaim(record, bucket);
+	}
+
+	retired->pointer = pointer;
+	retired->reclaim = reclaim;
+	retired->context = context;
+	retired->next = bucket->head;
+	bucket->head = retired;
+	bucket->epoch = epoch;
+	record->retiredCount++;
+	BC_atomic_fetch_add(&gEpochPending, 1);
+
+	if (record->retiredCount >= BC_EPOCH_COLLECT_THRESHOLD) {
+		BC_EpochCollect();
+	}
+}
+
+void BC_EpochReclaimFree(void* pointer, void* allocator) {
+	BC_AllocatorFree((BC_AllocatorRef)allocator, pointer);
+}
+
+void BC_EpochCollect(void) {
+	PRIV_EpochRecord* record = PRIV_EpochRecordCurrent();
+	if (!record) return;
+
+	PRIV_EpochTryAdvance();
+	PRIV_EpochReclaimSafe(record);
+}
+
+void BC_EpochSynchronize(void) {
+	PRIV_EpochRecord* record = PRIV_EpochRecordCurrent();
+	if (!record) return;
+	if (record->nesting > 0) {
+		fprintf(stderr, "BC_EpochSynchronize: Called inside a critical section\n");
+		return;
+	}
+
+	// Two steps past the current epoch every bucket of this thread is safe
+	const size_t target = BC_atomic_load(&gEpochGlobal) + 2;
+	while (BC_atomic_load(&gEpochGlobal) < target) {
+		if (!PRIV_EpochTryAdvance()) BC_ThreadYield();
+	}
+
+	for (int i = 0; i < PRIV_EPOCH_BUCKETS; i++) {
+		if (record->buckets[i].head) PRIV_EpochBucketReclaim(record, &record->buckets[i]);
+	}
+}
+
+size_t BC_EpochPendingCount(void) {
+	return BC_atomic_load(&gEpochPending);
+}
+
+// =========================================================
+// MARK: Internal
+// =========================================================
+
+void INTERNAL_BC_EpochDeinitialize(void) {
+	// Only safe once no other thread reads or retires anymore
+	BC_RunOnce(&gEpochOnce, PRIV_EpochSetup);
+	BC_MutexLock(&gEpochMutex);
+	PRIV_EpochRecord* record = BC_atomic_load_acquire(&gEpochRecords);
+	while (record) {
+		PRIV_EpochRecord* next = record->next;
+		for (int i = 0; i < PRIV_EPOCH_BUCKETS; i++) {
+			if (record->buckets[i].head) PRIV_EpochBucketReclaim(record, &record->buckets[i]);
+		}
+		BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, record);
+		record = next;
+	}
+	BC_atomic_store(&gEpochRecords, NULL);
+	gEpochRecord = NULL;
+	BC_MutexUnlock(&gEpochMutex);
+	PRIV_EpochRecordKeySet(NULL);
+}
@@ -0,0 +1,53 @@
+#ifndef BCORE_EPOCH_H
+#define BCORE_EPOCH_H
+
+#include "../BC_Types.h"
+
+#include <stddef.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Retired pointers a thread accumulates before it tries to advance the epoch on its own
+#define BC_EPOCH_COLLECT_THRESHOLD 64
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef void (*BC_EpochReclaimFunc)(void* pointer, void* context);
+
+// =========================================================
+// MARK: Epoch Reclamation
+// =========================================================
+
+// Process wide epoch based reclamation for lock free structures. Readers wrap every access
+// in BC_EpochEnter / BC_EpochExit, which only publish the epoch they run in. Writers unlink a
+// node first and then hand it to BC_EpochRetire, it is reclaimed once every thread that was
+// inside a critical section at that time has left it. A thread stalled inside a critical
+// section holds back reclamation for everyone, keep sections short and never block in one.
+
+// Sections nest, only the outermost pair publishes anything
+void BC_EpochEnter(void);
+void BC_EpochExit(void);
+
+// Calls `reclaim(pointer, context)` once no reader can still reach `pointer`, on the thread
+// that retired it. Safe inside a critical section.
+void BC_EpochRetire(void* pointer, BC_EpochReclaimFunc reclaim, void* context);
+
+// Reclaim function freeing `pointer` with the allocator passed as context, NULL for system
+void BC_EpochReclaimFree(void* pointer, void* allocator);
+
+// Tries to advance the epoch and reclaims what the calling thread retired and is now safe.
+// BC_EpochRetire calls it every BC_EPOCH_COLLECT_THRESHOLD pointers.
+void BC_EpochCollect(void);
+
+// Waits for every reader present at the call to leave, then reclaims everything the calling
+// thread retired. Must not be called inside a critical section.
+void BC_EpochSynchronize(void);
+
+// Pointers retired by any thread and not reclaimed yet
+size_t BC_EpochPendingCount(void);
+
+#endif //BCORE_EPOCH_H
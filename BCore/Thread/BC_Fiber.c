@@ -0,0 +1,257 @@
+#if defined(__APPLE__)
+// ucontext is only declared for XSI builds on Darwin
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "BC_Fiber.h"
+
+#include "BC_Threads.h"
+#include "../BC_Keywords.h"
+#include "../Memory/BC_VirtualMemory.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#define PRIV_FIBER_SUPPORTED 1
+#include <ucontext.h>
+#else
+#define PRIV_FIBER_SUPPORTED 0
+#endif
+
+// =========================================================
+// MARK: Structures
+// =========================================================
+
+// One mapping per fiber: a guard page, the stack growing down towards it, then this header
+typedef struct BC_Fiber {
+#if PRIV_FIBER_SUPPORTED == 1
+	ucontext_t machine;   // Where the fiber continues
+	ucontext_t caller;    // Where it returns to on yield, saved by every resume
+#endif
+	BC_FiberFunc func;
+	void* arg;
+	BC_FiberState state;
+	BC_FiberHooks hooks;
+	void* context;        // Framework state while suspended, see BC_FiberHooks
+	void* mapping;
+	size_t mappingSize;
+	size_t stackSize;
+	struct BC_Fiber* next; // Free list link
+} BC_Fiber;
+
+static BC_TLS BC_FiberRef gCurrentFiber = NULL;
+static BC_FiberHooks gFiberHooks = {NULL, NULL, NULL, NULL};
+
+// Finished fibers of the default stack size, mapping and header reused as is
+static BC_FiberRef gFiberPool = NULL;
+static size_t gFiberPoolCount = 0;
+BC_MUTEX_MAYBE(gFiberPoolMutex)
+BC_ONCE_MAYBE_STATIC(gFiberPoolOnce)
+
+// =========================================================
+// MARK: Hooks
+// =========================================================
+
+void BC_FiberSetHooks(const BC_FiberHooks* hooks) {
+	if (hooks)
+		gFiberHooks = *hooks;
+	else
+		gFiberHooks = (BC_FiberHooks){NULL, NULL, NULL, NULL};
+}
+
+// =========================================================
+// MARK: Private
+// =========================================================
+
+static void PRIV_FiberPoolSetup(void) {
+	BC_MutexInit(&gFiberPoolMutex);
+}
+
+static BC_FiberRef PRIV_FiberPoolPop(void) {
+	BC_RunOnce(&gFiberPoolOnce, PRIV_FiberPoolSetup);
+	BC_MutexLock(&gFiberPoolMutex);
+	BC_FiberRef fiber = gFiberPool;
+	if (fiber) {
+		gFiberPool = fiber->next;
+		gFiberPoolCount--;
+	}
+	BC_MutexUnlock(&gFiberPoolMutex);
+	return fiber;
+}
+
+static BC_bool PRIV_FiberPoolPush(BC_FiberRef fiber) {
+	BC_RunOnce(&gFiberPoolOnce, PRIV_FiberPoolSetup);
+	BC_MutexLock(&gFiberPoolMutex);
+	const BC_bool pooled = gFiberPoolCount < BC_FIBER_POOL_LIMIT;
+	if (pooled) {
+		fiber->next = gFiberPool;
+		gFiberPool = fiber;
+		gFiberPoolCount++;
+	}
+	BC_MutexUnlock(&gFiberPoolMutex);
+	return pooled;
+}
+
+#if PRIV_FIBER_SUPPORTED == 1
+
+static size_t PRIV_FiberRoundToPage(const size_t size, const size_t pageSize) {
+	return (size + pageSize - 1) & ~(pageSize - 1);
+}
+
+static BC_FiberRef PRIV_FiberMap(const size_t stackSize) {
+	const size_t pageSize = BC_VirtualPageSize();
+	const size_t headerSize = PRIV_FiberRoundToPage(sizeof(BC_Fiber), pageSize);
+	const size_t mappingSize = pageSize + stackSize + headerSize;
+
+	uint8_t* mapping = BC_VirtualReserve(mappingSize);
+	if (!mapping) return NULL;
+
+	// The lowest page stays reserved only, it is the guard
+	if (!BC_VirtualCommit(mapping + pageSize, stackSize + headerSize)) {
+		BC_VirtualRelease(mapping, mappingSize);
+		return NULL;
+	}
+
+	BC_FiberRef fiber = (BC_FiberRef)(mapping + pageSize + stackSize);
+	fiber->mapping = mapping;
+	fiber->mappingSize = mappingSize;
+	fiber->stackSize = stackSize;
+	return fiber;
+}
+
+// makecontext only passes int arguments, the pointer comes in two halves
+static void PRIV_FiberEntry(const unsigned int low, const unsigned int high) {
+	const BC_FiberRef fiber = (BC_FiberRef)(uintptr_t)((uint64_t)high << 32 | low);
+
+	if (fiber->hooks.fiberBegin) fiber->hooks.fiberBegin();
+	fiber->func(fiber->arg);
+	if (fiber->hooks.fiberEnd) fiber->hooks.fiberEnd();
+
+	// Returning follows uc_link to the context saved by the last resume
+	fiber->state = BC_FiberStateFinished;
+}
+
+#endif
+
+// =========================================================
+// MARK: Public
+// =========================================================
+
+BC_FiberRef BC_FiberCreate(const BC_FiberFunc func, void* arg, const size_t stackSize) {
+#if PRIV_FIBER_SUPPORTED == 1
+	if (!func) {
+		fprintf(stderr, "BC_FiberCreate: NULL function\n");
+		return NULL;
+	}
+
+	const size_t size = PRIV_FiberRoundToPage(stackSize ? stackSize : BC_FIBER_DEFAULT_STACK_SIZE, BC_VirtualPageSize());
+	BC_FiberRef fiber = size == BC_FIBER_DEFAULT_STACK_SIZE ? PRIV_FiberPoolPop() : NULL;
+	if (!fiber) fiber = PRIV_FiberMap(size);
+	if (!fiber) {
+		fprintf(stderr, "BC_FiberCreate: Failed to map a %zu bytes stack\n", size);
+		return NULL;
+	}
+
+	fiber->func = func;
+	fiber->arg = arg;
+	fiber->state = BC_FiberStateSuspended;
+	fiber->hooks = gFiberHooks;
+	fiber->context = NULL;
+	fiber->next = NULL;
+
+	if (getcontext(&fiber->machine) != 0) {
+		fprintf(stderr, "BC_FiberCreate: getcontext failed\n");
+		BC_VirtualRelease(fiber->mapping, fiber->mappingSize);
+		return NULL;
+	}
+	fiber->machine.uc_stack.ss_sp = (uint8_t*)fiber - fiber->stackSize;
+	fiber->machine.uc_stack.ss_size = fiber->stackSize;
+	fiber->machine.uc_link = &fiber->caller;
+
+	const uint64_t address = (uintptr_t)fiber;
+	makecontext(&fiber->machine, (void (*)(void))PRIV_FiberEntry, 2, (unsigned int)address, (unsigned int)(address >> 32));
+	return fiber;
+#else
+	(void)func;
+	(void)arg;
+	(void)stackSize;
+	fprintf(stderr, "BC_FiberCreate: Fibers are not supported on this platform\n");
+	return NULL;
+#endif
+}
+
+BC_bool BC_FiberResume(const BC_FiberRef fiber) {
+#if PRIV_FIBER_SUPPORTED == 1
+	if (!fiber) return BC_false;
+	if (fiber->state != BC_FiberStateSuspended) {
+		fprintf(stderr, "BC_FiberResume: Fiber is %s\n", fiber->state == BC_FiberStateRunning ? "already running" : "finished");
+		return BC_false;
+	}
+
+	void* callerContext = fiber->hooks.contextSwap ? fiber->hooks.contextSwap(fiber->context) : NULL;
+	const BC_FiberRef previous = gCurrentFiber;
+	gCurrentFiber = fiber;
+	fiber->state = BC_FiberStateRunning;
+
+	swapcontext(&fiber->caller, &fiber->machine);
+
+	gCurrentFiber = previous;
+	if (fiber->state == BC_FiberStateRunning) fiber->state = BC_FiberStateSuspended;
+	if (fiber->hooks.contextSwap) fiber->context = fiber->hooks.contextSwap(callerContext);
+	return BC_true;
+#else
+	(void)fiber;
+	return BC_false;
+#endif
+}
+
+void BC_FiberYield(void) {
+#if PRIV_FIBER_SUPPORTED == 1
+	const BC_FiberRef fiber = gCurrentFiber;
+	if (!fiber) {
+		fprintf(stderr, "BC_FiberYield: Not on a fiber\n");
+		return;
+	}
+
+	// Nothing thread local is touched past the switch, the fiber may come back on another thread
+	swapcontext(&fiber->machine, &fiber->caller);
+#endif
+}
+
+BC_FiberRef BC_FiberCurrent(void) {
+	return gCurrentFiber;
+}
+
+BC_FiberState BC_FiberGetState(const BC_FiberRef fiber) {
+	return fiber->state;
+}
+
+BC_bool BC_FiberIsFinished(const BC_FiberRef fiber) {
+	return fiber->state == BC_FiberStateFinished;
+}
+
+void BC_FiberDestroy(const BC_FiberRef fiber) {
+	if (!fiber) return;
+	if (fiber->state == BC_FiberStateRunning) {
+		fprintf(stderr, "BC_FiberDestroy: Fiber is running\n");
+		return;
+	}
+
+	if (fiber->context && fiber->hooks.contextDestroy) fiber->hooks.contextDestroy(fiber->context);
+	fiber->context = NULL;
+
+	if (fiber->stackSize == BC_FIBER_DEFAULT_STACK_SIZE && PRIV_FiberPoolPush(fiber)) return;
+	BC_VirtualRelease(fiber->mapping, fiber->mappingSize);
+}
+
+// =========================================================
+// MARK: Internal
+// =========================================================
+
+void INTERNAL_BC_FiberDeinitialize(void) {
+	BC_FiberRef fiber;
+	while ((fiber = PRIV_FiberPoolPop())) {
+		BC_VirtualRelease(fiber->mapping, fiber->mappingSize);
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef BCORE_FIBER_H
+#define BCORE_FIBER_H
+
+#include "../BC_Macro.h"
+#include "../BC_Types.h"
+
+#include <stddef.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Usable stack of a fiber created with `stackSize` 0. Pages are only paid for once touched, a
+// handler that stays shallow costs a few pages whatever the size.
+#define BC_FIBER_DEFAULT_STACK_SIZE BC_KB(64)
+
+// Finished fibers of the default stack size kept mapped for reuse
+#define BC_FIBER_POOL_LIMIT 1024
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef void (*BC_FiberFunc)(void* arg);
+
+typedef enum {
+	BC_FiberStateSuspended,  // Created or yielded, waits for BC_FiberResume
+	BC_FiberStateRunning,
+	BC_FiberStateFinished
+} BC_FiberState;
+
+// Lets frameworks built on top of BCore keep per fiber state, any of them can be NULL.
+// BFramework gives every fiber its own autorelease pool chain this way.
+typedef struct BC_FiberHooks {
+	void (*fiberBegin)(void);                // On the fiber before its function
+	void (*fiberEnd)(void);                  // On the fiber after its function returned
+	void* (*contextSwap)(void* context);     // Installs `context` on the thread, returns the one it replaces
+	void (*contextDestroy)(void* context);   // For a fiber destroyed while suspended in its function
+} BC_FiberHooks;
+
+// =========================================================
+// MARK: Fiber
+// =========================================================
+
+// Stackful coroutines switched in user space. A fiber runs on the thread calling BC_FiberResume
+// until it yields or returns, fibers can resume other fibers. A suspended fiber can be resumed
+// from another thread, but only one thread at a time and its code must not keep the address of
+// a thread local across a yield. Stacks are mapped with a guard page below them, overflowing
+// one faults instead of corrupting its neighbour. Only available where ucontext is, creating a
+// fiber fails elsewhere.
+
+// `stackSize` 0 picks BC_FIBER_DEFAULT_STACK_SIZE, it is rounded up to whole pages
+BC_FiberRef BC_FiberCreate(BC_FiberFunc func, void* arg, size_t stackSize);
+
+// Runs the fiber until it yields or returns, returns BC_false when it cannot be resumed
+BC_bool BC_FiberResume(BC_FiberRef fiber);
+
+// Suspends the current fiber and returns to whoever resumed it. Must be called on a fiber.
+void BC_FiberYield(void);
+
+// Fiber running on the calling thread, NULL outside of one
+BC_FiberRef BC_FiberCurrent(void);
+
+BC_FiberState BC_FiberGetState(BC_FiberRef fiber);
+BC_bool BC_FiberIsFinished(BC_FiberRef fiber);
+
+// A suspended fiber is dropped where it stopped, nothing left on its stack is unwound.
+// Destroying a running fiber fails.
+void BC_FiberDestroy(BC_FiberRef fiber);
+
+// Replaces the hooks for fibers created from now on
+void BC_FiberSetHooks(const BC_FiberHooks* hooks);
+
+#endif //BCORE_FIBER_H
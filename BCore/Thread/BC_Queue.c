@@ -0,0 +1,230 @@
+#include "BC_Queue.h"
+
+#include "BC_Atomics.h"
+#include "../Memory/BC_Allocator.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// =========================================================
+// MARK: Structures
+// =========================================================
+
+// Producer and consumer indices each sit on their own cache line so the two sides never
+// invalidate each other when only one of them moves
+typedef struct BC_SPSCQueue {
+	_Alignas(BC_CACHE_LINE_SIZE) BC_atomic_size tail;
+	size_t cachedHead;   // Producer side copy of head, reloaded only when the queue looks full
+	_Alignas(BC_CACHE_LINE_SIZE) BC_atomic_size head;
+	size_t cachedTail;   // Consumer side copy of tail, reloaded only when the queue looks empty
+	_Alignas(BC_CACHE_LINE_SIZE) size_t mask;
+	BC_QueueCallbacks callbacks;
+	void* slots[];
+} BC_SPSCQueue;
+
+typedef struct PRIV_MPMCCell {
+	BC_atomic_size sequence;  // Equals the position when free for it, position + 1 once filled
+	void* item;
+} PRIV_MPMCCell;
+
+typedef struct BC_MPMCQueue {
+	_Alignas(BC_CACHE_LINE_SIZE) BC_atomic_size enqueuePosition;
+	_Alignas(BC_CACHE_LINE_SIZE) BC_atomic_size dequeuePosition;
+	_Alignas(BC_CACHE_LINE_SIZE) size_t mask;
+	BC_QueueCallbacks callbacks;
+	PRIV_MPMCCell cells[];
+} BC_MPMCQueue;
+
+// =========================================================
+// MARK: Private
+// =========================================================
+
+static size_t PRIV_QueueRoundCapacity(const size_t capacity) {
+	size_t rounded = 2;
+	while (rounded < capacity) rounded <<= 1;
+	return rounded;
+}
+
+static void PRIV_QueueSetCallbacks(BC_QueueCallbacks* out, const BC_QueueCallbacks* callbacks) {
+	if (callbacks) {
+		*out = *callbacks;
+	} else {
+		*out = (BC_QueueCallbacks){NULL, NULL};
+	}
+}
+
+// =========================================================
+// MARK: Single Producer Single Consumer
+// =========================================================
+
+BC_SPSCQueueRef BC_SPSCQueueCreate(const size_t capacity, const BC_QueueCallbacks* callbacks) {
+	if (capacity == 0) {
+		fprintf(stderr, "BC_SPSCQueueCreate: Invalid capacity (must be > 0)\n");
+		return NULL;
+	}
+
+	const size_t rounded = PRIV_QueueRoundCapacity(capacity);
+	const BC_SPSCQueueRef queue = BC_AllocatorAllocAligned(kBC_AllocatorRefSystem, sizeof(BC_SPSCQueue) + rounded * sizeof(void*), BC_CACHE_LINE_SIZE);
+	if (!queue) {
+		fprintf(stderr, "BC_SPSCQueueCreate: Failed to allocate queue of %zu slots\n", rounded);
+		return NULL;
+	}
+
+	BC_atomic_store_relaxed(&queue->tail, 0);
+	BC_atomic_store_relaxed(&queue->head, 0);
+	queue->cachedHead = 0;
+	queue->cachedTail = 0;
+	queue->mask = rounded - 1;
+	PRIV_QueueSetCallbacks(&queue->callbacks, callbacks);
+	return queue;
+}
+
+void BC_SPSCQueueDestroy(const BC_SPSCQueueRef queue) {
+	if (!queue) return;
+
+	void* item;
+	while ((item = BC_SPSCQueuePop(queue))) {
+		if (queue->callbacks.release) queue->callbacks.release(item);
+	}
+	BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, queue);
+}
+
+BC_bool BC_SPSCQueuePush(const BC_SPSCQueueRef queue, void* item) {
+	if (!queue || !item) return BC_false;
+
+	const size_t tail = BC_atomic_load_relaxed(&queue->tail);
+	if (tail - queue->cachedHead > queue->mask) {
+		queue->cachedHead = BC_atomic_load_acquire(&queue->head);
+		if (tail - queue->cachedHead > queue->mask) return BC_false;
+	}
+
+	if (queue->callbacks.retain) item = queue->callbacks.retain(item);
+	queue->slots[tail & queue->mask] = item;
+	BC_atomic_store_release(&queue->tail, tail + 1);
+	return BC_true;
+}
+
+void* BC_SPSCQueuePop(const BC_SPSCQueueRef queue) {
+	if (!queue) return NULL;
+
+	const size_t head = BC_atomic_load_relaxed(&queue->head);
+	if (head == queue->cachedTail) {
+		queue->cachedTail = BC_atomic_load_acquire(&queue->tail);
+		if (head == queue->cachedTail) return NULL;
+	}
+
+	void* item = queue->slots[head & queue->mask];
+	BC_atomic_store_release(&queue->head, head + 1);
+	return item;
+}
+
+size_t BC_SPSCQueueCapacity(const BC_SPSCQueueRef queue) {
+	if (!queue) return 0;
+	return queue->mask + 1;
+}
+
+size_t BC_SPSCQueueCount(const BC_SPSCQueueRef queue) {
+	if (!queue) return 0;
+	const size_t head = BC_atomic_load_acquire(&queue->head);
+	const size_t tail = BC_atomic_load_acquire(&queue->tail);
+	return tail - head;
+}
+
+// =========================================================
+// MARK: Multi Producer Multi Consumer
+// =========================================================
+
+BC_MPMCQueueRef BC_MPMCQueueCreate(const size_t capacity, const BC_QueueCallbacks* callbacks) {
+	if (capacity == 0) {
+		fprintf(stderr, "BC_MPMCQueueCreate: Invalid capacity (must be > 0)\n");
+		return NULL;
+	}
+
+	const size_t rounded = PRIV_QueueRoundCapacity(capacity);
+	const BC_MPMCQueueRef queue = BC_AllocatorAllocAligned(kBC_AllocatorRefSystem, sizeof(BC_MPMCQueue) + rounded * sizeof(PRIV_MPMCCell), BC_CACHE_LINE_SIZE);
+	if (!queue) {
+		fprintf(stderr, "BC_MPMCQueueCreate: Failed to allocate queue of %zu slots\n", rounded);
+		return NULL;
+	}
+
+	BC_atomic_store_relaxed(&queue->enqueuePosition, 0);
+	BC_atomic_store_relaxed(&queue->dequeuePosition, 0);
+	queue->mask = rounded - 1;
+	PRIV_QueueSetCallbacks(&queue->callbacks, callbacks);
+	for (size_t i = 0; i < rounded; i++) {
+		BC_atomic_store_relaxed(&queue->cells[i].sequence, i);
+		queue->cells[i].item = NULL;
+	}
+	return queue;
+}
+
+void BC_MPMCQueueDestroy(const BC_MPMCQueueRef queue) {
+	if (!queue) return;
+
+	void* item;
+	while ((item = BC_MPMCQueuePop(queue))) {
+		if (queue->callbacks.release) queue->callbacks.release(item);
+	}
+	BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, queue);
+}
+
+BC_bool BC_MPMCQueuePush(const BC_MPMCQueueRef queue, void* item) {
+	if (!queue || !item) return BC_false;
+
+	size_t position = BC_atomic_load_relaxed(&queue->enqueuePosition);
+	PRIV_MPMCCell* cell;
+	for (;;) {
+		cell = &queue->cells[position & queue->mask];
+		const intptr_t diff = (intptr_t)BC_atomic_load_acquire(&cell->sequence) - (intptr_t)position;
+		if (diff == 0) {
+			// Free for this position, claim it. A failed exchange reloads the position.
+			if (BC_atomic_compare_exchange(&queue->enqueuePosition, &position, position + 1)) break;
+		} else if (diff < 0) {
+			// Still holds the item from one lap ago
+			return BC_false;
+		} else {
+			position = BC_atomic_load_relaxed(&queue->enqueuePosition);
+		}
+	}
+
+	if (queue->callbacks.retain) item = queue->callbacks.retain(item);
+	cell->item = item;
+	BC_atomic_store_release(&cell->sequence, position + 1);
+	return BC_true;
+}
+
+void* BC_MPMCQueuePop(const BC_MPMCQueueRef queue) {
+	if (!queue) return NULL;
+
+	size_t position = BC_atomic_load_relaxed(&queue->dequeuePosition);
+	PRIV_MPMCCell* cell;
+	for (;;) {
+		cell = &queue->cells[position & queue->mask];
+		const intptr_t diff = (intptr_t)BC_atomic_load_acquire(&cell->sequence) - (intptr_t)(position + 1);
+		if (diff == 0) {
+			if (BC_atomic_compare_exchange(&queue->dequeuePosition, &position, position + 1)) break;
+		} else if (diff < 0) {
+			// Not filled yet
+			return NULL;
+		} else {
+			position = BC_atomic_load_relaxed(&queue->dequeuePosition);
+		}
+	}
+
+	void* item = cell->item;
+	// Free the cell for the producer one lap ahead
+	BC_atomic_store_release(&cell->sequence, position + queue->mask + 1);
+	return item;
+}
+
+size_t BC_MPMCQueueCapacity(const BC_MPMCQueueRef queue) {
+	if (!queue) return 0;
+	return queue->mask + 1;
+}
+
+size_t BC_MPMCQueueCount(const BC_MPMCQueueRef queue) {
+	if (!queue) return 0;
+	const size_t dequeued = BC_atomic_load_acquire(&queue->dequeuePosition);
+	const size_t enqueued = BC_atomic_load_acquire(&queue->enqueuePosition);
+	return enqueued > dequeued ? enqueued - dequeued : 0;
+}
@@ -0,0 +1,61 @@
+#ifndef BCORE_QUEUE_H
+#define BCORE_QUEUE_H
+
+#include "../BC_Types.h"
+
+#include <stddef.h>
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+// Ownership of the items, both can be NULL for raw pointers. `retain` runs on push and the
+// queue keeps that reference, pop hands it over to the caller. Items left when the queue is
+// destroyed are released.
+typedef struct BC_QueueCallbacks {
+	void* (*retain)(void* item);
+	void (*release)(void* item);
+} BC_QueueCallbacks;
+
+// =========================================================
+// MARK: Single Producer Single Consumer
+// =========================================================
+
+// Bounded ring buffer for one producer thread and one consumer thread, push and pop never
+// block or take a lock. `capacity` is rounded up to a power of two.
+BC_SPSCQueueRef BC_SPSCQueueCreate(size_t capacity, const BC_QueueCallbacks* callbacks);
+void BC_SPSCQueueDestroy(BC_SPSCQueueRef queue);
+
+// Returns BC_false when the queue is full, NULL items are refused
+BC_bool BC_SPSCQueuePush(BC_SPSCQueueRef queue, void* item);
+
+// Returns NULL when the queue is empty
+void* BC_SPSCQueuePop(BC_SPSCQueueRef queue);
+
+size_t BC_SPSCQueueCapacity(BC_SPSCQueueRef queue);
+
+// Exact from the producer or the consumer when the other side is idle, a hint otherwise
+size_t BC_SPSCQueueCount(BC_SPSCQueueRef queue);
+
+// =========================================================
+// MARK: Multi Producer Multi Consumer
+// =========================================================
+
+// Bounded queue any number of threads can push to and pop from without a lock, each slot
+// carries a sequence number telling producers and consumers whose turn it is.
+// `capacity` is rounded up to a power of two.
+BC_MPMCQueueRef BC_MPMCQueueCreate(size_t capacity, const BC_QueueCallbacks* callbacks);
+void BC_MPMCQueueDestroy(BC_MPMCQueueRef queue);
+
+// Returns BC_false when the queue is full, NULL items are refused
+BC_bool BC_MPMCQueuePush(BC_MPMCQueueRef queue, void* item);
+
+// Returns NULL when the queue is empty
+void* BC_MPMCQueuePop(BC_MPMCQueueRef queue);
+
+size_t BC_MPMCQueueCapacity(BC_MPMCQueueRef queue);
+
+// A hint under concurrent use
+size_t BC_MPMCQueueCount(BC_MPMCQueueRef queue);
+
+#endif //BCORE_QUEUE_H
@@ -0,0 +1,624 @@
+#include "BC_RunLoop.h"
+
+#include "BC_Atomics.h"
+#include "BC_Threads.h"
+#include "../BC_Keywords.h"
+#include "../Memory/BC_Memory.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+// =========================================================
+// MARK: Hooks
+// =========================================================
+
+static BC_RunLoopHooks gRunLoopHooks = {NULL, NULL};
+static BC_TLS BC_RunLoopRef gCurrentRunLoop = NULL;
+
+void BC_RunLoopSetHooks(const BC_RunLoopHooks* hooks) {
+	if (hooks)
+		gRunLoopHooks = *hooks;
+	else
+		gRunLoopHooks = (BC_RunLoopHooks){NULL, NULL};
+}
+
+BC_RunLoopRef BC_RunLoopCurrent(void) {
+	return gCurrentRunLoop;
+}
+
+#if defined(__linux__)
+
+// =========================================================
+// MARK: Structures
+// =========================================================
+
+// Four levels of 64 slots cover 2^24 ticks, about 4.6 hours at 1ms. Level n holds timers
+// due within 64^(n+1) ticks and is cascaded into the lower levels one slot at a time as the
+// wheel turns. Timers further out wait in the last level and are cascaded again.
+#define PRIV_WHEEL_LEVELS 4
+#define PRIV_WHEEL_BITS 6
+#define PRIV_WHEEL_SLOTS (1u << PRIV_WHEEL_BITS)
+#define PRIV_WHEEL_MASK (PRIV_WHEEL_SLOTS - 1)
+#define PRIV_WHEEL_SPAN (1ull << (PRIV_WHEEL_BITS * PRIV_WHEEL_LEVELS))
+
+#define PRIV_NIL UINT32_MAX
+#define PRIV_WAKE_TAG 0
+
+// Ids are the slot generation in the high half and the index plus one in the low half, a
+// reused slot gets a new generation so stale ids are refused
+#define PRIV_IdMake(_generation_, _index_) ((uint64_t)(_generation_) << 32 | ((uint64_t)(_index_) + 1))
+#define PRIV_IdIndex(_id_) ((uint32_t)(_id_) - 1)
+#define PRIV_IdGeneration(_id_) ((uint32_t)((_id_) >> 32))
+
+typedef struct PRIV_RunLoopTimer {
+	uint64_t expires;     // Tick
+	uint64_t interval;    // Ticks, 0 for one shot
+	BC_RunLoopFunc func;
+	void* arg;
+	uint32_t generation;
+	uint32_t prev;        // Slot list
+	uint32_t next;        // Slot list, or free list when inactive
+	uint8_t level;
+	uint8_t slot;
+	BC_bool active;
+} PRIV_RunLoopTimer;
+
+typedef struct PRIV_RunLoopSource {
+	int fd;
+	uint32_t events;
+	BC_RunLoopSourceFunc func;
+	void* arg;
+	uint32_t generation;
+	uint32_t nextFree;
+	BC_bool active;
+} PRIV_RunLoopSource;
+
+typedef struct PRIV_RunLoopTask {
+	BC_RunLoopFunc func;
+	void* arg;
+} PRIV_RunLoopTask;
+
+typedef struct BC_RunLoop {
+	int epollFd;
+	int wakeFd;
+	BC_RunLoopHooks hooks;
+	BC_atomic_bool stopped;
+
+	// Timer wheel, only touched by the thread running the loop
+	uint64_t startNanoseconds;
+	uint64_t currentTick;
+	size_t timerCount;
+	uint32_t wheel[PRIV_WHEEL_LEVELS][PRIV_WHEEL_SLOTS];
+	uint64_t occupied[PRIV_WHEEL_LEVELS];   // Bit per non empty slot
+	PRIV_RunLoopTimer* timers;
+	uint32_t timerCapacity;
+	uint32_t timerFree;
+
+	PRIV_RunLoopSource* sources;
+	uint32_t sourceCapacity;
+	uint32_t sourceFree;
+
+	// Posted tasks are appended under the lock and swapped out whole by the loop
+	BC_MUTEX_MAYBE(postLock)
+	PRIV_RunLoopTask* posted;
+	size_t postedCount;
+	size_t postedCapacity;
+	PRIV_RunLoopTask* running;
+	size_t runningCapacity;
+} BC_RunLoop;
+
+// =========================================================
+// MARK: Timer Wheel
+// =========================================================
+
+static uint64_t PRIV_WheelTickNow(const BC_RunLoopRef loop) {
+	return (BC_TimeMonotonicNanoseconds() - loop->startNanoseconds) / BC_RUN_LOOP_TICK_NANOSECONDS;
+}
+
+static void PRIV_WheelLink(const BC_RunLoopRef loop, const uint32_t index) {
+	PRIV_RunLoopTimer* timer = &loop->timers[index];
+
+	const uint64_t delta = timer->expires - loop->currentTick;
+	uint8_t level = 0;
+	while (level < PRIV_WHEEL_LEVELS - 1 && delta >= 1ull << (PRIV_WHEEL_BITS * (level + 1))) level++;
+
+	// Past the span of the wheel, parked in the farthest slot and placed again once cascaded
+	const uint64_t expires = delta < PRIV_WHEEL_SPAN ? timer->expires : loop->currentTick + PRIV_WHEEL_SPAN - 1;
+	const uint8_t slot = (uint8_t)(expires >> (PRIV_WHEEL_BITS * level) & PRIV_WHEEL_MASK);
+
+	uint32_t* head = &loop->wheel[level][slot];
+	timer->level = level;
+	timer->slot = slot;
+	timer->prev = PRIV_NIL;
+	timer->next = *head;
+	if (*head != PRIV_NIL) loop->timers[*head].prev = index;
+	*head = index;
+	loop->occupied[level] |= 1ull << slot;
+}
+
+static void PRIV_WheelUnlink(const BC_RunLoopRef loop, const uint32_t index) {
+	const PRIV_RunLoopTimer* timer = &loop->timers[index];
+	uint32_t* head = &loop->wheel[timer->level][timer->slot];
+
+	if (timer->prev != PRIV_NIL)
+		loop->timers[timer->prev].next = timer->next;
+	else
+		*head = timer->next;
+	if (timer->next != PRIV_NIL) loop->timers[timer->next].prev = timer->prev;
+
+	if (*head == PRIV_NIL) loop->occupied[timer->level] &= ~(1ull << timer->slot);
+}
+
+static void PRIV_TimerFree(const BC_RunLoopRef loop, const uint32_t index) {
+	PRIV_RunLoopTimer* timer = &loop->timers[index];
+	timer->active = BC_false;
+	if (++timer->generation == 0) timer->generation = 1;
+	timer->next = loop->timerFree;
+	loop->timerFree = index;
+	loop->timerCount--;
+}
+
+// First tick something happens on: a level 0 slot firing or a higher slot cascading
+static uint64_t PRIV_WheelNextTick(const BC_RunLoopRef loop) {
+	uint64_t next = UINT64_MAX;
+	for (int level = 0; level < PRIV_WHEEL_LEVELS; level++) {
+		const uint64_t occupied = loop->occupied[level];
+		if (!occupied) continue;
+
+		const unsigned shift = PRIV_WHEEL_BITS * level;
+		const uint64_t base = (loop->currentTick >> shift) + 1;
+		const unsigned start = (unsigned)(base & PRIV_WHEEL_MASK);
+		const uint64_t rotated = start ? occupied >> start | occupied << (64 - start) : occupied;
+		const uint64_t tick = (base + (uint64_t)__builtin_ctzll(rotated)) << shift;
+		if (tick < next) next = tick;
+	}
+	return next;
+}
+
+static void PRIV_WheelCascade(const BC_RunLoopRef loop, const int level, const uint32_t slot) {
+	uint32_t index = loop->wheel[level][slot];
+	loop->wheel[level][slot] = PRIV_NIL;
+	loop->occupied[level] &= ~(1ull << slot);
+
+	while (index != PRIV_NIL) {
+		const uint32_t next = loop->timers[index].next;
+		PRIV_WheelLink(loop, index);
+		index = next;
+	}
+}
+
+// Fires the timers of the current tick one at a time, handlers can add and cancel any timer
+static size_t PRIV_WheelFire(const BC_RunLoopRef loop, const uint64_t target) {
+	const uint32_t slot = (uint32_t)(loop->currentTick & PRIV_WHEEL_MASK);
+	size_t fired = 0;
+
+	uint32_t index;
+	while ((index = loop->wheel[0][slot]) != PRIV_NIL) {
+		PRIV_WheelUnlink(loop, index);
+		PRIV_RunLoopTimer* timer = &loop->timers[index];
+		const BC_RunLoopFunc func = timer->func;
+		void* arg = timer->arg;
+
+		if (timer->interval) {
+			// Skips the intervals already missed by `target` while keeping the phase
+			const uint64_t steps = (target - timer->expires) / timer->interval + 1;
+			timer->expires = timer->interval > (UINT64_MAX - timer->expires) / steps ? UINT64_MAX : timer->expires + steps * timer->interval;
+			PRIV_WheelLink(loop, index);
+		}
+		else {
+			PRIV_TimerFree(loop, index);
+		}
+
+		func(arg);
+		fired++;
+	}
+	return fired;
+}
+
+static size_t PRIV_WheelAdvance(const BC_RunLoopRef loop, const uint64_t target) {
+	size_t fired = 0;
+	while (loop->currentTick < target) {
+		// Jumps straight to the next tick with work, ticks in between have nothing to do
+		const uint64_t next = loop->timerCount ? PRIV_WheelNextTick(loop) : UINT64_MAX;
+		if (next > target) {
+			loop->currentTick = target;
+			break;
+		}
+		loop->currentTick = next;
+
+		for (int level = PRIV_WHEEL_LEVELS - 1; level > 0; level--) {
+			const unsigned shift = PRIV_WHEEL_BITS * level;
+			if ((next & ((1ull << shift) - 1)) == 0) {
+				const uint32_t slot = (uint32_t)(next >> shift & PRIV_WHEEL_MASK);
+				if (loop->occupied[level] & 1ull << slot) PRIV_WheelCascade(loop, level, slot);
+			}
+		}
+		fired += PRIV_WheelFire(loop, target);
+	}
+	return fired;
+}
+
+// =========================================================
+// MARK: Private
+// =========================================================
+
+static uint32_t PRIV_EpollEvents(const uint32_t events) {
+	uint32_t result = 0;
+	if (events & BC_RunLoopEventReadable) result |= EPOLLIN;
+	if (events & BC_RunLoopEventWritable) result |= EPOLLOUT;
+	return result;
+}
+
+static uint32_t PRIV_RunLoopEvents(const uint32_t events) {
+	uint32_t result = 0;
+	if (events & EPOLLIN) result |= BC_RunLoopEventReadable;
+	if (events & EPOLLOUT) result |= BC_RunLoopEventWritable;
+	if (events & EPOLLERR) result |= BC_RunLoopEventError;
+	if (events & EPOLLHUP) result |= BC_RunLoopEventHangup;
+	return result;
+}
+
+static PRIV_RunLoopSource* PRIV_SourceGet(const BC_RunLoopRef loop, const BC_RunLoopSourceId source) {
+	const uint32_t index = PRIV_IdIndex(source);
+	if (source == 0 || index >= loop->sourceCapacity) return NULL;
+	PRIV_RunLoopSource* entry = &loop->sources[index];
+	return entry->active && entry->generation == PRIV_IdGeneration(source) ? entry : NULL;
+}
+
+static BC_bool PRIV_RunLoopGrow(void** array, uint32_t* capacity, const size_t itemSize) {
+	const uint32_t newCapacity = *capacity ? *capacity * 2 : 16;
+	void* grown = BC_Realloc(*array, newCapacity * itemSize);
+	if (!grown) return BC_false;
+	*array = grown;
+	*capacity = newCapacity;
+	return BC_true;
+}
+
+static void PRIV_RunLoopWake(const BC_RunLoopRef loop) {
+	const uint64_t one = 1;
+	// A full counter means a wake up is pending already
+	while (write(loop->wakeFd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+}
+
+static size_t PRIV_RunLoopRunPosted(const BC_RunLoopRef loop) {
+	// The batch is owned by this call while it runs, a task running the loop again nested
+	// takes the spare array or grows a new one and never touches it
+	BC_MutexLock(&loop->postLock);
+	PRIV_RunLoopTask* tasks = loop->posted;
+	const size_t count = loop->postedCount;
+	const size_t capacity = loop->postedCapacity;
+	loop->posted = loop->running;
+	loop->postedCapacity = loop->runningCapacity;
+	loop->postedCount = 0;
+	loop->running = NULL;
+	loop->runningCapacity = 0;
+	BC_MutexUnlock(&loop->postLock);
+
+	// Tasks posted from here on wait for the next iteration
+	for (size_t i = 0; i < count; i++) {
+		tasks[i].func(tasks[i].arg);
+	}
+
+	// Handed back as the spare, unless a nested run left one there already
+	if (!loop->running) {
+		loop->running = tasks;
+		loop->runningCapacity = capacity;
+	} else {
+		BC_Free(tasks);
+	}
+	return count;
+}
+
+// =========================================================
+// MARK: Run Loop
+// =========================================================
+
+BC_RunLoopRef BC_RunLoopCreate(void) {
+	BC_RunLoopRef loop = BC_Calloc(1, sizeof(BC_RunLoop));
+	if (!loop) return NULL;
+
+	loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	loop->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	struct epoll_event event = {.events = EPOLLIN, .data.u64 = PRIV_WAKE_TAG};
+	if (loop->epollFd < 0 || loop->wakeFd < 0 || epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->wakeFd, &event) != 0) {
+		fprintf(stderr, "BC_RunLoopCreate: Failed to set up epoll (errno %d)\n", errno);
+		if (loop->epollFd >= 0) close(loop->epollFd);
+		if (loop->wakeFd >= 0) close(loop->wakeFd);
+		BC_Free(loop);
+		return NULL;
+	}
+
+	loop->hooks = gRunLoopHooks;
+	BC_atomic_store(&loop->stopped, BC_false);
+	loop->startNanoseconds = BC_TimeMonotonicNanoseconds();
+	memset(loop->wheel, 0xFF, sizeof(loop->wheel));
+	loop->timerFree = PRIV_NIL;
+	loop->sourceFree = PRIV_NIL;
+	BC_MutexInit(&loop->postLock);
+	return loop;
+}
+
+void BC_RunLoopDestroy(const BC_RunLoopRef loop) {
+	if (!loop) return;
+	close(loop->epollFd);
+	close(loop->wakeFd);
+	BC_MutexDestroy(&loop->postLock);
+	BC_Free(loop->timers);
+	BC_Free(loop->sources);
+	BC_Free(loop->posted);
+	BC_Free(loop->running);
+	BC_Free(loop);
+}
+
+// =========================================================
+// MARK: Running
+// =========================================================
+
+void BC_RunLoopRun(const BC_RunLoopRef loop) {
+	if (!loop) return;
+	while (!BC_atomic_load(&loop->stopped)) {
+		BC_RunLoopRunOnce(loop, BC_RUN_LOOP_WAIT_FOREVER);
+	}
+	BC_atomic_store(&loop->stopped, BC_false);
+}
+
+size_t BC_RunLoopRunOnce(const BC_RunLoopRef loop, const uint64_t timeoutNanoseconds) {
+	if (!loop) return 0;
+
+	const BC_RunLoopRef previous = gCurrentRunLoop;
+	gCurrentRunLoop = loop;
+	if (loop->hooks.iterationBegin) loop->hooks.iterationBegin();
+
+	// Sleeps until the earliest of the caller's timeout and the next wheel tick with work,
+	// rounded up to whole milliseconds so a timer is never woken for too early
+	uint64_t waitNanoseconds = timeoutNanoseconds;
+	if (loop->timerCount) {
+		const uint64_t due = loop->startNanoseconds + PRIV_WheelNextTick(loop) * BC_RUN_LOOP_TICK_NANOSECONDS;
+		const uint64_t now = BC_TimeMonotonicNanoseconds();
+		const uint64_t untilDue = due > now ? due - now : 0;
+		if (untilDue < waitNanoseconds) waitNanoseconds = untilDue;
+	}
+	const int timeoutMs = waitNanoseconds == BC_RUN_LOOP_WAIT_FOREVER ? -1
+		: waitNanoseconds >= (uint64_t)INT32_MAX * 1000000 ? INT32_MAX
+		: (int)((waitNanoseconds + 999999) / 1000000);
+
+	struct epoll_event events[BC_RUN_LOOP_MAX_EVENTS];
+	int ready = epoll_wait(loop->epollFd, events, BC_RUN_LOOP_MAX_EVENTS, timeoutMs);
+	if (ready < 0) {
+		if (errno != EINTR) fprintf(stderr, "BC_RunLoopRunOnce: epoll_wait failed (errno %d)\n", errno);
+		ready = 0;
+	}
+
+	size_t handled = 0;
+	for (int i = 0; i < ready; i++) {
+		const uint64_t tag = events[i].data.u64;
+		if (tag == PRIV_WAKE_TAG) {
+			uint64_t value;
+			while (read(loop->wakeFd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+			continue;
+		}
+
+		// Looked up again for every event, an earlier handler may have removed the source
+		const PRIV_RunLoopSource* source = PRIV_SourceGet(loop, tag);
+		if (!source) continue;
+		source->func(source->fd, PRIV_RunLoopEvents(events[i].events), source->arg);
+		handled++;
+	}
+
+	handled += PRIV_WheelAdvance(loop, PRIV_WheelTickNow(loop));
+	handled += PRIV_RunLoopRunPosted(loop);
+
+	if (loop->hooks.iterationEnd) loop->hooks.iterationEnd();
+	gCurrentRunLoop = previous;
+	return handled;
+}
+
+void BC_RunLoopStop(const BC_RunLoopRef loop) {
+	if (!loop) return;
+	BC_atomic_store(&loop->stopped, BC_true);
+	// From a handler the flag is seen once the iteration ends, no need to interrupt a wait
+	if (gCurrentRunLoop != loop) PRIV_RunLoopWake(loop);
+}
+
+void BC_RunLoopWakeUp(const BC_RunLoopRef loop) {
+	if (!loop) return;
+	PRIV_RunLoopWake(loop);
+}
+
+// =========================================================
+// MARK: Sources
+// =========================================================
+
+BC_RunLoopSourceId BC_RunLoopAddSource(const BC_RunLoopRef loop, const int fd, const uint32_t events, const BC_RunLoopSourceFunc func, void* arg) {
+	if (!loop || fd < 0 || !func) return 0;
+
+	if (loop->sourceFree == PRIV_NIL) {
+		const uint32_t oldCapacity = loop->sourceCapacity;
+		if (!PRIV_RunLoopGrow((void**)&loop->sources, &loop->sourceCapacity, sizeof(PRIV_RunLoopSource))) {
+			fprintf(stderr, "BC_RunLoopAddSource: Failed to grow the source table\n");
+			return 0;
+		}
+		for (uint32_t i = loop->sourceCapacity; i-- > oldCapacity;) {
+			loop->sources[i] = (PRIV_RunLoopSource){.generation = 1, .nextFree = loop->sourceFree};
+			loop->sourceFree = i;
+		}
+	}
+
+	const uint32_t index = loop->sourceFree;
+	PRIV_RunLoopSource* source = &loop->sources[index];
+	const BC_RunLoopSourceId id = PRIV_IdMake(source->generation, index);
+
+	struct epoll_event event = {.events = PRIV_EpollEvents(events), .data.u64 = id};
+	if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+		fprintf(stderr, "BC_RunLoopAddSource: Failed to watch fd %d (errno %d)\n", fd, errno);
+		return 0;
+	}
+
+	loop->sourceFree = source->nextFree;
+	source->fd = fd;
+	source->events = events;
+	source->func = func;
+	source->arg = arg;
+	source->active = BC_true;
+	return id;
+}
+
+BC_bool BC_RunLoopModifySource(const BC_RunLoopRef loop, const BC_RunLoopSourceId source, const uint32_t events) {
+	PRIV_RunLoopSource* entry = loop ? PRIV_SourceGet(loop, source) : NULL;
+	if (!entry) return BC_false;
+
+	struct epoll_event event = {.events = PRIV_EpollEvents(events), .data.u64 = source};
+	if (epoll_ctl(loop->epollFd, EPOLL_CTL_MOD, entry->fd, &event) != 0) {
+		fprintf(stderr, "BC_RunLoopModifySource: Failed to modify fd %d (errno %d)\n", entry->fd, errno);
+		return BC_false;
+	}
+	entry->events = events;
+	return BC_true;
+}
+
+void BC_RunLoopRemoveSource(const BC_RunLoopRef loop, const BC_RunLoopSourceId source) {
+	PRIV_RunLoopSource* entry = loop ? PRIV_SourceGet(loop, source) : NULL;
+	if (!entry) return;
+
+	epoll_ctl(loop->epollFd, EPOLL_CTL_DEL, entry->fd, NULL);
+	entry->active = BC_false;
+	if (++entry->generation == 0) entry->generation = 1;
+	entry->nextFree = loop->sourceFree;
+	loop->sourceFree = PRIV_IdIndex(source);
+}
+
+// =========================================================
+// MARK: Timers
+// =========================================================
+
+BC_RunLoopTimerId BC_RunLoopAddTimer(const BC_RunLoopRef loop, const uint64_t delayNanoseconds, const uint64_t intervalNanoseconds, const BC_RunLoopFunc func, void* arg) {
+	if (!loop || !func) return 0;
+
+	if (loop->timerFree == PRIV_NIL) {
+		const uint32_t oldCapacity = loop->timerCapacity;
+		if (!PRIV_RunLoopGrow((void**)&loop->timers, &loop->timerCapacity, sizeof(PRIV_RunLoopTimer))) {
+			fprintf(stderr, "BC_RunLoopAddTimer: Failed to grow the timer table\n");
+			return 0;
+		}
+		for (uint32_t i = loop->timerCapacity; i-- > oldCapacity;) {
+			loop->timers[i] = (PRIV_RunLoopTimer){.generation = 1, .next = loop->timerFree};
+			loop->timerFree = i;
+		}
+	}
+
+	// The wheel may lag behind the clock while the loop is busy, catch it up first so the
+	// deadline is measured from now
+	const uint64_t now = BC_TimeMonotonicNanoseconds() - loop->startNanoseconds;
+	const uint64_t tickNow = now / BC_RUN_LOOP_TICK_NANOSECONDS;
+	if (loop->timerCount == 0 && loop->currentTick < tickNow) loop->currentTick = tickNow;
+
+	const uint32_t index = loop->timerFree;
+	PRIV_RunLoopTimer* timer = &loop->timers[index];
+	loop->timerFree = timer->next;
+	loop->timerCount++;
+
+	// Delays close to UINT64_MAX saturate instead of wrapping into the past
+	const uint64_t deadline = delayNanoseconds > UINT64_MAX - now ? UINT64_MAX : now + delayNanoseconds;
+	const uint64_t expires = deadline / BC_RUN_LOOP_TICK_NANOSECONDS + (deadline % BC_RUN_LOOP_TICK_NANOSECONDS != 0);
+	const uint64_t interval = intervalNanoseconds / BC_RUN_LOOP_TICK_NANOSECONDS + (intervalNanoseconds % BC_RUN_LOOP_TICK_NANOSECONDS != 0);
+	timer->expires = expires > loop->currentTick ? expires : loop->currentTick + 1;
+	timer->interval = intervalNanoseconds && !interval ? 1 : interval;
+	timer->func = func;
+	timer->arg = arg;
+	timer->active = BC_true;
+	PRIV_WheelLink(loop, index);
+	return PRIV_IdMake(timer->generation, index);
+}
+
+BC_bool BC_RunLoopCancelTimer(const BC_RunLoopRef loop, const BC_RunLoopTimerId timer) {
+	const uint32_t index = PRIV_IdIndex(timer);
+	if (!loop || timer == 0 || index >= loop->timerCapacity) return BC_false;
+	const PRIV_RunLoopTimer* entry = &loop->timers[index];
+	if (!entry->active || entry->generation != PRIV_IdGeneration(timer)) return BC_false;
+
+	PRIV_WheelUnlink(loop, index);
+	PRIV_TimerFree(loop, index);
+	return BC_true;
+}
+
+// =========================================================
+// MARK: Posting
+// =========================================================
+
+BC_bool BC_RunLoopPost(const BC_RunLoopRef loop, const BC_RunLoopFunc func, void* arg) {
+	if (!loop || !func) return BC_false;
+
+	BC_MutexLock(&loop->postLock);
+	if (loop->postedCount == loop->postedCapacity) {
+		const size_t capacity = loop->postedCapacity ? loop->postedCapacity * 2 : 16;
+		PRIV_RunLoopTask* grown = BC_Realloc(loop->posted, capacity * sizeof(PRIV_RunLoopTask));
+		if (!grown) {
+			BC_MutexUnlock(&loop->postLock);
+			fprintf(stderr, "BC_RunLoopPost: Failed to grow the task queue\n");
+			return BC_false;
+		}
+		loop->posted = grown;
+		loop->postedCapacity = capacity;
+	}
+	loop->posted[loop->postedCount++] = (PRIV_RunLoopTask){func, arg};
+	const BC_bool first = loop->postedCount == 1;
+	BC_MutexUnlock(&loop->postLock);
+
+	// Later posts find the loop woken already
+	if (first) PRIV_RunLoopWake(loop);
+	return BC_true;
+}
+
+#else
+
+// =========================================================
+// MARK: Unsupported
+// =========================================================
+
+BC_RunLoopRef BC_RunLoopCreate(void) {
+	fprintf(stderr, "BC_RunLoopCreate: Run loops are not supported on this platform\n");
+	return NULL;
+}
+
+void BC_RunLoopDestroy(const BC_RunLoopRef loop) { (void)loop; }
+void BC_RunLoopRun(const BC_RunLoopRef loop) { (void)loop; }
+size_t BC_RunLoopRunOnce(const BC_RunLoopRef loop, const uint64_t timeoutNanoseconds) { (void)loop; (void)timeoutNanoseconds; return 0; }
+void BC_RunLoopStop(const BC_RunLoopRef loop) { (void)loop; }
+void BC_RunLoopWakeUp(const BC_RunLoopRef loop) { (void)loop; }
+
+BC_RunLoopSourceId BC_RunLoopAddSource(const BC_RunLoopRef loop, const int fd, const uint32_t events, const BC_RunLoopSourceFunc func, void* arg) {
+	(void)loop; (void)fd; (void)events; (void)func; (void)arg;
+	return 0;
+}
+
+BC_bool BC_RunLoopModifySource(const BC_RunLoopRef loop, const BC_RunLoopSourceId source, const uint32_t events) {
+	(void)loop; (void)source; (void)events;
+	return BC_false;
+}
+
+void BC_RunLoopRemoveSource(const BC_RunLoopRef loop, const BC_RunLoopSourceId source) { (void)loop; (void)source; }
+
+BC_RunLoopTimerId BC_RunLoopAddTimer(const BC_RunLoopRef loop, const uint64_t delayNanoseconds, const uint64_t intervalNanoseconds, const BC_RunLoopFunc func, void* arg) {
+	(void)loop; (void)delayNanoseconds; (void)intervalNanoseconds; (void)func; (void)arg;
+	return 0;
+}
+
+BC_bool BC_RunLoopCancelTimer(const BC_RunLoopRef loop, const BC_RunLoopTimerId timer) {
+	(void)loop; (void)timer;
+	return BC_false;
+}
+
+BC_bool BC_RunLoopPost(const BC_RunLoopRef loop, const BC_RunLoopFunc func, void* arg) {
+	(void)loop; (void)func; (void)arg;
+	return BC_false;
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef BCORE_RUN_LOOP_H
+#define BCORE_RUN_LOOP_H
+
+#include "../BC_Types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Timer resolution, timers never fire early and at most one tick late when the loop is idle
+#define BC_RUN_LOOP_TICK_NANOSECONDS 1000000
+
+// Ready file descriptors handled per wait, more are picked up on the next iteration
+#define BC_RUN_LOOP_MAX_EVENTS 64
+
+#define BC_RUN_LOOP_WAIT_FOREVER UINT64_MAX
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef enum {
+	BC_RunLoopEventReadable = 1 << 0,
+	BC_RunLoopEventWritable = 1 << 1,
+	BC_RunLoopEventError = 1 << 2,    // Reported whether asked for or not
+	BC_RunLoopEventHangup = 1 << 3    // Reported whether asked for or not
+} BC_RunLoopEvent;
+
+// 0 is never a valid id
+typedef uint64_t BC_RunLoopSourceId;
+typedef uint64_t BC_RunLoopTimerId;
+
+typedef void (*BC_RunLoopFunc)(void* arg);
+typedef void (*BC_RunLoopSourceFunc)(int fd, uint32_t events, void* arg);
+
+// Called on the thread running the loop, any of them can be NULL. BFramework drains an
+// autorelease pool around every iteration this way.
+typedef struct BC_RunLoopHooks {
+	void (*iterationBegin)(void);  // Before waiting
+	void (*iterationEnd)(void);    // After every handler of the iteration ran
+} BC_RunLoopHooks;
+
+// =========================================================
+// MARK: Run Loop
+// =========================================================
+
+// Event loop waiting on file descriptors, timers and tasks posted from other threads. It
+// sleeps in the kernel until one of them is due instead of polling. One thread runs a loop at
+// a time and every handler runs on it, only BC_RunLoopPost, BC_RunLoopStop and
+// BC_RunLoopWakeUp can be called from other threads. Timers live in a hierarchical wheel,
+// adding and cancelling is constant time whatever the number of timers. Linux only for now
+// (epoll and eventfd), creating a loop fails elsewhere.
+
+// Hooks are the ones set when the loop is created
+BC_RunLoopRef BC_RunLoopCreate(void);
+
+// Drops sources, timers and posted tasks without running them, the descriptors stay open
+void BC_RunLoopDestroy(BC_RunLoopRef loop);
+
+// Loop running on the calling thread, NULL outside of a handler or a run
+BC_RunLoopRef BC_RunLoopCurrent(void);
+
+// Replaces the hooks for loops created from now on
+void BC_RunLoopSetHooks(const BC_RunLoopHooks* hooks);
+
+// =========================================================
+// MARK: Running
+// =========================================================
+
+// Runs iterations until BC_RunLoopStop is called
+void BC_RunLoopRun(BC_RunLoopRef loop);
+
+// One iteration: waits at most `timeoutNanoseconds` for something to be ready, then runs the
+// ready sources, the due timers and the posted tasks. Returns how many handlers ran. Can be
+// called from a handler of the same loop, posted tasks the outer iteration took keep running
+// once the nested one returns.
+size_t BC_RunLoopRunOnce(BC_RunLoopRef loop, uint64_t timeoutNanoseconds);
+
+// Makes BC_RunLoopRun return after the current iteration, from any thread
+void BC_RunLoopStop(BC_RunLoopRef loop);
+
+// Interrupts the wait of the loop, from any thread
+void BC_RunLoopWakeUp(BC_RunLoopRef loop);
+
+// =========================================================
+// MARK: Sources
+// =========================================================
+
+// Calls `func` whenever `fd` is ready for `events`, level triggered. Returns 0 on failure.
+BC_RunLoopSourceId BC_RunLoopAddSource(BC_RunLoopRef loop, int fd, uint32_t events, BC_RunLoopSourceFunc func, void* arg);
+BC_bool BC_RunLoopModifySource(BC_RunLoopRef loop, BC_RunLoopSourceId source, uint32_t events);
+
+// Safe from inside any handler, the source is not called anymore even if already ready.
+// Remove a source before closing its descriptor.
+void BC_RunLoopRemoveSource(BC_RunLoopRef loop, BC_RunLoopSourceId source);
+
+// =========================================================
+// MARK: Timers
+// =========================================================
+
+// Calls `func` after `delayNanoseconds`, then every `intervalNanoseconds` unless it is 0.
+// A periodic timer late by several intervals fires once and keeps its phase. Delays past the
+// range of the monotonic clock saturate, such a timer never fires.
+BC_RunLoopTimerId BC_RunLoopAddTimer(BC_RunLoopRef loop, uint64_t delayNanoseconds, uint64_t intervalNanoseconds, BC_RunLoopFunc func, void* arg);
+
+// Safe from inside any handler including the timer's own, returns BC_false when the timer
+// already fired or was cancelled
+BC_bool BC_RunLoopCancelTimer(BC_RunLoopRef loop, BC_RunLoopTimerId timer);
+
+// =========================================================
+// MARK: Posting
+// =========================================================
+
+// Queues `func` to run on the loop's thread during its next iteration and wakes it, from any
+// thread. Tasks run in the order they were posted.
+BC_bool BC_RunLoopPost(BC_RunLoopRef loop, BC_RunLoopFunc func, void* arg);
+
+#endif //BCORE_RUN_LOOP_H
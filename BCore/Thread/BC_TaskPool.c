@@ -0,0 +1,539 @@
+#include "BC_TaskPool.h"
+
+#include "BC_Threads.h"
+#include "../BC_Keywords.h"
+#include "../Memory/BC_Allocator.h"
+#include "../Memory/BC_Memory.h"
+#include "../Memory/BC_Pool.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// =========================================================
+// MARK: Hooks
+// =========================================================
+
+static BC_TaskPoolHooks gTaskPoolHooks = {NULL, NULL, NULL};
+
+void BC_TaskPoolSetHooks(const BC_TaskPoolHooks* hooks) {
+	if (hooks) {
+		gTaskPoolHooks = *hooks;
+	} else {
+		gTaskPoolHooks = (BC_TaskPoolHooks){NULL, NULL, NULL};
+	}
+}
+
+static size_t PRIV_TaskPoolGrainSize(const size_t count, const size_t threadCount, const size_t grainSize) {
+	if (grainSize > 0) return grainSize;
+	const size_t grain = count / (threadCount * 4);
+	return grain > 0 ? grain : 1;
+}
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+#include <stdatomic.h>
+
+// =========================================================
+// MARK: Structures
+// =========================================================
+
+// Failed searches before an idle thread blocks
+#define PRIV_TASK_POOL_SPIN_COUNT 64
+
+typedef struct PRIV_Task {
+	struct PRIV_Task* next;        // Link in the shared queue
+	BC_TaskFunc func;
+	BC_TaskRangeFunc rangeFunc;    // Set for parallel for chunks, which split again before running
+	void* arg;
+	BC_TaskGroup* group;
+	size_t begin;
+	size_t end;
+	size_t grainSize;
+} PRIV_Task;
+
+typedef struct PRIV_DequeBuffer {
+	struct PRIV_DequeBuffer* previous;  // Outgrown buffers stay alive until destroy, a thief may still read them
+	int64_t mask;
+	_Atomic(PRIV_Task*) slots[];
+} PRIV_DequeBuffer;
+
+// Chase-Lev deque, the owner works at the bottom and thieves take from the top
+typedef struct PRIV_Worker {
+	_Alignas(BC_CACHE_LINE_SIZE) atomic_int_fast64_t top;
+	_Alignas(BC_CACHE_LINE_SIZE) atomic_int_fast64_t bottom;
+	_Atomic(PRIV_DequeBuffer*) buffer;
+	BC_TaskPoolRef pool;
+	BCThread thread;
+	uint64_t random;  // Picks the first victim to steal from
+} PRIV_Worker;
+
+typedef struct BC_TaskPool {
+	PRIV_Worker* workers;
+	size_t workerCount;
+	size_t threadCount;           // Workers actually running
+	BC_PoolRef tasks;
+	BCMutex lock;                 // Guards the shared queue and parking
+	BCCondition wake;
+	BCCondition done;             // Group waiters block on it until a task is queued or a group finishes
+	PRIV_Task* sharedHead;
+	PRIV_Task* sharedTail;
+	atomic_size_t sharedCount;
+	atomic_size_t queued;         // Tasks waiting in a deque or the shared queue
+	atomic_size_t sleepers;
+	atomic_size_t waiters;        // Threads blocked in BC_TaskGroupWait
+	atomic_bool running;
+} BC_TaskPool;
+
+static BC_TLS PRIV_Worker* gCurrentWorker = NULL;
+
+// =========================================================
+// MARK: Deque
+// =========================================================
+
+static PRIV_DequeBuffer* PRIV_DequeBufferCreate(const int64_t capacity) {
+	PRIV_DequeBuffer* buffer = BC_Malloc(sizeof(PRIV_DequeBuffer) + (size_t)capacity * sizeof(_Atomic(PRIV_Task*)));
+	if (!buffer) return NULL;
+	buffer->previous = NULL;
+	buffer->mask = capacity - 1;
+	return buffer;
+}
+
+static BC_bool PRIV_DequePush(PRIV_Worker* worker, PRIV_Task* task) {
+	const int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+	const int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+	PRIV_DequeBuffer* buffer = atomic_load_explicit(&worker->buffer, memory_order_relaxed);
+
+	if (bottom - top > buffer->mask) {
+		PRIV_DequeBuffer* grown = PRIV_DequeBufferCreate((buffer->mask + 1) * 2);
+		if (!grown) return BC_false;
+		for (int64_t i = top; i < bottom; i++) {
+			atomic_store_explicit(&grown->slots[i & grown->mask], atomic_load_explicit(&buffer->slots[i & buffer->mask], memory_order_relaxed), memory_order_relaxed);
+		}
+		grown->previous = buffer;
+		atomic_store_explicit(&worker->buffer, grown, memory_order_release);
+		buffer = grown;
+	}
+
+	atomic_store_explicit(&buffer->slots[bottom & buffer->mask], task, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+	return BC_true;
+}
+
+static PRIV_Task* PRIV_DequePop(PRIV_Worker* worker) {
+	const int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+	PRIV_DequeBuffer* buffer = atomic_load_explicit(&worker->buffer, memory_order_relaxed);
+	atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+	if (top > bottom) {
+		atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+		return NULL;
+	}
+
+	PRIV_Task* task = atomic_load_explicit(&buffer->slots[bottom & buffer->mask], memory_order_relaxed);
+	if (top == bottom) {
+		// Last task, race the thieves for it
+		if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+			task = NULL;
+		}
+		atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+	}
+	return task;
+}
+
+static PRIV_Task* PRIV_DequeSteal(PRIV_Worker* worker) {
+	int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	const int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_acquire);
+	if (top >= bottom) return NULL;
+
+	PRIV_DequeBuffer* buffer = atomic_load_explicit(&worker->buffer, memory_order_acquire);
+	PRIV_Task* task = atomic_load_explicit(&buffer->slots[top & buffer->mask], memory_order_relaxed);
+	if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+		return NULL;
+	}
+	return task;
+}
+
+// =========================================================
+// MARK: Scheduling
+// =========================================================
+
+static inline PRIV_Worker* PRIV_TaskPoolCurrentWorker(const BC_TaskPoolRef pool) {
+	return gCurrentWorker && gCurrentWorker->pool == pool ? gCurrentWorker : NULL;
+}
+
+static void PRIV_TaskPoolWake(const BC_TaskPoolRef pool) {
+	const BC_bool sleepers = atomic_load(&pool->sleepers) > 0;
+	const BC_bool waiters = atomic_load(&pool->waiters) > 0;
+	if (!sleepers && !waiters) return;
+	BC_MutexLock(&pool->lock);
+	if (sleepers) BC_ConditionSignal(&pool->wake);
+	// A waiter may be the only thread able to run the task, when it waits from inside a task
+	if (waiters) BC_ConditionBroadcast(&pool->done);
+	BC_MutexUnlock(&pool->lock);
+}
+
+static void PRIV_TaskPoolPush(const BC_TaskPoolRef pool, PRIV_Task* task) {
+	if (task->group) atomic_fetch_add_explicit(&task->group->pending, 1, memory_order_relaxed);
+
+	// Counted before it is visible so idle workers never park while it is on its way
+	atomic_fetch_add(&pool->queued, 1);
+
+	PRIV_Worker* worker = PRIV_TaskPoolCurrentWorker(pool);
+	if (!worker || !PRIV_DequePush(worker, task)) {
+		task->next = NULL;
+		BC_MutexLock(&pool->lock);
+		if (pool->sharedTail) {
+			pool->sharedTail->next = task;
+		} else {
+			pool->sharedHead = task;
+		}
+		pool->sharedTail = task;
+		atomic_fetch_add(&pool->sharedCount, 1);
+		BC_MutexUnlock(&pool->lock);
+	}
+
+	PRIV_TaskPoolWake(pool);
+}
+
+static PRIV_Task* PRIV_TaskPoolFind(const BC_TaskPoolRef pool, PRIV_Worker* worker) {
+	PRIV_Task* task = worker ? PRIV_DequePop(worker) : NULL;
+
+	if (!task && atomic_load_explicit(&pool->sharedCount, memory_order_relaxed) > 0) {
+		BC_MutexLock(&pool->lock);
+		task = pool->sharedHead;
+		if (task) {
+			pool->sharedHead = task->next;
+			if (!pool->sharedHead) pool->sharedTail = NULL;
+			atomic_fetch_sub(&pool->sharedCount, 1);
+		}
+		BC_MutexUnlock(&pool->lock);
+	}
+
+	if (!task && pool->workerCount > 0) {
+		// Start from a random victim so thieves spread over the workers
+		size_t start = 0;
+		if (worker) {
+			worker->random ^= worker->random << 13;
+			worker->random ^= worker->random >> 7;
+			worker->random ^= worker->random << 17;
+			start = (size_t)(worker->random % pool->workerCount);
+		}
+		for (size_t i = 0; i < pool->workerCount && !task; i++) {
+			PRIV_Worker* victim = &pool->workers[(start + i) % pool->workerCount];
+			if (victim != worker) task = PRIV_DequeSteal(victim);
+		}
+	}
+
+	if (task) atomic_fetch_sub(&pool->queued, 1);
+	return task;
+}
+
+static void PRIV_TaskPoolSplit(BC_TaskPoolRef pool, BC_TaskGroup* group, size_t begin, size_t end, size_t grainSize, BC_TaskRangeFunc func, void* arg);
+
+static void PRIV_TaskPoolRun(const BC_TaskPoolRef pool, PRIV_Task* task) {
+	const PRIV_Task copy = *task;
+	BC_AllocatorFree(BC_PoolAllocator(pool->tasks), task);
+
+	if (gTaskPoolHooks.taskBegin) gTaskPoolHooks.taskBegin();
+	if (copy.rangeFunc) {
+		PRIV_TaskPoolSplit(pool, copy.group, copy.begin, copy.end, copy.grainSize, copy.rangeFunc, copy.arg);
+	} else {
+		copy.func(copy.arg);
+	}
+	if (gTaskPoolHooks.taskEnd) gTaskPoolHooks.taskEnd();
+
+	// The group may be gone as soon as pending reaches zero, only the pool is touched past it
+	if (copy.group && atomic_fetch_sub(&copy.group->pending, 1) == 1 && atomic_load(&pool->waiters) > 0) {
+		BC_MutexLock(&pool->lock);
+		BC_ConditionBroadcast(&pool->done);
+		BC_MutexUnlock(&pool->lock);
+	}
+}
+
+static PRIV_Task* PRIV_TaskPoolNewTask(const BC_TaskPoolRef pool, BC_TaskGroup* group) {
+	PRIV_Task* task = BC_AllocatorAlloc(BC_PoolAllocator(pool->tasks), sizeof(PRIV_Task));
+	if (!task) return NULL;
+	memset(task, 0, sizeof(PRIV_Task));
+	task->group = group;
+	return task;
+}
+
+static void PRIV_TaskPoolSplit(const BC_TaskPoolRef pool, BC_TaskGroup* group, const size_t begin, size_t end, const size_t grainSize, const BC_TaskRangeFunc func, void* arg) {
+	// Hand out the upper half until the rest is a single chunk, thieves get the largest pieces
+	while (end - begin > grainSize) {
+		const size_t middle = begin + (end - begin) / 2;
+		PRIV_Task* task = PRIV_TaskPoolNewTask(pool, group);
+		if (!task) break;
+		task->rangeFunc = func;
+		task->arg = arg;
+		task->begin = middle;
+		task->end = end;
+		task->grainSize = grainSize;
+		PRIV_TaskPoolPush(pool, task);
+		end = middle;
+	}
+	func(begin, end, arg);
+}
+
+// =========================================================
+// MARK: Worker
+// =========================================================
+
+static void PRIV_TaskPoolWorkerMain(void* arg) {
+	PRIV_Worker* worker = arg;
+	const BC_TaskPoolRef pool = worker->pool;
+	gCurrentWorker = worker;
+
+	size_t idle = 0;
+	for (;;) {
+		PRIV_Task* task = PRIV_TaskPoolFind(pool, worker);
+		if (task) {
+			PRIV_TaskPoolRun(pool, task);
+			idle = 0;
+			continue;
+		}
+		if (!atomic_load(&pool->running)) break;
+		if (++idle < PRIV_TASK_POOL_SPIN_COUNT) {
+			BC_ThreadYield();
+			continue;
+		}
+
+		// Sleepers is raised before queued is read, pushers do the opposite, so one of them sees the other
+		BC_MutexLock(&pool->lock);
+		atomic_fetch_add(&pool->sleepers, 1);
+		while (atomic_load(&pool->queued) == 0 && atomic_load(&pool->running)) {
+			BC_ConditionWait(&pool->wake, &pool->lock);
+		}
+		atomic_fetch_sub(&pool->sleepers, 1);
+		BC_MutexUnlock(&pool->lock);
+		idle = 0;
+	}
+
+	gCurrentWorker = NULL;
+	if (gTaskPoolHooks.threadStop) gTaskPoolHooks.threadStop();
+}
+
+// =========================================================
+// MARK: Public API
+// =========================================================
+
+BC_TaskPoolRef BC_TaskPoolCreate(size_t workerCount) {
+	if (workerCount == 0) {
+		const size_t cpus = BC_ThreadHardwareConcurrency();
+		workerCount = cpus > 1 ? cpus - 1 : 1;
+	}
+
+	const BC_TaskPoolRef pool = BC_Calloc(1, sizeof(BC_TaskPool));
+	if (!pool) {
+		fprintf(stderr, "BC_TaskPoolCreate: Failed to allocate task pool structure\n");
+		return NULL;
+	}
+
+	pool->tasks = BC_PoolCreate(kBC_AllocatorRefSystem, sizeof(PRIV_Task), BC_TASK_POOL_DEQUE_CAPACITY);
+	pool->workers = BC_AllocatorAllocAligned(kBC_AllocatorRefSystem, workerCount * sizeof(PRIV_Worker), BC_CACHE_LINE_SIZE);
+	if (!pool->tasks || !pool->workers) {
+		fprintf(stderr, "BC_TaskPoolCreate: Failed to allocate %zu workers\n", workerCount);
+		BC_PoolDestroy(pool->tasks);
+		BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, pool->workers);
+		BC_Free(pool);
+		return NULL;
+	}
+	memset(pool->workers, 0, workerCount * sizeof(PRIV_Worker));
+
+	BC_MutexInit(&pool->lock);
+	BC_ConditionInit(&pool->wake);
+	BC_ConditionInit(&pool->done);
+	atomic_store(&pool->running, BC_true);
+
+	for (size_t i = 0; i < workerCount; i++) {
+		PRIV_Worker* worker = &pool->workers[i];
+		atomic_store(&worker->buffer, PRIV_DequeBufferCreate(BC_TASK_POOL_DEQUE_CAPACITY));
+		worker->pool = pool;
+		worker->random = 0x9E3779B97F4A7C15ull * (i + 1);
+	}
+
+	// Deques are all in place before the first worker may try to steal, a worker that failed
+	// to start keeps an empty deque
+	pool->workerCount = workerCount;
+	for (size_t i = 0; i < workerCount; i++) {
+		if (!BC_ThreadCreate(&pool->workers[i].thread, PRIV_TaskPoolWorkerMain, &pool->workers[i])) break;
+		pool->threadCount++;
+	}
+
+	return pool;
+}
+
+void BC_TaskPoolDestroy(const BC_TaskPoolRef pool) {
+	if (!pool) return;
+
+	BC_MutexLock(&pool->lock);
+	atomic_store(&pool->running, BC_false);
+	BC_ConditionBroadcast(&pool->wake);
+	BC_MutexUnlock(&pool->lock);
+
+	for (size_t i = 0; i < pool->threadCount; i++) {
+		BC_ThreadJoin(pool->workers[i].thread);
+	}
+
+	// Workers empty their own deques before leaving, only late shared tasks can be left
+	PRIV_Task* task;
+	while ((task = PRIV_TaskPoolFind(pool, NULL))) {
+		PRIV_TaskPoolRun(pool, task);
+	}
+
+	for (size_t i = 0; i < pool->workerCount; i++) {
+		PRIV_DequeBuffer* buffer = atomic_load(&pool->workers[i].buffer);
+		while (buffer) {
+			PRIV_DequeBuffer* previous = buffer->previous;
+			BC_Free(buffer);
+			buffer = previous;
+		}
+	}
+
+	BC_ConditionDestroy(&pool->done);
+	BC_ConditionDestroy(&pool->wake);
+	BC_MutexDestroy(&pool->lock);
+	BC_PoolDestroy(pool->tasks);
+	BC_AllocatorFreeAligned(kBC_AllocatorRefSystem, pool->workers);
+	BC_Free(pool);
+}
+
+size_t BC_TaskPoolWorkerCount(const BC_TaskPoolRef pool) {
+	if (!pool) return 0;
+	return pool->threadCount;
+}
+
+BC_bool BC_TaskPoolSubmit(const BC_TaskPoolRef pool, BC_TaskGroup* group, const BC_TaskFunc func, void* arg) {
+	if (!pool || !func) return BC_false;
+
+	PRIV_Task* task = PRIV_TaskPoolNewTask(pool, group);
+	if (!task) {
+		fprintf(stderr, "BC_TaskPoolSubmit: Failed to allocate task\n");
+		return BC_false;
+	}
+	task->func = func;
+	task->arg = arg;
+	PRIV_TaskPoolPush(pool, task);
+	return BC_true;
+}
+
+void BC_TaskGroupWait(const BC_TaskPoolRef pool, BC_TaskGroup* group) {
+	if (!pool || !group) return;
+
+	PRIV_Worker* worker = PRIV_TaskPoolCurrentWorker(pool);
+	size_t idle = 0;
+	while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0) {
+		PRIV_Task* task = PRIV_TaskPoolFind(pool, worker);
+		if (task) {
+			PRIV_TaskPoolRun(pool, task);
+			idle = 0;
+		} else if (++idle < PRIV_TASK_POOL_SPIN_COUNT) {
+			BC_ThreadYield();
+		} else {
+			// The last tasks of the group run elsewhere, block until one of them finishes the
+			// group or queues more work. Waiters is raised before pending is read, the finishing
+			// task does the opposite, so one of them sees the other.
+			BC_MutexLock(&pool->lock);
+			atomic_fetch_add(&pool->waiters, 1);
+			while (atomic_load(&group->pending) > 0 && atomic_load(&pool->queued) == 0) {
+				BC_ConditionWait(&pool->done, &pool->lock);
+			}
+			atomic_fetch_sub(&pool->waiters, 1);
+			BC_MutexUnlock(&pool->lock);
+			idle = 0;
+		}
+	}
+}
+
+void BC_TaskPoolParallelFor(const BC_TaskPoolRef pool, const size_t begin, const size_t end, const size_t grainSize, const BC_TaskRangeFunc func, void* arg) {
+	if (!pool || !func || end <= begin) return;
+
+	// The caller runs the first chunk itself, as a task like the others
+	BC_TaskGroup group = BC_TASK_GROUP_INIT;
+	if (gTaskPoolHooks.taskBegin) gTaskPoolHooks.taskBegin();
+	PRIV_TaskPoolSplit(pool, &group, begin, end, PRIV_TaskPoolGrainSize(end - begin, pool->threadCount + 1, grainSize), func, arg);
+	if (gTaskPoolHooks.taskEnd) gTaskPoolHooks.taskEnd();
+	BC_TaskGroupWait(pool, &group);
+}
+
+#else
+
+// =========================================================
+// MARK: Inline Pool
+// =========================================================
+
+// Without thread safety every task runs on the caller as soon as it is submitted
+typedef struct BC_TaskPool {
+	size_t workerCount;
+} BC_TaskPool;
+
+BC_TaskPoolRef BC_TaskPoolCreate(const size_t workerCount) {
+	(void)workerCount;
+	return BC_Calloc(1, sizeof(BC_TaskPool));
+}
+
+void BC_TaskPoolDestroy(const BC_TaskPoolRef pool) {
+	BC_Free(pool);
+}
+
+size_t BC_TaskPoolWorkerCount(const BC_TaskPoolRef pool) {
+	(void)pool;
+	return 0;
+}
+
+BC_bool BC_TaskPoolSubmit(const BC_TaskPoolRef pool, BC_TaskGroup* group, const BC_TaskFunc func, void* arg) {
+	(void)group;
+	if (!pool || !func) return BC_false;
+
+	if (gTaskPoolHooks.taskBegin) gTaskPoolHooks.taskBegin();
+	func(arg);
+	if (gTaskPoolHooks.taskEnd) gTaskPoolHooks.taskEnd();
+	return BC_true;
+}
+
+void BC_TaskGroupWait(const BC_TaskPoolRef pool, BC_TaskGroup* group) {
+	(void)pool;
+	(void)group;
+}
+
+void BC_TaskPoolParallelFor(const BC_TaskPoolRef pool, size_t begin, const size_t end, const size_t grainSize, const BC_TaskRangeFunc func, void* arg) {
+	if (!pool || !func || end <= begin) return;
+
+	const size_t grain = PRIV_TaskPoolGrainSize(end - begin, 1, grainSize);
+	while (begin < end) {
+		const size_t chunkEnd = end - begin > grain ? begin + grain : end;
+		if (gTaskPoolHooks.taskBegin) gTaskPoolHooks.taskBegin();
+		func(begin, chunkEnd, arg);
+		if (gTaskPoolHooks.taskEnd) gTaskPoolHooks.taskEnd();
+		begin = chunkEnd;
+	}
+}
+
+#endif
+
+// =========================================================
+// MARK: Shared Pool
+// =========================================================
+
+static BC_TaskPoolRef gTaskPoolShared = NULL;
+BC_ONCE_MAYBE_STATIC(gTaskPoolSharedOnce)
+
+static void PRIV_TaskPoolSharedSetup(void) {
+	// Without thread safety BC_RunOnce calls this every time
+	if (!gTaskPoolShared) gTaskPoolShared = BC_TaskPoolCreate(0);
+}
+
+BC_TaskPoolRef BC_TaskPoolShared(void) {
+	BC_RunOnce(&gTaskPoolSharedOnce, PRIV_TaskPoolSharedSetup);
+	return gTaskPoolShared;
+}
+
+void INTERNAL_BC_TaskPoolDeinitialize(void) {
+	BC_TaskPoolDestroy(gTaskPoolShared);
+	gTaskPoolShared = NULL;
+}
@@ -0,0 +1,73 @@
+#ifndef BCORE_TASK_POOL_H
+#define BCORE_TASK_POOL_H
+
+#include "BC_Atomics.h"
+#include "../BC_Types.h"
+
+#include <stddef.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Tasks each worker deque holds before it grows
+#define BC_TASK_POOL_DEQUE_CAPACITY 256
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef void (*BC_TaskFunc)(void* arg);
+typedef void (*BC_TaskRangeFunc)(size_t begin, size_t end, void* arg);
+
+// Counts the tasks submitted under it that have not finished yet, lives on the caller stack.
+// A group must not be reused while a wait on it is in progress.
+typedef struct BC_TaskGroup {
+	BC_atomic_size pending;
+} BC_TaskGroup;
+
+#define BC_TASK_GROUP_INIT {0}
+
+// Called on the threads running tasks, any of them can be NULL. Frameworks built on top of
+// BCore install them once, BFramework gives every task its own autorelease pool this way.
+typedef struct BC_TaskPoolHooks {
+	void (*threadStop)(void);  // On a worker thread right before it exits
+	void (*taskBegin)(void);   // Before every task, on workers, threads helping in a wait and parallel for callers
+	void (*taskEnd)(void);     // After every task
+} BC_TaskPoolHooks;
+
+// =========================================================
+// MARK: Task Pool
+// =========================================================
+
+// Work stealing pool, each worker owns a deque it pushes and pops at the bottom while idle
+// workers steal from the top of the others. Tasks submitted from outside the pool go through
+// a shared queue. `workerCount` 0 picks one worker per CPU but one, the waiting thread being
+// the last. Without thread safety no worker is started and tasks run right away on the caller.
+BC_TaskPoolRef BC_TaskPoolCreate(size_t workerCount);
+
+// Runs the tasks still queued, then stops and joins the workers
+void BC_TaskPoolDestroy(BC_TaskPoolRef pool);
+
+// Process wide pool created on first use, stopped by BC_Deinitialize
+BC_TaskPoolRef BC_TaskPoolShared(void);
+
+size_t BC_TaskPoolWorkerCount(BC_TaskPoolRef pool);
+
+// `group` can be NULL for fire and forget tasks
+BC_bool BC_TaskPoolSubmit(BC_TaskPoolRef pool, BC_TaskGroup* group, BC_TaskFunc func, void* arg);
+
+// Runs queued tasks on the calling thread until every task of `group` finished, so waiting
+// from inside a task does not starve the pool. Once nothing is left to help with it blocks
+// until the group finishes or more tasks are queued.
+void BC_TaskGroupWait(BC_TaskPoolRef pool, BC_TaskGroup* group);
+
+// Calls `func` over [begin, end) split in chunks of at most `grainSize` indices, returns once
+// every chunk ran. The range is split in halves so idle workers steal large pieces first.
+// `grainSize` 0 picks about four chunks per thread.
+void BC_TaskPoolParallelFor(BC_TaskPoolRef pool, size_t begin, size_t end, size_t grainSize, BC_TaskRangeFunc func, void* arg);
+
+// Replaces the hooks for tasks started from now on
+void BC_TaskPoolSetHooks(const BC_TaskPoolHooks* hooks);
+
+#endif //BCORE_TASK_POOL_H
@@ -1,5 +1,30 @@
 #include "BC_Threads.h"
 
+#include "../Memory/BC_Memory.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#if !defined(_WIN32)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PRIV_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define PRIV_CPU_RELAX() __asm__ __volatile__("yield")
+#elif defined(_WIN32)
+#define PRIV_CPU_RELAX() YieldProcessor()
+#else
+#define PRIV_CPU_RELAX() ((void)0)
+#endif
+
 // =========================================================
 // MARK: Mutex Implementation
 // =========================================================
@@ -78,6 +103,323 @@ void BC_SpinlockDestroy(BCSpinlock* sl) {
 #endif
 }
 
+// =========================================================
+// MARK: Adaptive Lock Implementation
+// =========================================================
+
+// Sleeps while *address still equals `expected`, may return early
+static void PRIV_FutexWait(BC_atomic_uint32* address, const uint32_t expected) {
+#if defined(__linux__)
+	syscall(SYS_futex, (uint32_t*)address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#elif defined(_WIN32)
+	uint32_t compare = expected;
+	WaitOnAddress((volatile VOID*)address, &compare, sizeof(compare), INFINITE);
+#else
+	// No portable address wait, give the holder the core instead
+	(void)address;
+	(void)expected;
+	BC_ThreadYield();
+#endif
+}
+
+static void PRIV_FutexWakeOne(BC_atomic_uint32* address) {
+#if defined(__linux__)
+	syscall(SYS_futex, (uint32_t*)address, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#elif defined(_WIN32)
+	WakeByAddressSingle((PVOID)address);
+#else
+	(void)address;
+#endif
+}
+
+static void PRIV_FutexWakeAll(BC_atomic_uint32* address) {
+#if defined(__linux__)
+	syscall(SYS_futex, (uint32_t*)address, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+#elif defined(_WIN32)
+	WakeByAddressAll((PVOID)address);
+#else
+	(void)address;
+#endif
+}
+
+void BC_LockInit(BCLock* lock) {
+	BC_atomic_store_relaxed(&lock->state, 0);
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_store_relaxed(&lock->acquisitions, 0);
+	BC_atomic_store_relaxed(&lock->contentions, 0);
+	BC_atomic_store_relaxed(&lock->waitNanoseconds, 0);
+#endif
+}
+
+BC_bool BC_LockTryLock(BCLock* lock) {
+	uint32_t expected = 0;
+	if (!BC_atomic_compare_exchange(&lock->state, &expected, 1)) return BC_false;
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_fetch_add(&lock->acquisitions, 1);
+#endif
+	return BC_true;
+}
+
+void BC_LockLock(BCLock* lock) {
+	uint32_t expected = 0;
+	if (BC_atomic_compare_exchange(&lock->state, &expected, 1)) {
+#if BC_SETTINGS_LOCK_STATS == 1
+		BC_atomic_fetch_add(&lock->acquisitions, 1);
+#endif
+		return;
+	}
+
+#if BC_SETTINGS_LOCK_STATS == 1
+	const uint64_t start = BC_TimeMonotonicNanoseconds();
+#endif
+
+	// Short critical sections usually end while spinning, which is cheaper than a sleep and a wake
+	BC_bool acquired = BC_false;
+	for (int i = 0; i < BC_LOCK_SPIN_COUNT && !acquired; i++) {
+		PRIV_CPU_RELAX();
+		expected = 0;
+		acquired = BC_atomic_load_relaxed(&lock->state) == 0 && BC_atomic_compare_exchange(&lock->state, &expected, 1);
+	}
+
+	// Marked 2 so the holder knows to wake someone, a waiter woken up marks it 2 again since
+	// other sleepers may remain
+	if (!acquired) {
+		while (BC_atomic_exchange(&lock->state, 2) != 0) {
+			PRIV_FutexWait(&lock->state, 2);
+		}
+	}
+
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_fetch_add(&lock->acquisitions, 1);
+	BC_atomic_fetch_add(&lock->contentions, 1);
+	BC_atomic_fetch_add(&lock->waitNanoseconds, (size_t)(BC_TimeMonotonicNanoseconds() - start));
+#endif
+}
+
+void BC_LockUnlock(BCLock* lock) {
+	if (BC_atomic_exchange(&lock->state, 0) == 2) {
+		PRIV_FutexWakeOne(&lock->state);
+	}
+}
+
+void BC_LockDestroy(BCLock* lock) {
+	(void)lock;
+}
+
+void BC_LockGetStats(BCLock* lock, BC_LockStats* stats) {
+	if (!stats) return;
+#if BC_SETTINGS_LOCK_STATS == 1
+	stats->acquisitions = BC_atomic_load_relaxed(&lock->acquisitions);
+	stats->contentions = BC_atomic_load_relaxed(&lock->contentions);
+	stats->waitNanoseconds = BC_atomic_load_relaxed(&lock->waitNanoseconds);
+#else
+	(void)lock;
+	*stats = (BC_LockStats){0, 0, 0};
+#endif
+}
+
+// =========================================================
+// MARK: Reader Writer Lock Implementation
+// =========================================================
+
+#define PRIV_RWLOCK_WRITER 0x80000000u
+#define PRIV_RWLOCK_PENDING 0x40000000u
+#define PRIV_RWLOCK_READERS 0x3FFFFFFFu
+
+// The sleeper count is raised before the futex compares state, and unlocks change state
+// before reading the count, so an unlock either sees the sleeper or the sleeper sees the
+// new state and does not sleep
+static void PRIV_RWLockPark(BCRWLock* lock, const uint32_t expected) {
+	BC_atomic_fetch_add(&lock->sleepers, 1);
+	PRIV_FutexWait(&lock->state, expected);
+	BC_atomic_fetch_sub(&lock->sleepers, 1);
+}
+
+static void PRIV_RWLockWakeSleepers(BCRWLock* lock) {
+	if (BC_atomic_load(&lock->sleepers) != 0) {
+		PRIV_FutexWakeAll(&lock->state);
+	}
+}
+
+void BC_RWLockInit(BCRWLock* lock) {
+	BC_atomic_store_relaxed(&lock->state, 0);
+	BC_atomic_store_relaxed(&lock->sleepers, 0);
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_store_relaxed(&lock->acquisitions, 0);
+	BC_atomic_store_relaxed(&lock->contentions, 0);
+	BC_atomic_store_relaxed(&lock->waitNanoseconds, 0);
+#endif
+}
+
+void BC_RWLockReadLock(BCRWLock* lock) {
+	uint32_t state = BC_atomic_load_relaxed(&lock->state);
+	if (!(state & (PRIV_RWLOCK_WRITER | PRIV_RWLOCK_PENDING)) && BC_atomic_compare_exchange(&lock->state, &state, state + 1)) {
+#if BC_SETTINGS_LOCK_STATS == 1
+		BC_atomic_fetch_add(&lock->acquisitions, 1);
+#endif
+		return;
+	}
+
+#if BC_SETTINGS_LOCK_STATS == 1
+	const uint64_t start = BC_TimeMonotonicNanoseconds();
+#endif
+
+	int spins = 0;
+	for (;;) {
+		state = BC_atomic_load_relaxed(&lock->state);
+		if (!(state & (PRIV_RWLOCK_WRITER | PRIV_RWLOCK_PENDING))) {
+			if (BC_atomic_compare_exchange(&lock->state, &state, state + 1)) break;
+			continue;
+		}
+		// Held or wanted by a writer, new readers stay out
+		if (spins < BC_LOCK_SPIN_COUNT) {
+			spins++;
+			PRIV_CPU_RELAX();
+			continue;
+		}
+		PRIV_RWLockPark(lock, state);
+	}
+
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_fetch_add(&lock->acquisitions, 1);
+	BC_atomic_fetch_add(&lock->contentions, 1);
+	BC_atomic_fetch_add(&lock->waitNanoseconds, (size_t)(BC_TimeMonotonicNanoseconds() - start));
+#endif
+}
+
+void BC_RWLockReadUnlock(BCRWLock* lock) {
+	const uint32_t previous = BC_atomic_fetch_sub(&lock->state, 1);
+	// Last reader out lets the pending writer in
+	if ((previous & PRIV_RWLOCK_READERS) == 1 && (previous & PRIV_RWLOCK_PENDING)) {
+		PRIV_RWLockWakeSleepers(lock);
+	}
+}
+
+void BC_RWLockWriteLock(BCRWLock* lock) {
+	uint32_t state = 0;
+	if (BC_atomic_compare_exchange(&lock->state, &state, PRIV_RWLOCK_WRITER)) {
+#if BC_SETTINGS_LOCK_STATS == 1
+		BC_atomic_fetch_add(&lock->acquisitions, 1);
+#endif
+		return;
+	}
+
+#if BC_SETTINGS_LOCK_STATS == 1
+	const uint64_t start = BC_TimeMonotonicNanoseconds();
+#endif
+
+	int spins = 0;
+	for (;;) {
+		state = BC_atomic_load_relaxed(&lock->state);
+		if ((state & ~PRIV_RWLOCK_PENDING) == 0) {
+			// Taking the lock clears pending, other waiting writers set it again once woken
+			if (BC_atomic_compare_exchange(&lock->state, &state, PRIV_RWLOCK_WRITER)) break;
+			continue;
+		}
+		if (!(state & PRIV_RWLOCK_PENDING)) {
+			if (!BC_atomic_compare_exchange(&lock->state, &state, state | PRIV_RWLOCK_PENDING)) continue;
+			state |= PRIV_RWLOCK_PENDING;
+		}
+		if (spins < BC_LOCK_SPIN_COUNT) {
+			spins++;
+			PRIV_CPU_RELAX();
+			continue;
+		}
+		PRIV_RWLockPark(lock, state);
+	}
+
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_fetch_add(&lock->acquisitions, 1);
+	BC_atomic_fetch_add(&lock->contentions, 1);
+	BC_atomic_fetch_add(&lock->waitNanoseconds, (size_t)(BC_TimeMonotonicNanoseconds() - start));
+#endif
+}
+
+void BC_RWLockWriteUnlock(BCRWLock* lock) {
+	BC_atomic_exchange(&lock->state, 0);
+	PRIV_RWLockWakeSleepers(lock);
+}
+
+void BC_RWLockDestroy(BCRWLock* lock) {
+	(void)lock;
+}
+
+void BC_RWLockGetStats(BCRWLock* lock, BC_LockStats* stats) {
+	if (!stats) return;
+#if BC_SETTINGS_LOCK_STATS == 1
+	stats->acquisitions = BC_atomic_load_relaxed(&lock->acquisitions);
+	stats->contentions = BC_atomic_load_relaxed(&lock->contentions);
+	stats->waitNanoseconds = BC_atomic_load_relaxed(&lock->waitNanoseconds);
+#else
+	(void)lock;
+	*stats = (BC_LockStats){0, 0, 0};
+#endif
+}
+
+// =========================================================
+// MARK: Condition Implementation
+// =========================================================
+
+void BC_ConditionInit(BCCondition* condition) {
+#if defined(_WIN32)
+	InitializeConditionVariable(condition);
+#else
+	pthread_condattr_t attributes;
+	pthread_condattr_init(&attributes);
+#if !defined(__APPLE__)
+	// Timeouts are measured on the same clock as BC_TimeMonotonicNanoseconds
+	pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+#endif
+	pthread_cond_init(condition, &attributes);
+	pthread_condattr_destroy(&attributes);
+#endif
+}
+
+void BC_ConditionWait(BCCondition* condition, BCMutex* mutex) {
+#if defined(_WIN32)
+	SleepConditionVariableCS(condition, mutex, INFINITE);
+#else
+	pthread_cond_wait(condition, mutex);
+#endif
+}
+
+BC_bool BC_ConditionWaitTimeout(BCCondition* condition, BCMutex* mutex, const uint64_t nanoseconds) {
+#if defined(_WIN32)
+	return SleepConditionVariableCS(condition, mutex, (DWORD)(nanoseconds / 1000000)) != 0;
+#elif defined(__APPLE__)
+	const struct timespec duration = {(time_t)(nanoseconds / 1000000000), (long)(nanoseconds % 1000000000)};
+	return pthread_cond_timedwait_relative_np(condition, mutex, &duration) == 0;
+#else
+	const uint64_t deadline = BC_TimeMonotonicNanoseconds() + nanoseconds;
+	const struct timespec until = {(time_t)(deadline / 1000000000), (long)(deadline % 1000000000)};
+	return pthread_cond_timedwait(condition, mutex, &until) == 0;
+#endif
+}
+
+void BC_ConditionSignal(BCCondition* condition) {
+#if defined(_WIN32)
+	WakeConditionVariable(condition);
+#else
+	pthread_cond_signal(condition);
+#endif
+}
+
+void BC_ConditionBroadcast(BCCondition* condition) {
+#if defined(_WIN32)
+	WakeAllConditionVariable(condition);
+#else
+	pthread_cond_broadcast(condition);
+#endif
+}
+
+void BC_ConditionDestroy(BCCondition* condition) {
+#if defined(_WIN32)
+	(void)condition;
+#else
+	pthread_cond_destroy(condition);
+#endif
+}
+
 // =========================================================
 // MARK: Run Once Implementation
 // =========================================================
@@ -100,4 +442,138 @@ void BC_RunOnce(BCOnceToken* token, void (*func)(void)) {
 #endif
 }
 
-#endif
\ No newline at end of file
+// =========================================================
+// MARK: Threads Implementation
+// =========================================================
+
+typedef struct PRIV_ThreadStart {
+	BC_ThreadFunc func;
+	void* arg;
+} PRIV_ThreadStart;
+
+#if defined(_WIN32)
+static DWORD WINAPI PRIV_ThreadMain(LPVOID ptr) {
+#else
+static void* PRIV_ThreadMain(void* ptr) {
+#endif
+	const PRIV_ThreadStart start = *(PRIV_ThreadStart*)ptr;
+	BC_Free(ptr);
+	start.func(start.arg);
+	return 0;
+}
+
+BC_bool BC_ThreadCreate(BCThread* thread, const BC_ThreadFunc func, void* arg) {
+	PRIV_ThreadStart* start = BC_Malloc(sizeof(PRIV_ThreadStart));
+	if (!start) return BC_false;
+	start->func = func;
+	start->arg = arg;
+
+#if defined(_WIN32)
+	*thread = CreateThread(NULL, 0, PRIV_ThreadMain, start, 0, NULL);
+	const BC_bool created = *thread != NULL;
+#else
+	const BC_bool created = pthread_create(thread, NULL, PRIV_ThreadMain, start) == 0;
+#endif
+	if (!created) {
+		fprintf(stderr, "BC_ThreadCreate: Failed to create thread\n");
+		BC_Free(start);
+	}
+	return created;
+}
+
+void BC_ThreadJoin(const BCThread thread) {
+#if defined(_WIN32)
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+}
+
+#endif
+
+void BC_ThreadSleep(const uint64_t nanoseconds) {
+#if defined(_WIN32)
+	Sleep((DWORD)(nanoseconds / 1000000));
+#else
+	const struct timespec duration = {(time_t)(nanoseconds / 1000000000), (long)(nanoseconds % 1000000000)};
+	nanosleep(&duration, NULL);
+#endif
+}
+
+void BC_ThreadYield(void) {
+#if defined(_WIN32)
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+size_t BC_ThreadHardwareConcurrency(void) {
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+#else
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (size_t)count : 1;
+#endif
+}
+
+// =========================================================
+// MARK: Time Implementation
+// =========================================================
+
+uint64_t BC_TimeMonotonicNanoseconds(void) {
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = {0};
+	if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// =========================================================
+// MARK: Sequence Lock Implementation
+// =========================================================
+
+void BC_SeqlockInit(BCSeqlock* lock) {
+	BC_atomic_store_relaxed(&lock->sequence, 0);
+	BC_LockInit(&lock->writer);
+}
+
+uint32_t BC_SeqlockReadBegin(BCSeqlock* lock) {
+	uint32_t sequence;
+	while ((sequence = BC_atomic_load_acquire(&lock->sequence)) & 1) {
+		PRIV_CPU_RELAX();
+	}
+	return sequence;
+}
+
+BC_bool BC_SeqlockReadRetry(BCSeqlock* lock, const uint32_t sequence) {
+	// Keeps the data loads of the section ahead of the sequence check
+	BC_atomic_fence_acquire();
+	return BC_atomic_load_relaxed(&lock->sequence) != sequence;
+}
+
+void BC_SeqlockWriteLock(BCSeqlock* lock) {
+	BC_LockLock(&lock->writer);
+	BC_atomic_store_relaxed(&lock->sequence, BC_atomic_load_relaxed(&lock->sequence) + 1);
+	// Odd sequence is visible before any data store of the section
+	BC_atomic_fence_release();
+}
+
+void BC_SeqlockWriteUnlock(BCSeqlock* lock) {
+	BC_atomic_store_release(&lock->sequence, BC_atomic_load_relaxed(&lock->sequence) + 1);
+	BC_LockUnlock(&lock->writer);
+}
+
+void BC_SeqlockDestroy(BCSeqlock* lock) {
+	(void)lock;
+	BC_LockDestroy(&lock->writer);
+}
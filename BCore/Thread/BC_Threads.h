@@ -1,7 +1,12 @@
 #ifndef BCORE_THREADS_H
 #define BCORE_THREADS_H
 
+#include "BC_Atomics.h"
 #include "../BC_Settings.h"
+#include "../BC_Types.h"
+
+#include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -67,6 +72,148 @@ void BC_SpinlockDestroy(BCSpinlock* sl);
 
 #endif
 
+// =========================================================
+// MARK: Adaptive Lock
+// =========================================================
+
+// Spins this many times on a held lock before parking, enough to cover short critical sections
+#define BC_LOCK_SPIN_COUNT 100
+
+typedef struct BC_LockStats {
+	size_t acquisitions;
+	size_t contentions;        // Acquisitions that found the lock held
+	uint64_t waitNanoseconds;  // Time spent in contended acquisitions
+} BC_LockStats;
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+// Lock that spins briefly and then sleeps on a futex (WaitOnAddress on Windows) until the
+// holder wakes it, waiters do not burn a core. Zero initialized is unlocked.
+typedef struct BCLock {
+	BC_atomic_uint32 state;  // 0 unlocked, 1 locked, 2 locked with possible sleepers
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_size acquisitions;
+	BC_atomic_size contentions;
+	BC_atomic_size waitNanoseconds;
+#endif
+} BCLock;
+
+void BC_LockInit(BCLock* lock);
+void BC_LockLock(BCLock* lock);
+BC_bool BC_LockTryLock(BCLock* lock);
+void BC_LockUnlock(BCLock* lock);
+void BC_LockDestroy(BCLock* lock);
+#define BC_LOCK_MAYBE(_lock_name_) BCLock _lock_name_;
+#define BC_LOCK_MAYBE_STATIC(_lock_name_) static BC_LOCK_MAYBE(_lock_name_);
+
+// Fills `stats` with zeros unless BC_SETTINGS_LOCK_STATS is enabled
+void BC_LockGetStats(BCLock* lock, BC_LockStats* stats);
+
+#else
+
+#define BC_LockInit(_)
+#define BC_LockLock(_)
+#define BC_LockTryLock(_) (BC_true)
+#define BC_LockUnlock(_)
+#define BC_LockDestroy(_)
+#define BC_LOCK_MAYBE(_)
+#define BC_LOCK_MAYBE_STATIC(_)
+#define BC_LockGetStats(_, _stats_) (*(_stats_) = (BC_LockStats){0, 0, 0})
+
+#endif
+
+// =========================================================
+// MARK: Reader Writer Lock
+// =========================================================
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+// Many readers or one writer. A waiting writer stops new readers from entering so a steady
+// stream of lookups cannot starve an insert. Zero initialized is unlocked.
+typedef struct BCRWLock {
+	BC_atomic_uint32 state;    // Reader count plus writer held / writer pending bits
+	BC_atomic_uint32 sleepers; // Threads parked on state, unlocks skip the wake syscall when 0
+#if BC_SETTINGS_LOCK_STATS == 1
+	BC_atomic_size acquisitions;
+	BC_atomic_size contentions;
+	BC_atomic_size waitNanoseconds;
+#endif
+} BCRWLock;
+
+void BC_RWLockInit(BCRWLock* lock);
+void BC_RWLockReadLock(BCRWLock* lock);
+void BC_RWLockReadUnlock(BCRWLock* lock);
+void BC_RWLockWriteLock(BCRWLock* lock);
+void BC_RWLockWriteUnlock(BCRWLock* lock);
+void BC_RWLockDestroy(BCRWLock* lock);
+#define BC_RWLOCK_MAYBE(_lock_name_) BCRWLock _lock_name_;
+#define BC_RWLOCK_MAYBE_STATIC(_lock_name_) static BC_RWLOCK_MAYBE(_lock_name_);
+
+// Counts read and write acquisitions together, zeros unless BC_SETTINGS_LOCK_STATS is enabled
+void BC_RWLockGetStats(BCRWLock* lock, BC_LockStats* stats);
+
+#else
+
+#define BC_RWLockInit(_)
+#define BC_RWLockReadLock(_)
+#define BC_RWLockReadUnlock(_)
+#define BC_RWLockWriteLock(_)
+#define BC_RWLockWriteUnlock(_)
+#define BC_RWLockDestroy(_)
+#define BC_RWLOCK_MAYBE(_)
+#define BC_RWLOCK_MAYBE_STATIC(_)
+#define BC_RWLockGetStats(_, _stats_) (*(_stats_) = (BC_LockStats){0, 0, 0})
+
+#endif
+
+// =========================================================
+// MARK: Sequence Lock
+// =========================================================
+
+// Readers never write shared memory: they read a sequence, copy the data, and retry if a
+// writer ran meanwhile. Suited to small values read far more often than written. Fields
+// read inside the section must be copied out with relaxed atomics (or be tolerant of torn
+// reads) and only trusted once BC_SeqlockReadRetry returns false.
+//
+//	uint32_t seq;
+//	do {
+//		seq = BC_SeqlockReadBegin(&lock);
+//		copy = BC_atomic_load_relaxed(&shared);
+//	} while (BC_SeqlockReadRetry(&lock, seq));
+typedef struct BCSeqlock {
+	BC_atomic_uint32 sequence;  // Odd while a writer is inside
+	BC_LOCK_MAYBE(writer)
+} BCSeqlock;
+
+void BC_SeqlockInit(BCSeqlock* lock);
+uint32_t BC_SeqlockReadBegin(BCSeqlock* lock);
+BC_bool BC_SeqlockReadRetry(BCSeqlock* lock, uint32_t sequence);
+void BC_SeqlockWriteLock(BCSeqlock* lock);
+void BC_SeqlockWriteUnlock(BCSeqlock* lock);
+void BC_SeqlockDestroy(BCSeqlock* lock);
+
+// =========================================================
+// MARK: Conditions
+// =========================================================
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+#if defined(_WIN32)
+typedef CONDITION_VARIABLE BCCondition;
+#else
+typedef pthread_cond_t BCCondition;
+#endif
+
+void BC_ConditionInit(BCCondition* condition);
+void BC_ConditionWait(BCCondition* condition, BCMutex* mutex);
+// Returns BC_false once `nanoseconds` passed without a signal, spurious wakeups return BC_true
+BC_bool BC_ConditionWaitTimeout(BCCondition* condition, BCMutex* mutex, uint64_t nanoseconds);
+void BC_ConditionSignal(BCCondition* condition);
+void BC_ConditionBroadcast(BCCondition* condition);
+void BC_ConditionDestroy(BCCondition* condition);
+
+#endif
+
 // =========================================================
 // MARK: Run Once
 // =========================================================
@@ -89,6 +236,38 @@ void BC_RunOnce(BCOnceToken* token, void (*func)(void));
 #define BC_RunOnce(_, _fun_) (_fun_())
 #endif
 
+// =========================================================
+// MARK: Threads
+// =========================================================
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+#if defined(_WIN32)
+typedef HANDLE BCThread;
+#else
+typedef pthread_t BCThread;
+#endif
+
+typedef void (*BC_ThreadFunc)(void* arg);
+
+BC_bool BC_ThreadCreate(BCThread* thread, BC_ThreadFunc func, void* arg);
+void BC_ThreadJoin(BCThread thread);
+
+#endif
+
+void BC_ThreadSleep(uint64_t nanoseconds);
+void BC_ThreadYield(void);
+
+// Logical CPUs available to the process, at least 1
+size_t BC_ThreadHardwareConcurrency(void);
+
+// =========================================================
+// MARK: Time
+// =========================================================
+
+// Monotonic clock for intervals and timeouts, unrelated to wall time
+uint64_t BC_TimeMonotonicNanoseconds(void);
+
 #ifdef __cplusplus
 }
 #endif
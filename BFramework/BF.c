@@ -20,6 +20,7 @@ extern void INTERNAL_BO_BytesArrayInitialize();
 extern void INTERNAL_BO_StringPoolInitialize();
 extern void INTERNAL_BO_StringInitialize();
 extern void INTERNAL_BO_StringBuilderInitialize();
+extern void INTERNAL_BO_FutureInitialize();
 
 static BC_bool BF_IsInitialized = BC_false;
 
@@ -41,6 +42,7 @@ void BF_Initialize(const int argc, char** argv) {
 	INTERNAL_BO_StringPoolInitialize();
 	INTERNAL_BO_StringInitialize();
 	INTERNAL_BO_StringBuilderInitialize();
+	INTERNAL_BO_FutureInitialize();
 
 	BF_IsInitialized = BC_true;
 }
@@ -53,12 +55,16 @@ extern void INTERNAL_BF_AutoreleaseDeinitialize();
 extern void INTERNAL_BO_StringPoolDeinitialize();
 extern void INTERNAL_BO_ObjectDebugDeinitialize();
 extern void INTERNAL_BF_ClassRegistryDeinitialize();
+extern void INTERNAL_BC_TaskPoolDeinitialize();
 
 BC_bool BF_IsDeinitialized = BC_false;
 
 void BF_Deinitialize(void) {
 	if (BF_IsDeinitialized || !BF_IsInitialized) return;
 
+	// Shared pool workers can still be releasing objects, join them before any class goes away
+	INTERNAL_BC_TaskPoolDeinitialize();
+
 	INTERNAL_BO_StringPoolDeinitialize();
 	INTERNAL_BO_ObjectDebugDeinitialize();
 
@@ -2,6 +2,9 @@
 
 #include "BCore/BC_Keywords.h"
 #include "BCore/Memory/BC_Memory.h"
+#include "BCore/Thread/BC_Fiber.h"
+#include "BCore/Thread/BC_RunLoop.h"
+#include "BCore/Thread/BC_TaskPool.h"
 
 #include "BObject/BO_Object.h"
 
@@ -97,14 +100,44 @@ static inline void PRIV_FreeOrRecyclePool(PRIV_AutoreleasePool* pool) {
 		gFreePoolCount++;
 	}
 	else {
-		BC_Free(pool);
+		BC_FreeSized(pool, sizeof(PRIV_AutoreleasePool) + pool->capacity * sizeof(BO_ObjectRef));
 	}
 }
 
+// =========================================================
+// MARK: Fibers
+// =========================================================
+
+// A fiber keeps its own chain while it is suspended, it is swapped in and out of the thread
+// around every resume. Its base pool is never the root pool, the fiber can be resumed on
+// another thread whose root pool is not its own.
+static void* PRIV_FiberContextSwap(void* context) {
+	PRIV_AutoreleasePool* replaced = gCurrentAutoReleasePool;
+	gCurrentAutoReleasePool = context;
+	return replaced;
+}
+
+static void PRIV_FiberBegin(void) {
+	PRIV_AutoreleasePool* pool = PRIV_AllocPool();
+	pool->parent = gCurrentAutoReleasePool;
+	gCurrentAutoReleasePool = pool;
+}
+
+// Drains the chain of a fiber destroyed before it returned
+static void PRIV_FiberContextDestroy(void* context) {
+	PRIV_AutoreleasePool* saved = PRIV_FiberContextSwap(context);
+	while (gCurrentAutoReleasePool) {
+		BF_AutoreleasePoolPop();
+	}
+	gCurrentAutoReleasePool = saved;
+}
+
 // =========================================================
 // MARK: Runtime Lifecycle
 // =========================================================
 
+void INTERNAL_BF_AutoreleaseDeinitialize(void);
+
 void INTERNAL_BF_AutoreleaseInitialize(void) {
 	// Reset the root pool
 	gRootPool.parent = NULL;
@@ -117,6 +150,29 @@ void INTERNAL_BF_AutoreleaseInitialize(void) {
 	gCurrentAutoReleasePool = NULL;
 	gFreePoolList = NULL;
 	gFreePoolCount = 0;
+
+	// Every task gets its own pool, workers drop their free list when they exit
+	const BC_TaskPoolHooks hooks = {
+		.threadStop = INTERNAL_BF_AutoreleaseDeinitialize,
+		.taskBegin = BF_AutoreleasePoolPush,
+		.taskEnd = BF_AutoreleasePoolPop,
+	};
+	BC_TaskPoolSetHooks(&hooks);
+
+	const BC_FiberHooks fiberHooks = {
+		.fiberBegin = PRIV_FiberBegin,
+		.fiberEnd = BF_AutoreleasePoolPop,
+		.contextSwap = PRIV_FiberContextSwap,
+		.contextDestroy = PRIV_FiberContextDestroy,
+	};
+	BC_FiberSetHooks(&fiberHooks);
+
+	// Objects autoreleased by run loop handlers are released once per iteration
+	const BC_RunLoopHooks runLoopHooks = {
+		.iterationBegin = BF_AutoreleasePoolPush,
+		.iterationEnd = BF_AutoreleasePoolPop,
+	};
+	BC_RunLoopSetHooks(&runLoopHooks);
 }
 
 void INTERNAL_BF_AutoreleaseDeinitialize(void) {
@@ -131,7 +187,7 @@ void INTERNAL_BF_AutoreleaseDeinitialize(void) {
 	PRIV_AutoreleasePool* pool = gFreePoolList;
 	while (pool) {
 		PRIV_AutoreleasePool* next = pool->next;
-		BC_Free(pool);
+		BC_FreeSized(pool, sizeof(PRIV_AutoreleasePool) + pool->capacity * sizeof(BO_ObjectRef));
 		pool = next;
 	}
 
@@ -30,7 +30,7 @@
 // =========================================================
 
 static struct {
-	BC_SPINLOCK_MAYBE(lock)
+	BC_RWLOCK_MAYBE(lock)
 	BF_Class** segments[BC_CLASS_REGISTRY_MAX_SEGMENTS];
 	BF_ClassId segment_count;
 	BF_ClassId total_classes;
@@ -57,7 +57,7 @@ BF_ClassId BF_ClassRegistryGetCount(void) {
 }
 
 BF_ClassId BF_ClassRegistryInsert(BF_Class* cls) {
-	BC_SpinlockLock(&PRIV_ClassRegistryState.lock);
+	BC_RWLockWriteLock(&PRIV_ClassRegistryState.lock);
 
 	// Check if we need to allocate a new segment
 	const uint32_t current_index = PRIV_ClassRegistryState.total_classes;
@@ -66,7 +66,7 @@ BF_ClassId BF_ClassRegistryInsert(BF_Class* cls) {
 	// Allocate segments as needed
 	while (PRIV_ClassRegistryState.segment_count <= required_segment) {
 		if (PRIV_ClassRegistryState.segment_count >= BC_CLASS_REGISTRY_MAX_SEGMENTS) {
-			BC_SpinlockUnlock(&PRIV_ClassRegistryState.lock);
+			BC_RWLockWriteUnlock(&PRIV_ClassRegistryState.lock);
 			return BF_CLASS_ID_INVALID; // gClassRegistryState is full
 		}
 
@@ -75,7 +75,7 @@ BF_ClassId BF_ClassRegistryInsert(BF_Class* cls) {
 			BC_Malloc(segment_size * sizeof(BF_Class*));
 
 		if (!PRIV_ClassRegistryState.segments[PRIV_ClassRegistryState.segment_count]) {
-			BC_SpinlockUnlock(&PRIV_ClassRegistryState.lock);
+			BC_RWLockWriteUnlock(&PRIV_ClassRegistryState.lock);
 			return BF_CLASS_ID_INVALID; // Allocation failed
 		}
 
@@ -92,7 +92,7 @@ BF_ClassId BF_ClassRegistryInsert(BF_Class* cls) {
 	PRIV_ClassRegistryState.segments[segment][offset] = cls;
 	PRIV_ClassRegistryState.total_classes++;
 	cls->id = current_index;
-	BC_SpinlockUnlock(&PRIV_ClassRegistryState.lock);
+	BC_RWLockWriteUnlock(&PRIV_ClassRegistryState.lock);
 
 	return current_index;
 }
@@ -114,20 +114,24 @@ BF_Class* BF_ClassIdGetRef(const BF_ClassId cid) {
 
 BF_ClassId BF_DebugClassFindId(const BF_Class* cls) {
 	if (cls == NULL) { return BF_CLASS_ID_INVALID; }
-	BC_SpinlockLock(&PRIV_ClassRegistryState.lock);
+	BC_RWLockReadLock(&PRIV_ClassRegistryState.lock);
 
 	// Slow Linear Search, only for debugging purposes
 	for (uint32_t i = 0; i < PRIV_ClassRegistryState.total_classes; i++) {
 		if (BF_ClassIdGetRef(i) == cls) {
-			BC_SpinlockUnlock(&PRIV_ClassRegistryState.lock);
+			BC_RWLockReadUnlock(&PRIV_ClassRegistryState.lock);
 			return i;
 		}
 	}
 
-	BC_SpinlockUnlock(&PRIV_ClassRegistryState.lock);
+	BC_RWLockReadUnlock(&PRIV_ClassRegistryState.lock);
 	return BF_CLASS_ID_INVALID;
 }
 
+void BF_ClassRegistryGetLockStats(BC_LockStats* stats) {
+	BC_RWLockGetStats(&PRIV_ClassRegistryState.lock, stats);
+}
+
 // =========================================================
 // MARK: Private
 // =========================================================
@@ -174,14 +178,14 @@ static inline BF_ClassId PRIV_GetSegmentSize(const BF_ClassId segment_index) {
 // =========================================================
 
 void INTERNAL_BF_ClassRegistryInitialize(void) {
-	BC_SpinlockInit(&PRIV_ClassRegistryState.lock);
+	BC_RWLockInit(&PRIV_ClassRegistryState.lock);
 	memset(PRIV_ClassRegistryState.segments, 0, sizeof(PRIV_ClassRegistryState.segments));
 	PRIV_ClassRegistryState.segment_count = 0;
 	PRIV_ClassRegistryState.total_classes = 0;
 }
 
 void INTERNAL_BF_ClassRegistryDeinitialize(void) {
-	BC_SpinlockLock(&PRIV_ClassRegistryState.lock);
+	BC_RWLockWriteLock(&PRIV_ClassRegistryState.lock);
 
 	// Free all allocated segments
 	for (BF_ClassId i = 0; i < PRIV_ClassRegistryState.segment_count; i++) {
@@ -194,6 +198,6 @@ void INTERNAL_BF_ClassRegistryDeinitialize(void) {
 	PRIV_ClassRegistryState.segment_count = 0;
 	PRIV_ClassRegistryState.total_classes = 0;
 
-	BC_SpinlockUnlock(&PRIV_ClassRegistryState.lock);
-	BC_SpinlockDestroy(&PRIV_ClassRegistryState.lock);
+	BC_RWLockWriteUnlock(&PRIV_ClassRegistryState.lock);
+	BC_RWLockDestroy(&PRIV_ClassRegistryState.lock);
 }
\ No newline at end of file
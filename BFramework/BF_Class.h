@@ -3,6 +3,8 @@
 
 #include "BF_Types.h"
 
+#include "BCore/Thread/BC_Threads.h"
+
 #include <stddef.h>
 
 typedef struct BF_Class {
@@ -14,6 +16,7 @@ typedef struct BF_Class {
 	BF_ToStringFunc toString;
 	BF_CopyFunc copy;
 	size_t allocSize;
+	BF_ExtraSizeFunc extraSize;  // Optional, bytes allocated past allocSize, lets release free with the exact size
 } BF_Class;
 
 // =========================================================
@@ -36,4 +39,7 @@ BF_ClassId BF_DebugClassFindId(const BF_Class* cls);
 BF_ClassId BF_ClassRegistryGetCount(void);
 BF_ClassId BF_ClassRegistryInsert(BF_Class* cls);
 
+// Contention on the registry lock, zeros unless BC_SETTINGS_LOCK_STATS is enabled
+void BF_ClassRegistryGetLockStats(BC_LockStats* stats);
+
 #endif //BFRAMEWORK_CLASS_H
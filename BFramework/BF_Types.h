@@ -4,6 +4,7 @@
 #include "BCore/BC_Types.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define $VAR __auto_type
@@ -54,6 +55,12 @@ typedef struct BO_BytesArray* BO_BytesArrayRef;
 typedef struct BO_Map* BO_MapRef;
 typedef struct BO_Map* BO_MutableMapRef;
 
+// =========================================================
+// MARK: Concurrency
+// =========================================================
+
+typedef struct BO_Future* BO_FutureRef;
+
 // =========================================================
 // MARK: Function Types
 // =========================================================
@@ -63,5 +70,6 @@ typedef uint32_t (*BF_HashFunc)(BO_ObjectRef obj);
 typedef BC_bool (*BF_EqualFunc)(BO_ObjectRef a, BO_ObjectRef b);
 typedef BO_StringRef (*BF_ToStringFunc)(BO_ObjectRef obj);
 typedef BO_ObjectRef (*BF_CopyFunc)(BO_ObjectRef);
+typedef size_t (*BF_ExtraSizeFunc)(BO_ObjectRef obj);
 
 #endif //BFRAMEWORK_TYPES_H
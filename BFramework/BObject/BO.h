@@ -2,6 +2,7 @@
 #define BRUNTIME_BO_H
 
 #include "BO_BytesArray.h"
+#include "BO_Future.h"
 #include "BO_List.h"
 #include "BO_Map.h"
 #include "BO_Number.h"
@@ -1,6 +1,7 @@
 #include "BO_BytesArray.h"
 
 #include "BCore/BC_Range.h"
+#include "BCore/Memory/BC_VirtualMemory.h"
 
 #include "BO_Object.h"
 #include "BO_StringBuilder.h"
@@ -15,13 +16,28 @@
 typedef struct BO_BytesArray {
 	BO_Object base;
 	size_t size;
-	uint8_t bytes[];
+	size_t alignment;
+	uint8_t* bytes;     // Points into storage past the alignment padding, or to a huge page block for large payloads
+	uint8_t storage[];
 } BO_BytesArray;
 
 // =========================================================
 // MARK: Class Methods
 // =========================================================
 
+static void IMPL_BytesArrayDealloc(const BO_ObjectRef self) {
+	const BO_BytesArrayRef selfCast = (BO_BytesArrayRef) self;
+	if (selfCast->size >= BC_VIRTUAL_HUGE_PAGE_THRESHOLD) {
+		BC_AllocatorFreeAligned(kBC_AllocatorRefHugePages, selfCast->bytes);
+	}
+}
+
+static size_t IMPL_BytesArrayExtraSize(const BO_ObjectRef self) {
+	const BO_BytesArrayRef selfCast = (BO_BytesArrayRef) self;
+	if (selfCast->size >= BC_VIRTUAL_HUGE_PAGE_THRESHOLD) return 0;
+	return selfCast->size + selfCast->alignment - 1;
+}
+
 static BC_bool IMPL_BytesArrayEqual(const BO_ObjectRef self, const BO_ObjectRef other) {
 	if (self == other) return BC_true;
 	if (!self || !other) return BC_false;
@@ -59,7 +75,9 @@ static BO_StringRef IMPL_BytesArrayToString(const BO_ObjectRef self) {
 
 static BO_ObjectRef IMPL_BytesArrayCopy(const BO_ObjectRef self) {
 	const BO_BytesArrayRef selfCast = (BO_BytesArrayRef) self;
-	return (BO_ObjectRef) BO_BytesArrayCreateWithBytes(selfCast->size, selfCast->bytes);
+	const BO_BytesArrayRef copy = BO_BytesArrayCreateAligned(selfCast->size, selfCast->alignment);
+	memcpy(copy->bytes, selfCast->bytes, selfCast->size);
+	return (BO_ObjectRef) copy;
 }
 
 // =========================================================
@@ -69,12 +87,13 @@ static BO_ObjectRef IMPL_BytesArrayCopy(const BO_ObjectRef self) {
 static BF_Class kBO_BytesArrayClass = {
 	.name = "BO_BytesArray",
 	.id = BF_CLASS_ID_INVALID,
-	.dealloc = NULL,
+	.dealloc = IMPL_BytesArrayDealloc,
 	.hash = IMPL_BytesArrayHash,
 	.equal = IMPL_BytesArrayEqual,
 	.toString = IMPL_BytesArrayToString,
 	.copy = IMPL_BytesArrayCopy,
-	.allocSize = sizeof(BO_BytesArray)
+	.allocSize = sizeof(BO_BytesArray),
+	.extraSize = IMPL_BytesArrayExtraSize
 };
 
 BF_ClassId BO_BytesArrayClassId(void) {
@@ -90,19 +109,39 @@ void INTERNAL_BO_BytesArrayInitialize(void) {
 // =========================================================
 
 BO_BytesArrayRef BO_BytesArrayCreate(const size_t size) {
-	const BO_BytesArrayRef arr = (BO_BytesArrayRef) BO_ObjectAllocWithConfig(NULL, kBO_BytesArrayClass.id, size * sizeof(uint8_t), BC_OBJECT_DEFAULT_FLAGS);
-	arr->size = size;
-	memset(arr->bytes, 0, size);
-	return arr;
+	return BO_BytesArrayCreateAligned(size, 1);
 }
 
 BO_BytesArrayRef BO_BytesArrayCreateWithBytes(const size_t size, const uint8_t *bytes) {
-	const BO_BytesArrayRef arr = (BO_BytesArrayRef) BO_ObjectAllocWithConfig(NULL, kBO_BytesArrayClass.id, size * sizeof(uint8_t), BC_OBJECT_DEFAULT_FLAGS);
-	arr->size = size;
+	const BO_BytesArrayRef arr = BO_BytesArrayCreateAligned(size, 1);
 	memcpy(arr->bytes, bytes, size);
 	return arr;
 }
 
+BO_BytesArrayRef BO_BytesArrayCreateAligned(const size_t size, const size_t alignment) {
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) return NULL;
+
+	// Large payloads live in their own huge page mapping, the object only keeps the pointer
+	if (size >= BC_VIRTUAL_HUGE_PAGE_THRESHOLD) {
+		uint8_t* bytes = BC_AllocatorAllocAligned(kBC_AllocatorRefHugePages, size, alignment);
+		if (!bytes) return NULL;
+		const BO_BytesArrayRef arr = (BO_BytesArrayRef) BO_ObjectAllocWithConfig(NULL, kBO_BytesArrayClass.id, 0, BC_OBJECT_DEFAULT_FLAGS);
+		arr->size = size;
+		arr->alignment = alignment;
+		arr->bytes = bytes;
+		return arr;
+	}
+
+	// Objects carry a header, so the bytes are aligned inside the object instead of the object itself
+	const size_t padding = alignment - 1;
+	const BO_BytesArrayRef arr = (BO_BytesArrayRef) BO_ObjectAllocWithConfig(NULL, kBO_BytesArrayClass.id, size * sizeof(uint8_t) + padding, BC_OBJECT_DEFAULT_FLAGS);
+	arr->size = size;
+	arr->alignment = alignment;
+	arr->bytes = (uint8_t*)(((uintptr_t)arr->storage + padding) & ~(uintptr_t)padding);
+	memset(arr->bytes, 0, size);
+	return arr;
+}
+
 // =========================================================
 // MARK: Methods
 // =========================================================
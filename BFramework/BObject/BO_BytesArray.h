@@ -20,6 +20,8 @@ BF_ClassId BO_BytesArrayClassId(void);
 
 BO_BytesArrayRef BO_BytesArrayCreate(size_t size);
 BO_BytesArrayRef BO_BytesArrayCreateWithBytes(size_t size, const uint8_t* bytes);
+// Bytes start on an `alignment` boundary (power of two), e.g. BC_CACHE_LINE_SIZE for SIMD buffers
+BO_BytesArrayRef BO_BytesArrayCreateAligned(size_t size, size_t alignment);
 
 // =========================================================
 // MARK: Methods
@@ -0,0 +1,457 @@
+#include "BO_Future.h"
+
+#include "BO_List.h"
+#include "BCore/Memory/BC_Memory.h"
+#include "BCore/Thread/BC_TaskPool.h"
+#include "../BF_AutoreleasePool.h"
+#include "../BF_Class.h"
+
+#include <stdio.h>
+
+// =========================================================
+// MARK: Struct
+// =========================================================
+
+typedef struct PRIV_FutureCallbackNode {
+	struct PRIV_FutureCallbackNode* next;
+	BO_FutureCallback callback;
+	void (*dispose)(void* ctx);  // Runs instead of the callback when the future dies pending
+	void* ctx;
+} PRIV_FutureCallbackNode;
+
+typedef struct BO_Future {
+	BO_Object base;
+	BC_atomic_uint8 state;
+	BO_ObjectRef result;                  // Value or error, written once before state
+	PRIV_FutureCallbackNode* callbacks;   // Newest first, guarded by mutex
+	BC_MUTEX_MAYBE(mutex)
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BCCondition condition;
+#endif
+} BO_Future;
+
+// =========================================================
+// MARK: Impl
+// =========================================================
+
+static void IMPL_FutureDealloc(const BO_ObjectRef obj) {
+	const BO_FutureRef future = (BO_FutureRef)obj;
+
+	PRIV_FutureCallbackNode* node = future->callbacks;
+	while (node) {
+		PRIV_FutureCallbackNode* next = node->next;
+		if (node->dispose) node->dispose(node->ctx);
+		BC_Free(node);
+		node = next;
+	}
+
+	BO_Release(future->result);
+	BC_MutexDestroy(&future->mutex);
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BC_ConditionDestroy(&future->condition);
+#endif
+}
+
+// =========================================================
+// MARK: Class
+// =========================================================
+
+static BF_Class kBO_FutureClass = {
+	.name = "BO_Future",
+	.id = BF_CLASS_ID_INVALID,
+	.dealloc = IMPL_FutureDealloc,
+	.hash = NULL,
+	.equal = NULL,
+	.toString = NULL,
+	.copy = NULL,
+	.allocSize = sizeof(BO_Future)
+};
+
+BF_ClassId BO_FutureClassId(void) {
+	return kBO_FutureClass.id;
+}
+
+void INTERNAL_BO_FutureInitialize(void) {
+	BF_ClassRegistryInsert(&kBO_FutureClass);
+}
+
+// =========================================================
+// MARK: Private
+// =========================================================
+
+static BC_bool PRIV_FutureComplete(const BO_FutureRef future, const BO_FutureState state, const BO_ObjectRef result) {
+	if (!future) return BC_false;
+
+	BC_MutexLock(&future->mutex);
+	if (BC_atomic_load_relaxed(&future->state) != BO_FutureStatePending) {
+		BC_MutexUnlock(&future->mutex);
+		return BC_false;
+	}
+	future->result = BO_Retain(result);
+	BC_atomic_store_release(&future->state, (uint8_t)state);
+	PRIV_FutureCallbackNode* node = future->callbacks;
+	future->callbacks = NULL;
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BC_ConditionBroadcast(&future->condition);
+#endif
+	BC_MutexUnlock(&future->mutex);
+
+	// Registered newest first, run them in registration order
+	PRIV_FutureCallbackNode* ordered = NULL;
+	while (node) {
+		PRIV_FutureCallbackNode* next = node->next;
+		node->next = ordered;
+		ordered = node;
+		node = next;
+	}
+
+	// A callback may drop the last outside reference
+	BO_Retain($OBJ future);
+	while (ordered) {
+		PRIV_FutureCallbackNode* next = ordered->next;
+		ordered->callback(future, ordered->ctx);
+		BC_Free(ordered);
+		ordered = next;
+	}
+	BO_Release($OBJ future);
+	return BC_true;
+}
+
+static void PRIV_FutureAddCallback(const BO_FutureRef future, const BO_FutureCallback callback, void (*dispose)(void* ctx), void* ctx) {
+	BC_MutexLock(&future->mutex);
+	if (BC_atomic_load_relaxed(&future->state) == BO_FutureStatePending) {
+		PRIV_FutureCallbackNode* node = BC_Malloc(sizeof(PRIV_FutureCallbackNode));
+		if (!node) {
+			BC_MutexUnlock(&future->mutex);
+			fprintf(stderr, "BO_FutureOnComplete: Failed to allocate callback\n");
+			if (dispose) dispose(ctx);
+			return;
+		}
+		node->callback = callback;
+		node->dispose = dispose;
+		node->ctx = ctx;
+		node->next = future->callbacks;
+		future->callbacks = node;
+		BC_MutexUnlock(&future->mutex);
+		return;
+	}
+	BC_MutexUnlock(&future->mutex);
+
+	BO_Retain($OBJ future);
+	callback(future, ctx);
+	BO_Release($OBJ future);
+}
+
+static BC_bool PRIV_FutureCheckList(const BO_ListRef futures, const char* caller) {
+	if (!futures) return BC_false;
+	for (size_t i = 0; i < BO_ListCount(futures); i++) {
+		if (!BO_IsClass(BO_ListGet(futures, i), kBO_FutureClass.id)) {
+			fprintf(stderr, "%s: Item %zu is not a future\n", caller, i);
+			return BC_false;
+		}
+	}
+	return BC_true;
+}
+
+// =========================================================
+// MARK: Constructors
+// =========================================================
+
+BO_FutureRef BO_FutureCreate(void) {
+	const BO_FutureRef future = (BO_FutureRef)BO_ObjectAlloc(NULL, kBO_FutureClass.id);
+	if (!future) return NULL;
+	BC_atomic_store_relaxed(&future->state, (uint8_t)BO_FutureStatePending);
+	future->result = NULL;
+	future->callbacks = NULL;
+	BC_MutexInit(&future->mutex);
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BC_ConditionInit(&future->condition);
+#endif
+	return future;
+}
+
+BO_FutureRef BO_FutureCreateResolved(const BO_ObjectRef value) {
+	const BO_FutureRef future = BO_FutureCreate();
+	PRIV_FutureComplete(future, BO_FutureStateResolved, value);
+	return future;
+}
+
+BO_FutureRef BO_FutureCreateRejected(const BO_ObjectRef error) {
+	const BO_FutureRef future = BO_FutureCreate();
+	PRIV_FutureComplete(future, BO_FutureStateRejected, error);
+	return future;
+}
+
+typedef struct PRIV_FutureAsync {
+	BO_FutureRef future;
+	BO_FutureAsyncFunc func;
+	void* ctx;
+} PRIV_FutureAsync;
+
+static void PRIV_FutureAsyncTask(void* arg) {
+	PRIV_FutureAsync* async = arg;
+	PRIV_FutureComplete(async->future, BO_FutureStateResolved, async->func(async->ctx));
+	BO_Release($OBJ async->future);
+	BC_Free(async);
+}
+
+BO_FutureRef BO_FutureAsync(const BO_FutureAsyncFunc func, void* ctx) {
+	if (!func) return NULL;
+
+	PRIV_FutureAsync* async = BC_Malloc(sizeof(PRIV_FutureAsync));
+	if (!async) return NULL;
+
+	const BO_FutureRef future = BO_FutureCreate();
+	async->future = (BO_FutureRef)BO_Retain($OBJ future);
+	async->func = func;
+	async->ctx = ctx;
+	if (!BC_TaskPoolSubmit(BC_TaskPoolShared(), NULL, PRIV_FutureAsyncTask, async)) {
+		fprintf(stderr, "BO_FutureAsync: Failed to submit task\n");
+		BO_Release($OBJ future);
+		BO_Release($OBJ future);
+		BC_Free(async);
+		return NULL;
+	}
+	return future;
+}
+
+// =========================================================
+// MARK: Completion
+// =========================================================
+
+BC_bool BO_FutureResolve(const BO_FutureRef future, const BO_ObjectRef value) {
+	return PRIV_FutureComplete(future, BO_FutureStateResolved, value);
+}
+
+BC_bool BO_FutureReject(const BO_FutureRef future, const BO_ObjectRef error) {
+	return PRIV_FutureComplete(future, BO_FutureStateRejected, error);
+}
+
+// =========================================================
+// MARK: Getters
+// =========================================================
+
+BO_FutureState BO_FutureGetState(const BO_FutureRef future) {
+	if (!future) return BO_FutureStatePending;
+	// Acquire pairs with the completion, the result is visible once the state is
+	return (BO_FutureState)BC_atomic_load_acquire(&future->state);
+}
+
+BC_bool BO_FutureIsDone(const BO_FutureRef future) {
+	return BO_FutureGetState(future) != BO_FutureStatePending;
+}
+
+BO_ObjectRef BO_FutureValue(const BO_FutureRef future) {
+	return BO_FutureGetState(future) == BO_FutureStateResolved ? future->result : NULL;
+}
+
+BO_ObjectRef BO_FutureError(const BO_FutureRef future) {
+	return BO_FutureGetState(future) == BO_FutureStateRejected ? future->result : NULL;
+}
+
+// =========================================================
+// MARK: Waiting
+// =========================================================
+
+BC_bool BO_FutureWait(const BO_FutureRef future, const uint64_t timeoutNanoseconds) {
+	if (!future) return BC_false;
+	if (BO_FutureIsDone(future)) return BC_true;
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	const uint64_t start = BC_TimeMonotonicNanoseconds();
+	const BC_bool forever = timeoutNanoseconds == BO_FUTURE_WAIT_FOREVER || timeoutNanoseconds > UINT64_MAX - start;
+	const uint64_t deadline = forever ? UINT64_MAX : start + timeoutNanoseconds;
+
+	BC_MutexLock(&future->mutex);
+	while (BC_atomic_load_relaxed(&future->state) == BO_FutureStatePending) {
+		if (forever) {
+			BC_ConditionWait(&future->condition, &future->mutex);
+			continue;
+		}
+		const uint64_t now = BC_TimeMonotonicNanoseconds();
+		if (now >= deadline) break;
+		BC_ConditionWaitTimeout(&future->condition, &future->mutex, deadline - now);
+	}
+	BC_MutexUnlock(&future->mutex);
+	return BO_FutureIsDone(future);
+#else
+	// No other thread can complete it while this one waits
+	(void)timeoutNanoseconds;
+	return BC_false;
+#endif
+}
+
+// =========================================================
+// MARK: Chaining
+// =========================================================
+
+void BO_FutureOnComplete(const BO_FutureRef future, const BO_FutureCallback callback, void* ctx) {
+	if (!future || !callback) return;
+	PRIV_FutureAddCallback(future, callback, NULL, ctx);
+}
+
+// Completes the future in ctx like the source, used to follow futures returned by then
+static void PRIV_FutureForward(const BO_FutureRef source, void* ctx) {
+	const BO_FutureRef target = ctx;
+	PRIV_FutureComplete(target, BO_FutureGetState(source), source->result);
+	BO_Release($OBJ target);
+}
+
+static void PRIV_FutureForwardDispose(void* ctx) {
+	BO_Release((BO_ObjectRef)ctx);
+}
+
+typedef struct PRIV_FutureThen {
+	BO_FutureRef next;
+	BO_FutureThenFunc func;
+	void* ctx;
+} PRIV_FutureThen;
+
+static void PRIV_FutureThenDispose(void* ctx) {
+	PRIV_FutureThen* then = ctx;
+	BO_Release($OBJ then->next);
+	BC_Free(then);
+}
+
+static void PRIV_FutureThenCallback(const BO_FutureRef source, void* ctx) {
+	PRIV_FutureThen* then = ctx;
+
+	if (BO_FutureGetState(source) == BO_FutureStateRejected) {
+		PRIV_FutureComplete(then->next, BO_FutureStateRejected, source->result);
+	} else {
+		// The completing thread may have no pool of its own
+		BF_AutoreleasePoolPush();
+		const BO_ObjectRef value = BO_Retain(then->func(source->result, then->ctx));
+		BF_AutoreleasePoolPop();
+
+		if (BO_IsClass(value, kBO_FutureClass.id)) {
+			PRIV_FutureAddCallback((BO_FutureRef)value, PRIV_FutureForward, PRIV_FutureForwardDispose, BO_Retain($OBJ then->next));
+		} else {
+			PRIV_FutureComplete(then->next, BO_FutureStateResolved, value);
+		}
+		BO_Release(value);
+	}
+
+	PRIV_FutureThenDispose(then);
+}
+
+BO_FutureRef BO_FutureThen(const BO_FutureRef future, const BO_FutureThenFunc func, void* ctx) {
+	if (!future || !func) return NULL;
+
+	PRIV_FutureThen* then = BC_Malloc(sizeof(PRIV_FutureThen));
+	if (!then) return NULL;
+
+	const BO_FutureRef next = BO_FutureCreate();
+	then->next = (BO_FutureRef)BO_Retain($OBJ next);
+	then->func = func;
+	then->ctx = ctx;
+	PRIV_FutureAddCallback(future, PRIV_FutureThenCallback, PRIV_FutureThenDispose, then);
+	return next;
+}
+
+// =========================================================
+// MARK: Combinators
+// =========================================================
+
+// Shared by the callbacks of one combinator. It does not hold the source futures, a source
+// that dies pending only disposes its callback.
+typedef struct PRIV_FutureJoin PRIV_FutureJoin;
+
+typedef struct PRIV_FutureJoinSlot {
+	PRIV_FutureJoin* join;
+	BO_ObjectRef value;  // Retained when the source resolves
+} PRIV_FutureJoinSlot;
+
+struct PRIV_FutureJoin {
+	BO_FutureRef result;
+	size_t count;
+	BC_atomic_size remaining;   // Sources not resolved yet
+	BC_atomic_size references;  // Callbacks not run or disposed yet, plus the creator
+	PRIV_FutureJoinSlot slots[];
+};
+
+static PRIV_FutureJoin* PRIV_FutureJoinCreate(const size_t count) {
+	PRIV_FutureJoin* join = BC_Malloc(sizeof(PRIV_FutureJoin) + count * sizeof(PRIV_FutureJoinSlot));
+	if (!join) return NULL;
+	join->result = BO_FutureCreate();
+	join->count = count;
+	BC_atomic_store(&join->remaining, count);
+	BC_atomic_store(&join->references, count + 1);
+	for (size_t i = 0; i < count; i++) {
+		join->slots[i].join = join;
+		join->slots[i].value = NULL;
+	}
+	return join;
+}
+
+static void PRIV_FutureJoinRelease(PRIV_FutureJoin* join) {
+	if (BC_atomic_fetch_sub(&join->references, 1) != 1) return;
+	for (size_t i = 0; i < join->count; i++) {
+		BO_Release(join->slots[i].value);
+	}
+	BO_Release($OBJ join->result);
+	BC_Free(join);
+}
+
+static void PRIV_FutureJoinDispose(void* ctx) {
+	PRIV_FutureJoinRelease(((PRIV_FutureJoinSlot*)ctx)->join);
+}
+
+static void PRIV_FutureAllCallback(const BO_FutureRef source, void* ctx) {
+	PRIV_FutureJoinSlot* slot = ctx;
+	PRIV_FutureJoin* join = slot->join;
+
+	if (BO_FutureGetState(source) == BO_FutureStateRejected) {
+		PRIV_FutureComplete(join->result, BO_FutureStateRejected, source->result);
+	} else {
+		slot->value = BO_Retain(source->result);
+		// The last source sees every slot written by the others through this decrement
+		if (BC_atomic_fetch_sub_explicit(&join->remaining, 1, BC_memory_order_acq_rel) == 1) {
+			const BO_ListRef values = BO_ListCreate();
+			for (size_t i = 0; i < join->count; i++) {
+				BO_ListAdd(values, join->slots[i].value);
+			}
+			PRIV_FutureComplete(join->result, BO_FutureStateResolved, $OBJ values);
+			BO_Release($OBJ values);
+		}
+	}
+
+	PRIV_FutureJoinRelease(join);
+}
+
+static void PRIV_FutureAnyCallback(const BO_FutureRef source, void* ctx) {
+	PRIV_FutureJoin* join = ((PRIV_FutureJoinSlot*)ctx)->join;
+	PRIV_FutureComplete(join->result, BO_FutureGetState(source), source->result);
+	PRIV_FutureJoinRelease(join);
+}
+
+static BO_FutureRef PRIV_FutureJoinStart(const BO_ListRef futures, const BO_FutureCallback callback) {
+	PRIV_FutureJoin* join = PRIV_FutureJoinCreate(BO_ListCount(futures));
+	if (!join) return NULL;
+
+	const BO_FutureRef result = (BO_FutureRef)BO_Retain($OBJ join->result);
+	for (size_t i = 0; i < join->count; i++) {
+		PRIV_FutureAddCallback((BO_FutureRef)BO_ListGet(futures, i), callback, PRIV_FutureJoinDispose, &join->slots[i]);
+	}
+
+	// Sources already done ran their callback above, the creator reference kept join alive
+	PRIV_FutureJoinRelease(join);
+	return result;
+}
+
+BO_FutureRef BO_FutureWhenAll(const BO_ListRef futures) {
+	if (!PRIV_FutureCheckList(futures, "BO_FutureWhenAll")) return NULL;
+
+	if (BO_ListCount(futures) == 0) {
+		const BO_ListRef values = BO_ListCreate();
+		const BO_FutureRef result = BO_FutureCreateResolved($OBJ values);
+		BO_Release($OBJ values);
+		return result;
+	}
+	return PRIV_FutureJoinStart(futures, PRIV_FutureAllCallback);
+}
+
+BO_FutureRef BO_FutureWhenAny(const BO_ListRef futures) {
+	if (!PRIV_FutureCheckList(futures, "BO_FutureWhenAny")) return NULL;
+	return PRIV_FutureJoinStart(futures, PRIV_FutureAnyCallback);
+}
@@ -0,0 +1,96 @@
+#ifndef BOBJECT_FUTURE_H
+#define BOBJECT_FUTURE_H
+
+#include "BO_Object.h"
+
+#include <stdint.h>
+
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+#define BO_FUTURE_WAIT_FOREVER UINT64_MAX
+
+// =========================================================
+// MARK: Types
+// =========================================================
+
+typedef enum {
+	BO_FutureStatePending,
+	BO_FutureStateResolved,
+	BO_FutureStateRejected
+} BO_FutureState;
+
+typedef void (*BO_FutureCallback)(BO_FutureRef future, void* ctx);
+typedef BO_ObjectRef (*BO_FutureThenFunc)(BO_ObjectRef value, void* ctx);
+typedef BO_ObjectRef (*BO_FutureAsyncFunc)(void* ctx);
+
+// =========================================================
+// MARK: Class
+// =========================================================
+
+BF_ClassId BO_FutureClassId(void);
+
+// =========================================================
+// MARK: Constructors
+// =========================================================
+
+// Pending future, whoever holds it completes it with BO_FutureResolve or BO_FutureReject
+BO_FutureRef BO_FutureCreate(void);
+BO_FutureRef BO_FutureCreateResolved(BO_ObjectRef value);
+BO_FutureRef BO_FutureCreateRejected(BO_ObjectRef error);
+
+// Runs `func` on the shared task pool and resolves with what it returns. The task has its own
+// autorelease pool, the result is retained before it drains.
+BO_FutureRef BO_FutureAsync(BO_FutureAsyncFunc func, void* ctx);
+
+// =========================================================
+// MARK: Completion
+// =========================================================
+
+// Retain `value` (or `error`, both can be NULL) and wake waiters, then run the callbacks on the
+// calling thread. Only the first completion wins, later ones return BC_false.
+BC_bool BO_FutureResolve(BO_FutureRef future, BO_ObjectRef value);
+BC_bool BO_FutureReject(BO_FutureRef future, BO_ObjectRef error);
+
+// =========================================================
+// MARK: Getters
+// =========================================================
+
+BO_FutureState BO_FutureGetState(BO_FutureRef future);
+BC_bool BO_FutureIsDone(BO_FutureRef future);
+
+// Owned by the future, NULL unless it resolved (or rejected for the error)
+BO_ObjectRef BO_FutureValue(BO_FutureRef future);
+BO_ObjectRef BO_FutureError(BO_FutureRef future);
+
+// =========================================================
+// MARK: Waiting
+// =========================================================
+
+// Blocks until the future completes or `timeoutNanoseconds` passed, returns whether it is
+// done. Waiting on a pool worker for a task queued behind it on the same pool can deadlock,
+// chain with BO_FutureThen instead.
+BC_bool BO_FutureWait(BO_FutureRef future, uint64_t timeoutNanoseconds);
+
+// =========================================================
+// MARK: Chaining
+// =========================================================
+
+// Runs `callback` once the future completes, on the completing thread, or right away on the
+// caller when it already did. A future released while still pending drops its callbacks.
+void BO_FutureOnComplete(BO_FutureRef future, BO_FutureCallback callback, void* ctx);
+
+// Future of `func(value)`, run inside its own autorelease pool on the completing thread. A
+// returned future is followed rather than used as the value. Rejections skip `func` and pass
+// the error on.
+BO_FutureRef BO_FutureThen(BO_FutureRef future, BO_FutureThenFunc func, void* ctx);
+
+// Resolves with a list of the values in the order of `futures` once all resolved, rejects with
+// the first error
+BO_FutureRef BO_FutureWhenAll(BO_ListRef futures);
+
+// Completes like the first of `futures` to complete, never completes for an empty list
+BO_FutureRef BO_FutureWhenAny(BO_ListRef futures);
+
+#endif //BOBJECT_FUTURE_H
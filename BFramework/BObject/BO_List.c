@@ -1,6 +1,7 @@
 #include "BO_List.h"
 
 #include "BCore/Memory/BC_Memory.h"
+#include "BCore/Thread/BC_TaskPool.h"
 
 #include "BO_StringBuilder.h"
 #include "../BF_Class.h"
@@ -24,6 +25,7 @@ typedef struct BO_List {
 // =========================================================
 
 static void PRIV_ListAdd(BO_ListRef arr, BO_ObjectRef item, BC_bool retain);
+static BC_bool PRIV_ListReserve(BO_ListRef arr, size_t capacity);
 
 // =========================================================
 // MARK: Impl
@@ -32,7 +34,7 @@ static void PRIV_ListAdd(BO_ListRef arr, BO_ObjectRef item, BC_bool retain);
 static void IMPL_ListDealloc(const BO_ObjectRef obj) {
 	const BO_ListRef arr = (BO_ListRef)obj;
 	for (size_t i = 0; i < arr->count; i++) BO_Release(arr->items[i]);
-	BC_Free(arr->items);
+	BC_FreeSized(arr->items, arr->capacity * sizeof(BO_ObjectRef));
 }
 
 static BO_StringRef IMPL_ListToString(const BO_ObjectRef obj) {
@@ -200,6 +202,159 @@ BO_ListRef BO_ListFilter(const BO_ListRef list, BC_bool (*predicate)(BO_ObjectRe
 	return newList;
 }
 
+// =========================================================
+// MARK: Parallel
+// =========================================================
+
+typedef struct PRIV_ListParallel {
+	BO_ListRef list;
+	void* ctx;
+	size_t chunkSize;
+	void (*block)(BO_ObjectRef item, size_t index, void* ctx);
+	BO_ObjectRef (*transform)(BO_ObjectRef item, size_t index, void* ctx);
+	BC_bool (*predicate)(BO_ObjectRef item, size_t index, void* ctx);
+	BO_ObjectRef (*combine)(BO_ObjectRef accumulator, BO_ObjectRef item, void* ctx);
+	BO_ObjectRef* results;  // Map: items of the new list, Reduce: one accumulator per chunk
+	uint8_t* keep;          // Filter: one flag per item
+} PRIV_ListParallel;
+
+// About four chunks per thread, never so small that scheduling outweighs the work
+static size_t PRIV_ListChunkSize(const size_t count, const BC_TaskPoolRef pool) {
+	const size_t chunkSize = count / ((BC_TaskPoolWorkerCount(pool) + 1) * 4);
+	return chunkSize > BO_LIST_PARALLEL_THRESHOLD / 4 ? chunkSize : BO_LIST_PARALLEL_THRESHOLD / 4;
+}
+
+// Runs `func` over every item, on the caller when the list is under the threshold
+static void PRIV_ListParallelRun(PRIV_ListParallel* job, const BC_TaskRangeFunc func) {
+	const size_t count = job->list->count;
+	if (count < BO_LIST_PARALLEL_THRESHOLD) {
+		func(0, count, job);
+		return;
+	}
+
+	const BC_TaskPoolRef pool = BC_TaskPoolShared();
+	BC_TaskPoolParallelFor(pool, 0, count, PRIV_ListChunkSize(count, pool), func, job);
+}
+
+static void PRIV_ListForEachRange(const size_t begin, const size_t end, void* arg) {
+	const PRIV_ListParallel* job = arg;
+	for (size_t i = begin; i < end; i++) {
+		job->block(job->list->items[i], i, job->ctx);
+	}
+}
+
+static void PRIV_ListMapRange(const size_t begin, const size_t end, void* arg) {
+	const PRIV_ListParallel* job = arg;
+	for (size_t i = begin; i < end; i++) {
+		// Retained here, the chunk autorelease pool drains before the caller sees the result
+		job->results[i] = BO_Retain(job->transform(job->list->items[i], i, job->ctx));
+	}
+}
+
+static void PRIV_ListFilterRange(const size_t begin, const size_t end, void* arg) {
+	const PRIV_ListParallel* job = arg;
+	for (size_t i = begin; i < end; i++) {
+		job->keep[i] = job->predicate(job->list->items[i], i, job->ctx) ? 1 : 0;
+	}
+}
+
+static void PRIV_ListReduceChunks(const size_t firstChunk, const size_t endChunk, void* arg) {
+	const PRIV_ListParallel* job = arg;
+	for (size_t chunk = firstChunk; chunk < endChunk; chunk++) {
+		const size_t begin = chunk * job->chunkSize;
+		const size_t end = begin + job->chunkSize < job->list->count ? begin + job->chunkSize : job->list->count;
+
+		BO_ObjectRef accumulator = BO_Retain(job->list->items[begin]);
+		for (size_t i = begin + 1; i < end; i++) {
+			const BO_ObjectRef next = BO_Retain(job->combine(accumulator, job->list->items[i], job->ctx));
+			BO_Release(accumulator);
+			accumulator = next;
+		}
+		job->results[chunk] = accumulator;
+	}
+}
+
+void BO_ListParallelForEach(const BO_ListRef list, void (*block)(BO_ObjectRef item, size_t index, void* ctx), void* ctx) {
+	if (!list || !block)
+		return;
+	PRIV_ListParallel job = {.list = list, .ctx = ctx, .block = block};
+	PRIV_ListParallelRun(&job, PRIV_ListForEachRange);
+}
+
+BO_ListRef BO_ListParallelMap(const BO_ListRef list, BO_ObjectRef (*transform)(BO_ObjectRef item, size_t index, void* ctx), void* ctx) {
+	if (!list || !transform)
+		return NULL;
+
+	// Chunks write straight into the new list, each index is written by exactly one chunk
+	const BO_ListRef newList = BO_ListCreate();
+	if (!PRIV_ListReserve(newList, list->count)) {
+		BO_Release($OBJ newList);
+		return NULL;
+	}
+
+	PRIV_ListParallel job = {.list = list, .ctx = ctx, .transform = transform, .results = newList->items};
+	PRIV_ListParallelRun(&job, PRIV_ListMapRange);
+	newList->count = list->count;
+	return newList;
+}
+
+BO_ListRef BO_ListParallelFilter(const BO_ListRef list, BC_bool (*predicate)(BO_ObjectRef item, size_t index, void* ctx), void* ctx) {
+	if (!list || !predicate)
+		return NULL;
+
+	uint8_t* keep = BC_Malloc(list->count ? list->count : 1);
+	if (!keep)
+		return NULL;
+
+	PRIV_ListParallel job = {.list = list, .ctx = ctx, .predicate = predicate, .keep = keep};
+	PRIV_ListParallelRun(&job, PRIV_ListFilterRange);
+
+	// Compacting is a pointer copy per item, cheaper serial than another round of tasks
+	const BO_ListRef newList = BO_ListCreate();
+	for (size_t i = 0; i < list->count; i++) {
+		if (keep[i]) PRIV_ListAdd(newList, list->items[i], BC_true);
+	}
+	BC_Free(keep);
+	return newList;
+}
+
+BO_ObjectRef BO_ListParallelReduce(const BO_ListRef list, const BO_ObjectRef initial, BO_ObjectRef (*combine)(BO_ObjectRef accumulator, BO_ObjectRef item, void* ctx), void* ctx) {
+	if (!list || !combine)
+		return NULL;
+	if (list->count == 0)
+		return BO_Retain(initial);
+
+	const BC_TaskPoolRef pool = list->count < BO_LIST_PARALLEL_THRESHOLD ? NULL : BC_TaskPoolShared();
+	const size_t chunkSize = pool ? PRIV_ListChunkSize(list->count, pool) : list->count;
+	const size_t chunkCount = (list->count + chunkSize - 1) / chunkSize;
+
+	BO_ObjectRef* results = BC_Malloc(chunkCount * sizeof(BO_ObjectRef));
+	if (!results)
+		return NULL;
+
+	PRIV_ListParallel job = {.list = list, .ctx = ctx, .chunkSize = chunkSize, .combine = combine, .results = results};
+	if (pool) {
+		BC_TaskPoolParallelFor(pool, 0, chunkCount, 1, PRIV_ListReduceChunks, &job);
+	} else {
+		PRIV_ListReduceChunks(0, chunkCount, &job);
+	}
+
+	// Chunk results are folded in list order
+	BO_ObjectRef accumulator = BO_Retain(initial);
+	for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+		if (!accumulator) {
+			accumulator = results[chunk];
+			continue;
+		}
+		const BO_ObjectRef next = BO_Retain(combine(accumulator, results[chunk], ctx));
+		BO_Release(accumulator);
+		BO_Release(results[chunk]);
+		accumulator = next;
+	}
+	BC_Free(results);
+	return accumulator;
+}
+
 // =========================================================
 // MARK: Internal
 // =========================================================
@@ -214,3 +369,14 @@ static void PRIV_ListAdd(const BO_ListRef arr, const BO_ObjectRef item, const BC
 	}
 	arr->items[arr->count++] = retain ? BO_Retain(item) : item;
 }
+
+static BC_bool PRIV_ListReserve(const BO_ListRef arr, const size_t capacity) {
+	if (capacity <= arr->capacity)
+		return BC_true;
+	void* newBuff = BC_Realloc(arr->items, capacity * sizeof(BO_ObjectRef));
+	if (!newBuff)
+		return BC_false;
+	arr->items = newBuff;
+	arr->capacity = capacity;
+	return BC_true;
+}
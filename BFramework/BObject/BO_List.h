@@ -5,6 +5,13 @@
 
 #include "BO_Object.h"
 
+// =========================================================
+// MARK: Settings
+// =========================================================
+
+// Lists shorter than this run the parallel variants serially on the caller
+#define BO_LIST_PARALLEL_THRESHOLD 4096
+
 // =========================================================
 // MARK: Class
 // =========================================================
@@ -42,4 +49,23 @@ void BO_ListForEach(BO_ListRef list, void (*block)(BO_ObjectRef item, size_t ind
 BO_ListRef BO_ListMap(BO_ListRef list, BO_ObjectRef (*transform)(BO_ObjectRef item, size_t index, void* ctx), void* ctx);
 BO_ListRef BO_ListFilter(BO_ListRef list, BC_bool (*predicate)(BO_ObjectRef item, size_t index));
 
+// =========================================================
+// MARK: Parallel
+// =========================================================
+
+// Same as the serial variants but the items are split in chunks run on the shared task pool,
+// callbacks must be thread safe and not modify the list. Results keep the list order. Every
+// chunk, the one run on the calling thread included, runs inside its own autorelease pool and
+// returned objects are retained before it drains. Lists under BO_LIST_PARALLEL_THRESHOLD run
+// serially on the caller, in its current pool.
+void BO_ListParallelForEach(BO_ListRef list, void (*block)(BO_ObjectRef item, size_t index, void* ctx), void* ctx);
+BO_ListRef BO_ListParallelMap(BO_ListRef list, BO_ObjectRef (*transform)(BO_ObjectRef item, size_t index, void* ctx), void* ctx);
+BO_ListRef BO_ListParallelFilter(BO_ListRef list, BC_bool (*predicate)(BO_ObjectRef item, size_t index, void* ctx), void* ctx);
+
+// Folds every chunk with `combine` starting from its first item, then folds `initial` and the
+// chunk results in order. `combine` is therefore also called with two partial results: the
+// accumulator must be of the same type as the items and `combine` associative, a sum or a max
+// rather than a count. Returns a retained result, `initial` (can be NULL) when the list is empty.
+BO_ObjectRef BO_ListParallelReduce(BO_ListRef list, BO_ObjectRef initial, BO_ObjectRef (*combine)(BO_ObjectRef accumulator, BO_ObjectRef item, void* ctx), void* ctx);
+
 #endif //BOBJECT_LIST_H
@@ -2,6 +2,7 @@
 
 #include "BCore/BC_Macro.h"
 #include "BCore/Memory/BC_Memory.h"
+#include "BCore/Memory/BC_VirtualMemory.h"
 
 #include "BO_List.h"
 #include "BO_StringBuilder.h"
@@ -45,7 +46,7 @@ static void IMPL_MapDealloc(const BO_ObjectRef obj) {
 			BO_Release(d->buckets[i].value);
 		}
 	}
-	BC_Free(d->buckets);
+	BC_HugePagesArrayFree(d->buckets, d->capacity, sizeof(MapEntry));
 }
 
 BO_StringRef IMPL_MapToString(const BO_ObjectRef obj) {
@@ -114,7 +115,7 @@ BO_MutableMapRef BO_MutableMapCreate() {
 	const BO_MapRef d = (BO_MapRef)BO_ObjectAllocWithConfig(NULL, kBO_MapClass.id, 0, BC_OBJECT_DEFAULT_FLAGS | BO_MAP_FLAG_MUTABLE);
 	d->capacity = 8;
 	d->count = 0;
-	d->buckets = BC_Calloc(d->capacity, sizeof(MapEntry));
+	d->buckets = BC_HugePagesArrayAlloc(d->capacity, sizeof(MapEntry));
 	return d;
 }
 
@@ -147,14 +148,14 @@ void BO_MapSet(const BO_MutableMapRef d, const BO_ObjectRef key, const BO_Object
 	// Resize Check
 	if (dict->count >= (size_t)((double)dict->capacity * 0.75)) {
 		const size_t newCap = dict->capacity * 2;
-		MapEntry* newBuckets = BC_Calloc(newCap, sizeof(MapEntry));
+		MapEntry* newBuckets = BC_HugePagesArrayAlloc(newCap, sizeof(MapEntry));
 		if (!newBuckets) return;
 		for (size_t i = 0; i < dict->capacity; i++) {
 			if (dict->buckets[i].key) {
 				PRIV_MapPut(newBuckets, newCap, dict->buckets[i].key, dict->buckets[i].value);
 			}
 		}
-		BC_Free(dict->buckets);
+		BC_HugePagesArrayFree(dict->buckets, dict->capacity, sizeof(MapEntry));
 		dict->buckets = newBuckets;
 		dict->capacity = newCap;
 	}
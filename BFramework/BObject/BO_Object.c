@@ -64,7 +64,8 @@ BO_ObjectRef BO_Retain(const BO_ObjectRef obj) {
 		BC_FLAG_HAS(obj->flags, BC_OBJECT_FLAG_CONSTANT))
 		return obj;
 
-	BC_atomic_fetch_add(&obj->ref_count, 1);
+	// Taking a reference needs no ordering, the caller already reaches the object through one
+	BC_atomic_fetch_add_explicit(&obj->ref_count, 1, BC_memory_order_relaxed);
 
 	return obj;
 }
@@ -74,18 +75,29 @@ void BO_Release(const BO_ObjectRef obj) {
 		BC_FLAG_HAS(obj->flags, BC_OBJECT_FLAG_CONSTANT))
 		return;
 
-	const BC_atomic_uint16 old_count = BC_atomic_fetch_sub(&obj->ref_count, 1);
+	// Release publishes this thread's writes to whoever drops the last reference, acquire lets
+	// that thread see every other owner's writes before tearing the object down
+	const uint16_t old_count = BC_atomic_fetch_sub_explicit(&obj->ref_count, 1, BC_memory_order_acq_rel);
 
 	if (old_count == 1) {
 		const BF_Class* cls = BF_ClassIdGetRef(obj->cls);
+		const BC_AllocatorRef allocator = BO_ObjectGetAllocator(obj);
+
+		// Same size BO_ObjectAllocWithConfig asked for, taken before dealloc tears the object down
+		size_t allocSize = allocator == kBC_AllocatorRefSystem ? 0 : sizeof(BC_AllocatorRef);
+		if (cls) allocSize += cls->allocSize + (cls->extraSize ? cls->extraSize(obj) : 0);
+
 		if (cls && cls->dealloc)
 			cls->dealloc(obj);
 
 		PRIV_ObjectDebugMarkFreed(obj);
 
-		const BC_AllocatorRef allocator = BO_ObjectGetAllocator(obj);
 		void* raw_ptr = BO_ObjectGetBasePointer(obj);
-		BC_AllocatorFree(allocator, raw_ptr);
+		if (cls) {
+			BC_AllocatorFreeSized(allocator, raw_ptr, allocSize);
+		} else {
+			BC_AllocatorFree(allocator, raw_ptr);
+		}
 	}
 }
 
@@ -127,7 +139,7 @@ BO_StringRef BO_ToString(const BO_ObjectRef obj) {
 
 BC_bool BO_IsClass(const BO_ObjectRef obj, const BF_ClassId cls) {
 	if (!obj) return BC_false;
-	return obj->cls = cls;
+	return obj->cls == cls;
 }
 
 BF_Class* BO_ObjectClass(const BO_ObjectRef obj) {
@@ -140,6 +152,20 @@ BF_ClassId BO_ObjectClassId(const BO_ObjectRef obj) {
 	return obj->cls;
 }
 
+// =========================================================
+// MARK: Queue Callbacks
+// =========================================================
+
+static void* PRIV_ObjectQueueRetain(void* item) {
+	return BO_Retain(item);
+}
+
+static void PRIV_ObjectQueueRelease(void* item) {
+	BO_Release(item);
+}
+
+const BC_QueueCallbacks kBO_QueueCallbacksObject = {PRIV_ObjectQueueRetain, PRIV_ObjectQueueRelease};
+
 // =========================================================
 // MARK: Debug Tracking
 // =========================================================
@@ -153,21 +179,21 @@ typedef struct BO_ObjectDebugNode {
 } BO_ObjectDebugNode;
 
 static struct {
-	BC_SPINLOCK_MAYBE(lock)
+	BC_LOCK_MAYBE(lock)
 	BO_ObjectDebugNode* head;
 	BC_atomic_bool enabled;
 	BC_atomic_bool keepFreedObjects;
 } PRIV_ObjectDebugTracker;
 
 void INTERNAL_BO_ObjectInitialize(void) {
-	BC_SpinlockInit(&PRIV_ObjectDebugTracker.lock);
+	BC_LockInit(&PRIV_ObjectDebugTracker.lock);
 	PRIV_ObjectDebugTracker.head = NULL;
 	PRIV_ObjectDebugTracker.enabled = BC_false;
 	PRIV_ObjectDebugTracker.keepFreedObjects = BC_false;
 }
 
 void INTERNAL_BO_ObjectDebugDeinitialize(void) {
-	BC_SpinlockLock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockLock(&PRIV_ObjectDebugTracker.lock);
 
 	BO_ObjectDebugNode* node = PRIV_ObjectDebugTracker.head;
 	while (node) {
@@ -177,15 +203,15 @@ void INTERNAL_BO_ObjectDebugDeinitialize(void) {
 	}
 
 	PRIV_ObjectDebugTracker.head = NULL;
-	BC_SpinlockUnlock(&PRIV_ObjectDebugTracker.lock);
-	BC_SpinlockDestroy(&PRIV_ObjectDebugTracker.lock);
+	BC_LockUnlock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockDestroy(&PRIV_ObjectDebugTracker.lock);
 }
 
 static void PRIV_ObjectDebugTrack(const BO_ObjectRef obj) {
 	if (!PRIV_ObjectDebugTracker.enabled || BC_FLAG_HAS(obj->flags,BC_OBJECT_FLAG_NON_SYSTEM_ALLOCATOR))
 		return;
 
-	BC_SpinlockLock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockLock(&PRIV_ObjectDebugTracker.lock);
 
 	BO_ObjectDebugNode* node = BC_Malloc(sizeof(BO_ObjectDebugNode));
 	node->obj = obj;
@@ -193,14 +219,14 @@ static void PRIV_ObjectDebugTrack(const BO_ObjectRef obj) {
 	node->next = PRIV_ObjectDebugTracker.head;
 	PRIV_ObjectDebugTracker.head = node;
 
-	BC_SpinlockUnlock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockUnlock(&PRIV_ObjectDebugTracker.lock);
 }
 
 static void PRIV_ObjectDebugMarkFreed(const BO_ObjectRef obj) {
 	if (!PRIV_ObjectDebugTracker.enabled || BC_FLAG_HAS(obj->flags,BC_OBJECT_FLAG_NON_SYSTEM_ALLOCATOR))
 		return;
 
-	BC_SpinlockLock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockLock(&PRIV_ObjectDebugTracker.lock);
 
 	BO_ObjectDebugNode* prev = NULL;
 	BO_ObjectDebugNode* curr = PRIV_ObjectDebugTracker.head;
@@ -224,7 +250,7 @@ static void PRIV_ObjectDebugMarkFreed(const BO_ObjectRef obj) {
 		curr = curr->next;
 	}
 
-	BC_SpinlockUnlock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockUnlock(&PRIV_ObjectDebugTracker.lock);
 }
 
 static const char* PRIV_FlagsToString(const BF_ClassId cls, const uint16_t flags) {
@@ -292,8 +318,12 @@ void BO_ObjectDebugSetKeepFreed(const BC_bool keepFreed) {
 #define RESET "\033[0m"
 #define BOLD "\033[1m"
 
+void BO_ObjectDebugGetLockStats(BC_LockStats* stats) {
+	BC_LockGetStats(&PRIV_ObjectDebugTracker.lock, stats);
+}
+
 void BO_ObjectDebugDump(void) {
-	BC_SpinlockLock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockLock(&PRIV_ObjectDebugTracker.lock);
 	const clock_t start = clock();
 
 	// --------------------------------------------------------------------------
@@ -381,7 +411,7 @@ void BO_ObjectDebugDump(void) {
 		   "    %zu entr%s (%zu freed, %fms)\n\n",
 		   count, count == 1 ? "y" : "ies", freedCount, elapsed);
 
-	BC_SpinlockUnlock(&PRIV_ObjectDebugTracker.lock);
+	BC_LockUnlock(&PRIV_ObjectDebugTracker.lock);
 }
 #else
 void INTERNAL_BF_ObjectDebugInitialize() {}
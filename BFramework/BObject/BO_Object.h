@@ -3,6 +3,8 @@
 
 #include "BCore/Memory/BC_Allocator.h"
 #include "BCore/Thread/BC_Atomics.h"
+#include "BCore/Thread/BC_Queue.h"
+#include "BCore/Thread/BC_Threads.h"
 
 #include "../BF_Settings.h"
 #include "../BF_Types.h"
@@ -45,12 +47,15 @@ BO_StringRef BO_ToString(BO_ObjectRef obj);
 BC_bool BO_IsClass(BO_ObjectRef obj, BF_ClassId cls);
 BF_Class* BO_ObjectClass(BO_ObjectRef obj);
 
+// Queue callbacks for objects: push retains, pop hands the reference to the caller, who releases it
+extern const BC_QueueCallbacks kBO_QueueCallbacksObject;
+
 // =========================================================
 // MARK: Allocator Handling
 // =========================================================
 
-#define BO_ObjectGetAllocator(obj) ( BC_FLAG_HAS( (obj)->flags, BC_OBJECT_FLAG_NON_SYSTEM_ALLOCATOR ) ?  ( ((BC_AllocatorRef)(obj)) - 1 ) : kBC_AllocatorRefSystem )
-#define BO_ObjectGetBasePointer(obj) ( BC_FLAG_HAS((obj)->flags, BC_OBJECT_FLAG_NON_SYSTEM_ALLOCATOR) ? ((BC_AllocatorRef)(obj)) - 1 : (BC_AllocatorRef)(obj) )
+#define BO_ObjectGetAllocator(obj) ( BC_FLAG_HAS( (obj)->flags, BC_OBJECT_FLAG_NON_SYSTEM_ALLOCATOR ) ?  *( ((BC_AllocatorRef*)(obj)) - 1 ) : kBC_AllocatorRefSystem )
+#define BO_ObjectGetBasePointer(obj) ( BC_FLAG_HAS((obj)->flags, BC_OBJECT_FLAG_NON_SYSTEM_ALLOCATOR) ? (void*)(((BC_AllocatorRef*)(obj)) - 1) : (void*)(obj) )
 #define BO_ObjectSetAllocator(obj, allocator) \
 	do { \
 		__typeof__(allocator) temp_alloc = allocator ? allocator : BC_AllocatorGetDefault();\
@@ -72,11 +77,15 @@ void BO_ObjectDebugSetEnabled(BC_bool enabled);
 void BO_ObjectDebugSetKeepFreed(BC_bool keepFreed);
 void BO_ObjectDebugDump(void);
 
+// Contention on the tracker lock, zeros unless BC_SETTINGS_LOCK_STATS is enabled
+void BO_ObjectDebugGetLockStats(BC_LockStats* stats);
+
 #else
 
 #define BO_ObjectDebugSetEnabled(...)
 #define BO_ObjectDebugSetKeepFreed(...)
 #define BO_ObjectDebugDump(...)
+#define BO_ObjectDebugGetLockStats(_stats_) (*(_stats_) = (BC_LockStats){0, 0, 0})
 
 #endif
 
@@ -32,7 +32,7 @@ static void IMPL_ReleasePoolDealloc(const BO_ObjectRef obj) {
 	}
 
 	const BC_AllocatorRef alloc = BO_ObjectGetAllocator(obj);
-	BC_AllocatorFree(alloc, pool->stack);
+	BC_AllocatorFreeSized(alloc, pool->stack, sizeof(BO_ObjectRef) * pool->capacity);
 }
 
 // =========================================================
@@ -65,7 +65,7 @@ BO_ReleasePoolRef BO_ReleasePoolCreate(const BC_AllocatorRef allocator, const si
 	const BO_ReleasePoolRef pool = (BO_ReleasePoolRef)BO_ObjectAlloc(allocator, kBO_ReleasePoolClass.id);
 	pool->COUNT = 0;
 	pool->capacity = initialCapacity;
-	pool->stack = BC_AllocatorAlloc(allocator, sizeof(BO_ObjectRef) * initialCapacity);
+	pool->stack = BC_AllocatorAlloc(BO_ObjectGetAllocator((BO_ObjectRef)pool), sizeof(BO_ObjectRef) * initialCapacity);
 	return pool;
 }
 
@@ -89,6 +89,10 @@ BO_ObjectRef BO_ReleasePoolAdd(const BO_ReleasePoolRef pool, const BO_ObjectRef
 			sizeof(BO_ObjectRef) * pool->capacity,
 			sizeof(BO_ObjectRef) * newCapacity
 		);
+		if (!newPtr) {
+			fprintf(stderr, "Error: BO_ReleasePool failed to grow (current: %u), leaking\n", pool->capacity);
+			return obj;
+		}
 		pool->stack = newPtr;
 		pool->capacity = newCapacity;
 	}
@@ -1,6 +1,7 @@
 #include "BO_Set.h"
 
 #include "BCore/Memory/BC_Memory.h"
+#include "BCore/Memory/BC_VirtualMemory.h"
 
 #include "BO_List.h"
 #include "BO_StringBuilder.h"
@@ -38,7 +39,7 @@ static void IMPL_SetDealloc(const BO_ObjectRef obj) {
 			BO_Release(s->buckets[i]);
 		}
 	}
-	BC_Free(s->buckets);
+	BC_HugePagesArrayFree(s->buckets, s->capacity, sizeof(BO_ObjectRef));
 }
 
 static BO_StringRef IMPL_SetToString(const BO_ObjectRef obj) {
@@ -91,7 +92,7 @@ BO_MutableSetRef BO_MutableSetCreate(void) {
 	const BO_SetRef s = (BO_SetRef)BO_ObjectAllocWithConfig(NULL, kBO_SetClass.id, 0, BC_OBJECT_DEFAULT_FLAGS | BO_SET_FLAG_MUTABLE);
 	s->capacity = 8;
 	s->count = 0;
-	s->buckets = BC_Calloc(s->capacity, sizeof(BO_ObjectRef));
+	s->buckets = BC_HugePagesArrayAlloc(s->capacity, sizeof(BO_ObjectRef));
 	return s;
 }
 
@@ -125,7 +126,7 @@ void BO_SetAdd(const BO_MutableSetRef s, const BO_ObjectRef obj) {
 	// Resize Check
 	if (set->count >= (size_t)((double)set->capacity * 0.75)) {
 		const size_t newCap = set->capacity * 2;
-		BO_ObjectRef* newBuckets = BC_Calloc(newCap, sizeof(BO_ObjectRef));
+		BO_ObjectRef* newBuckets = BC_HugePagesArrayAlloc(newCap, sizeof(BO_ObjectRef));
 		if (!newBuckets)
 			return;
 		for (size_t i = 0; i < set->capacity; i++) {
@@ -133,7 +134,7 @@ void BO_SetAdd(const BO_MutableSetRef s, const BO_ObjectRef obj) {
 				PRIV_SetPut(newBuckets, newCap, set->buckets[i]);
 			}
 		}
-		BC_Free(set->buckets);
+		BC_HugePagesArrayFree(set->buckets, set->capacity, sizeof(BO_ObjectRef));
 		set->buckets = newBuckets;
 		set->capacity = newCap;
 	}
@@ -56,6 +56,11 @@ BO_StringRef IMPL_StringToString(const BO_ObjectRef obj) {
 
 BO_ObjectRef IMPL_StringCopy(const BO_ObjectRef obj) { return BO_Retain(obj); }
 
+// Pooled strings are never released, only BO_StringCreate strings carry their buffer
+static size_t IMPL_StringExtraSize(const BO_ObjectRef obj) {
+	return BO_StringLength((BO_StringRef) obj) + 1;
+}
+
 // =========================================================
 // MARK: Class
 // =========================================================
@@ -67,7 +72,8 @@ static BF_Class kBO_StringClass = {
 	.equal = IMPL_StringEqual,
 	.toString = IMPL_StringToString,
 	.copy = IMPL_StringCopy,
-	.allocSize = sizeof(BO_String)
+	.allocSize = sizeof(BO_String),
+	.extraSize = IMPL_StringExtraSize
 };
 
 BF_ClassId BO_StringClassId() { return kBO_StringClass.id; }
@@ -86,17 +92,17 @@ typedef struct StringPoolNode {
 } StringPoolNode;
 
 static struct {
-	BC_SPINLOCK_MAYBE(lock);
+	BC_RWLOCK_MAYBE(lock);
 	StringPoolNode *buckets[BC_STRING_POOL_SIZE];
 } StringPool;
 
 void INTERNAL_BO_StringPoolInitialize(void) {
-	BC_SpinlockInit(&StringPool.lock);
+	BC_RWLockInit(&StringPool.lock);
 	memset(StringPool.buckets, 0, sizeof(StringPool.buckets));
 }
 
 void INTERNAL_BO_StringPoolDeinitialize(void) {
-	BC_SpinlockDestroy(&StringPool.lock);
+	BC_RWLockDestroy(&StringPool.lock);
 	for (size_t i = 0; i < BC_STRING_POOL_SIZE; i++) {
 		const StringPoolNode *node = StringPool.buckets[i];
 		while (node) {
@@ -108,24 +114,19 @@ void INTERNAL_BO_StringPoolDeinitialize(void) {
 	}
 }
 
-static BO_StringRef PRIV_StringPoolGetOrInsert(
+// Returns the pooled string retained, or NULL. Caller holds the pool lock in either mode.
+static BO_StringRef PRIV_StringPoolLookup(
+	const uint32_t idx,
 	const char *text,
 	const size_t len,
 	const uint32_t hash,
 	const BC_bool static_string
 ) {
-	const uint32_t idx = hash % BC_STRING_POOL_SIZE;
-
-	BC_SpinlockLock(&StringPool.lock);
-
-	// Lookup
 	const StringPoolNode *node = StringPool.buckets[idx];
 	while (node) {
 		// Fast path for static literal strings
 		if (static_string && node->str->buffer == text) {
-			const BO_StringRef ret = (BO_StringRef) BO_Retain((BO_ObjectRef) node->str);
-			BC_SpinlockUnlock(&StringPool.lock);
-			return ret;
+			return (BO_StringRef) BO_Retain((BO_ObjectRef) node->str);
 		}
 
 		if (BC_atomic_load(&node->str->hash) == hash) {
@@ -135,14 +136,36 @@ static BO_StringRef PRIV_StringPoolGetOrInsert(
 				continue;
 			}
 			if (strcmp(node->str->buffer, text) == 0) {
-				const BO_StringRef ret = (BO_StringRef) BO_Retain((BO_ObjectRef) node->str);
-				BC_SpinlockUnlock(&StringPool.lock);
-				return ret;
+				return (BO_StringRef) BO_Retain((BO_ObjectRef) node->str);
 			}
 		}
 
 		node = node->next;
 	}
+	return NULL;
+}
+
+static BO_StringRef PRIV_StringPoolGetOrInsert(
+	const char *text,
+	const size_t len,
+	const uint32_t hash,
+	const BC_bool static_string
+) {
+	const uint32_t idx = hash % BC_STRING_POOL_SIZE;
+
+	// Lookups far outnumber inserts, they share the lock
+	BC_RWLockReadLock(&StringPool.lock);
+	BO_StringRef found = PRIV_StringPoolLookup(idx, text, len, hash, static_string);
+	BC_RWLockReadUnlock(&StringPool.lock);
+	if (found) return found;
+
+	// Another thread may have inserted it between the two locks
+	BC_RWLockWriteLock(&StringPool.lock);
+	found = PRIV_StringPoolLookup(idx, text, len, hash, static_string);
+	if (found) {
+		BC_RWLockWriteUnlock(&StringPool.lock);
+		return found;
+	}
 
 	// ============================================
 	// Insert
@@ -175,7 +198,7 @@ static BO_StringRef PRIV_StringPoolGetOrInsert(
 	newNode->next = StringPool.buckets[idx];
 	StringPool.buckets[idx] = newNode;
 
-	BC_SpinlockUnlock(&StringPool.lock);
+	BC_RWLockWriteUnlock(&StringPool.lock);
 
 	newStr->base.ref_count = 0;
 
@@ -268,7 +291,7 @@ const char *BO_StringCPtr(const BO_StringRef str) { return str->buffer; }
 #define SB "\033[1m"
 
 void BO_StringPoolDebugDump(void) {
-	BC_SpinlockLock(&StringPool.lock);
+	BC_RWLockReadLock(&StringPool.lock);
 	const clock_t start = clock();
 
 	// --------------------------------------------------------------------------
@@ -330,7 +353,7 @@ void BO_StringPoolDebugDump(void) {
 		}
 	}
 
-	BC_SpinlockUnlock(&StringPool.lock);
+	BC_RWLockReadUnlock(&StringPool.lock);
 
 	const clock_t end = clock();
 	const double elapsed = (double) (end - start) / CLOCKS_PER_SEC * 1000;
@@ -345,3 +368,7 @@ void BO_StringPoolDebugDump(void) {
 		elapsed
 	);
 }
+
+void BO_StringPoolGetLockStats(BC_LockStats* stats) {
+	BC_RWLockGetStats(&StringPool.lock, stats);
+}
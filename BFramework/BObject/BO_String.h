@@ -2,6 +2,7 @@
 #define BOBJECT_STRING_H
 
 #include "BCore/BC_Macro.h"
+#include "BCore/Thread/BC_Threads.h"
 
 #include "../BF_Types.h"
 
@@ -73,4 +74,7 @@ const char* BO_StringCPtr(BO_StringRef str);
 
 void BO_StringPoolDebugDump(void);
 
+// Contention on the interning lock, zeros unless BC_SETTINGS_LOCK_STATS is enabled
+void BO_StringPoolGetLockStats(BC_LockStats* stats);
+
 #endif //BOBJECT_STRING_H
@@ -55,7 +55,7 @@ void IMPL_StringBuilderDealloc(const BO_ObjectRef obj) {
 	const BO_StringBuilderRef builder = (BO_StringBuilderRef)obj;
 	if (builder->buffer) {
 		const BC_AllocatorRef alloc = BO_ObjectGetAllocator(obj);
-		alloc->free(builder->buffer, alloc->context);
+		BC_AllocatorFreeSized(alloc, builder->buffer, builder->capacity);
 		builder->buffer = NULL;
 	}
 }
@@ -136,7 +136,7 @@ BO_StringBuilderRef BO_StringBuilderCreateWithCapacity(const BC_AllocatorRef all
 
 	const BO_StringBuilderRef builder = (BO_StringBuilderRef)BO_ObjectAlloc(allocator, kBO_StringBuilderClass.id);
 
-	builder->buffer = BC_AllocatorAlloc(allocator, capacity);
+	builder->buffer = BC_AllocatorAlloc(BO_ObjectGetAllocator((BO_ObjectRef)builder), capacity);
 	builder->capacity = capacity;
 	builder->length = 0;
 
@@ -227,17 +227,13 @@ void BO_StringBuilderEnsureCapacity(const BO_StringBuilderRef builder, const siz
 		newCapacity = PRIV_NextPowerOfTwo(requiredCapacity);
 	}
 
-	// Reallocate buffer
+	// Reallocate buffer, in place when the allocator supports it
 	const BC_AllocatorRef alloc = BO_ObjectGetAllocator((BO_ObjectRef)builder);
-	char* newBuffer = alloc->alloc(newCapacity, alloc->context);
+	char* newBuffer = BC_AllocatorRealloc(alloc, builder->buffer, builder->capacity, newCapacity);
 	if (!newBuffer) {
 		fprintf(stderr, "BO_StringBuilder: Failed to allocate buffer\n");
 		return;
 	}
-	memcpy(newBuffer, builder->buffer, builder->length);
-	BC_AllocatorFree(alloc, builder->buffer);
-	builder->buffer = newBuffer;
-	builder->capacity = newCapacity;
 
 	builder->buffer = newBuffer;
 	builder->capacity = newCapacity;
@@ -0,0 +1,68 @@
+#include "BT_Benchmarks.h"
+
+#include <BCore/Memory/BC_Allocator.h>
+#include <BCore/Memory/BC_Pool.h>
+#include <BCore/Memory/BC_Slab.h>
+#include <BCore/Memory/BC_ThreadCache.h>
+
+#define BENCHMARK_ITERATIONS 200000
+#define BENCHMARK_BATCH 64
+#define BENCHMARK_MAX_THREADS 8
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1 && !defined(_WIN32)
+#include <pthread.h>
+
+static void* PRIV_BenchmarkAllocatorWorker(void* ctx) {
+	const BC_AllocatorRef allocator = ctx;
+	void* blocks[BENCHMARK_BATCH];
+
+	// Allocate and free in batches so free lists are actually exercised
+	for (int i = 0; i < BENCHMARK_ITERATIONS / BENCHMARK_BATCH; i++) {
+		for (int j = 0; j < BENCHMARK_BATCH; j++) {
+			blocks[j] = BC_AllocatorAlloc(allocator, 16 + (j & 7) * 8);
+		}
+		for (int j = 0; j < BENCHMARK_BATCH; j++) {
+			BC_AllocatorFree(allocator, blocks[j]);
+		}
+	}
+	return NULL;
+}
+
+static void PRIV_BenchmarkAllocatorScaling(const char* name, const BC_AllocatorRef allocator) {
+	BT_Test(name);
+
+	for (int threadCount = 1; threadCount <= BENCHMARK_MAX_THREADS; threadCount *= 2) {
+		pthread_t threads[BENCHMARK_MAX_THREADS];
+
+		const double start = BT_GetWallTimeMicroseconds();
+		for (int i = 0; i < threadCount; i++) {
+			pthread_create(&threads[i], NULL, PRIV_BenchmarkAllocatorWorker, allocator);
+		}
+		for (int i = 0; i < threadCount; i++) {
+			pthread_join(threads[i], NULL);
+		}
+		const double elapsed = BT_GetWallTimeMicroseconds() - start;
+
+		const double operations = (double)threadCount * (BENCHMARK_ITERATIONS / BENCHMARK_BATCH) * BENCHMARK_BATCH * 2;
+		BT_Print("    %d thread(s): %.2f μs (%.2f M alloc+free per second)\n",
+			threadCount, elapsed, operations / elapsed);
+	}
+}
+#endif
+
+void BT_BenchmarkAllocators(void) {
+	BT_Title("Allocator Scaling Benchmark");
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1 && !defined(_WIN32)
+	PRIV_BenchmarkAllocatorScaling("System allocator", kBC_AllocatorRefSystem);
+	PRIV_BenchmarkAllocatorScaling("Shared slab", kBC_AllocatorRefSlab);
+	PRIV_BenchmarkAllocatorScaling("Thread cache", kBC_AllocatorRefThreadCache);
+
+	// Workers ask for 16 to 72 bytes, a single 80 byte object size covers them all
+	const BC_PoolRef pool = BC_PoolCreate(NULL, 80, 0);
+	PRIV_BenchmarkAllocatorScaling("Fixed size pool", BC_PoolAllocator(pool));
+	BC_PoolDestroy(pool);
+#else
+	BT_Print("    Requires pthreads\n");
+#endif
+}
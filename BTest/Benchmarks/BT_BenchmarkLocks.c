@@ -0,0 +1,110 @@
+#include "BT_Benchmarks.h"
+
+#include <BCore/Thread/BC_Atomics.h>
+#include <BCore/Thread/BC_Threads.h>
+
+#define BENCHMARK_READS 200000
+#define BENCHMARK_MAX_THREADS 8
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+
+typedef enum {
+	PRIV_BENCHMARK_LOCK,
+	PRIV_BENCHMARK_RWLOCK,
+	PRIV_BENCHMARK_SEQLOCK,
+	PRIV_BENCHMARK_STRING_POOL
+} PRIV_BenchmarkLockKind;
+
+// Small read-mostly value, the seqlock copy reads it through relaxed atomics
+static struct {
+	BCLock lock;
+	BCRWLock rwlock;
+	BCSeqlock seqlock;
+	BC_atomic_size first;
+	BC_atomic_size second;
+	PRIV_BenchmarkLockKind kind;
+} PRIV_BenchmarkLockState;
+
+static void PRIV_BenchmarkLockReader(void* arg) {
+	size_t* sum = arg;
+	size_t local = 0;
+
+	for (int i = 0; i < BENCHMARK_READS; i++) {
+		switch (PRIV_BenchmarkLockState.kind) {
+			case PRIV_BENCHMARK_LOCK:
+				BC_LockLock(&PRIV_BenchmarkLockState.lock);
+				local += BC_atomic_load_relaxed(&PRIV_BenchmarkLockState.first) + BC_atomic_load_relaxed(&PRIV_BenchmarkLockState.second);
+				BC_LockUnlock(&PRIV_BenchmarkLockState.lock);
+				break;
+			case PRIV_BENCHMARK_RWLOCK:
+				BC_RWLockReadLock(&PRIV_BenchmarkLockState.rwlock);
+				local += BC_atomic_load_relaxed(&PRIV_BenchmarkLockState.first) + BC_atomic_load_relaxed(&PRIV_BenchmarkLockState.second);
+				BC_RWLockReadUnlock(&PRIV_BenchmarkLockState.rwlock);
+				break;
+			case PRIV_BENCHMARK_SEQLOCK: {
+				uint32_t sequence;
+				size_t value;
+				do {
+					sequence = BC_SeqlockReadBegin(&PRIV_BenchmarkLockState.seqlock);
+					value = BC_atomic_load_relaxed(&PRIV_BenchmarkLockState.first) + BC_atomic_load_relaxed(&PRIV_BenchmarkLockState.second);
+				} while (BC_SeqlockReadRetry(&PRIV_BenchmarkLockState.seqlock, sequence));
+				local += value;
+				break;
+			}
+			case PRIV_BENCHMARK_STRING_POOL: {
+				const BO_StringPooledRef string = BO_StringPooled("benchmark interned");
+				local += BO_StringLength(string);
+				BO_Release($OBJ string);
+				break;
+			}
+		}
+	}
+	*sum = local;
+}
+
+static void PRIV_BenchmarkLockScaling(const char* name, const PRIV_BenchmarkLockKind kind) {
+	BT_Test(name);
+	PRIV_BenchmarkLockState.kind = kind;
+
+	for (int threadCount = 1; threadCount <= BENCHMARK_MAX_THREADS; threadCount *= 2) {
+		BCThread threads[BENCHMARK_MAX_THREADS];
+		size_t sums[BENCHMARK_MAX_THREADS];
+
+		const double start = BT_GetWallTimeMicroseconds();
+		for (int i = 0; i < threadCount; i++) {
+			BC_ThreadCreate(&threads[i], PRIV_BenchmarkLockReader, &sums[i]);
+		}
+		for (int i = 0; i < threadCount; i++) {
+			BC_ThreadJoin(threads[i]);
+		}
+		const double elapsed = BT_GetWallTimeMicroseconds() - start;
+
+		const double reads = (double)threadCount * BENCHMARK_READS;
+		BT_Print("    %d thread(s): %.2f μs (%.2f M reads per second)\n",
+			threadCount, elapsed, reads / elapsed);
+	}
+}
+#endif
+
+void BT_BenchmarkLocks(void) {
+	BT_Title("Read Scaling Benchmark");
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+	BC_LockInit(&PRIV_BenchmarkLockState.lock);
+	BC_RWLockInit(&PRIV_BenchmarkLockState.rwlock);
+	BC_SeqlockInit(&PRIV_BenchmarkLockState.seqlock);
+	BC_atomic_store(&PRIV_BenchmarkLockState.first, 1);
+	BC_atomic_store(&PRIV_BenchmarkLockState.second, 2);
+
+	PRIV_BenchmarkLockScaling("Adaptive lock", PRIV_BENCHMARK_LOCK);
+	PRIV_BenchmarkLockScaling("Reader writer lock", PRIV_BENCHMARK_RWLOCK);
+	PRIV_BenchmarkLockScaling("Sequence lock", PRIV_BENCHMARK_SEQLOCK);
+	PRIV_BenchmarkLockScaling("String pool lookup", PRIV_BENCHMARK_STRING_POOL);
+
+	BC_SeqlockDestroy(&PRIV_BenchmarkLockState.seqlock);
+	BC_RWLockDestroy(&PRIV_BenchmarkLockState.rwlock);
+	BC_LockDestroy(&PRIV_BenchmarkLockState.lock);
+#else
+	BT_Print("    Requires thread safety\n");
+#endif
+}
@@ -4,5 +4,7 @@
 #include "../Commons/BT_Common.h"
 
 void BT_BenchmarkAutoreleasePool();
+void BT_BenchmarkAllocators();
+void BT_BenchmarkLocks();
 
 #endif //BRUNTIME_BT_BENCHMARKS_H
\ No newline at end of file
@@ -20,4 +20,10 @@ void BT_PrintSubTitle(const char* _x_) {
 
 double BT_GetTimeMicroseconds(clock_t start, clock_t end) {
 	return ((double)(end - start) / CLOCKS_PER_SEC) * 1000000.0;
+}
+
+double BT_GetWallTimeMicroseconds(void) {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
 }
\ No newline at end of file
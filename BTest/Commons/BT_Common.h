@@ -21,6 +21,8 @@ void BT_PrintBigTitle(const char* _x_);
 void BT_PrintSubTitle(const char* _x_);
 
 double BT_GetTimeMicroseconds(clock_t start, clock_t end);
+// Wall clock, clock() adds up the CPU time of every thread
+double BT_GetWallTimeMicroseconds(void);
 
 #define BT_Print(...) BF_Print(__VA_ARGS__)
 
@@ -0,0 +1,665 @@
+#include "BT_Tests.h"
+
+#include <BCore/Memory/BC_AllocatorTracker.h>
+#include <BCore/Memory/BC_Arena.h>
+#include <BCore/Memory/BC_Memory.h>
+#include <BCore/Memory/BC_MemoryMonitor.h>
+#include <BCore/Memory/BC_MemoryProfile.h>
+#include <BCore/Memory/BC_MemorySampler.h>
+#include <BCore/Memory/BC_Pool.h>
+#include <BCore/Memory/BC_Slab.h>
+#include <BCore/Memory/BC_ThreadCache.h>
+#include <BCore/Memory/BC_VirtualMemory.h>
+#include <BCore/Thread/BC_Threads.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1 && BC_SETTINGS_ENABLE_THREAD_SAFETY == 1 && !defined(_WIN32)
+#include <pthread.h>
+
+static void* PRIV_TestMemoryFreeOnThread(void* ptr) {
+	BC_Free(ptr);
+	for (int i = 0; i < 100; i++) {
+		BC_Free(BC_Malloc(1000));
+	}
+	return NULL;
+}
+#endif
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1 && !defined(_WIN32)
+#include <pthread.h>
+
+static void* PRIV_TestMemoryRemoteFree(void* ptr) {
+	BC_AllocatorFree(kBC_AllocatorRefThreadCache, ptr);
+	return NULL;
+}
+#endif
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_PROFILE == 1
+__attribute__((noinline))
+static void** PRIV_TestMemoryGrowHeap(const size_t count) {
+	void** blocks = BC_Malloc(count * sizeof(void*));
+	for (size_t i = 0; i < count; i++) {
+		blocks[i] = BC_Malloc(1000);
+	}
+	return blocks;
+}
+#endif
+
+// Records block sizes so sized frees can be checked against them
+typedef struct PRIV_TestSizedAllocator {
+	void* blocks[64];
+	size_t sizes[64];
+	size_t mismatches;
+	size_t unsizedFrees;
+} PRIV_TestSizedAllocator;
+
+static void* IMPL_TestSizedAlloc(const size_t size, const void* ctx) {
+	PRIV_TestSizedAllocator* state = (PRIV_TestSizedAllocator*)ctx;
+	void* ptr = BC_Malloc(size);
+	for (size_t i = 0; i < 64; i++) {
+		if (!state->blocks[i]) {
+			state->blocks[i] = ptr;
+			state->sizes[i] = size;
+			break;
+		}
+	}
+	return ptr;
+}
+
+static void IMPL_TestSizedFreeSized(void* ptr, const size_t size, const void* ctx) {
+	PRIV_TestSizedAllocator* state = (PRIV_TestSizedAllocator*)ctx;
+	for (size_t i = 0; i < 64; i++) {
+		if (state->blocks[i] == ptr) {
+			if (state->sizes[i] != size) state->mismatches++;
+			state->blocks[i] = NULL;
+			break;
+		}
+	}
+	BC_Free(ptr);
+}
+
+static void IMPL_TestSizedFree(void* ptr, const void* ctx) {
+	PRIV_TestSizedAllocator* state = (PRIV_TestSizedAllocator*)ctx;
+	state->unsizedFrees++;
+	for (size_t i = 0; i < 64; i++) {
+		if (state->blocks[i] == ptr) state->blocks[i] = NULL;
+	}
+	BC_Free(ptr);
+}
+
+void BT_TestMemory() {
+	BT_Title("Memory Tests");
+
+	// Test 1: Slab size classes
+	{
+		BT_Test("Slab allocator size classes");
+
+		const BC_SlabRef slab = BC_SlabCreate(NULL);
+		const BC_AllocatorRef allocator = BC_SlabAllocator(slab);
+
+		void* small = BC_AllocatorAlloc(allocator, 24);
+		void* medium = BC_AllocatorAlloc(allocator, 200);
+		void* large = BC_AllocatorAlloc(allocator, 4096);
+
+		BT_Assert(small && medium && large, "Small, medium and large blocks allocated");
+		BT_Assert(((uintptr_t)small & 15) == 0 && ((uintptr_t)medium & 15) == 0 && ((uintptr_t)large & 15) == 0, "Blocks are 16 bytes aligned");
+
+		memset(large, 0xAB, 4096);
+		BC_AllocatorFree(allocator, small);
+		void* reused = BC_AllocatorAlloc(allocator, 20);
+		BT_Assert(reused == small, "Freed block is reused by the same size class");
+
+		BC_AllocatorFree(allocator, reused);
+		BC_AllocatorFree(allocator, medium);
+		BC_AllocatorFree(allocator, large);
+		BT_Assert(BC_SlabPageCount(slab) == 2, "One page per touched size class");
+
+		BC_SlabDestroy(slab);
+	}
+
+	// Test 2: Objects on the shared slab
+	{
+		BT_Test("Objects allocated through kBC_AllocatorRefSlab");
+
+		const BC_AllocatorRef previous = BC_AllocatorGetDefault();
+		BC_AllocatorSetDefault(kBC_AllocatorRefSlab);
+
+		$LET list = BO_ListCreate();
+		for (int i = 0; i < 1000; i++) {
+			$LET number = BO_NumberCreateInt32(i);
+			BO_ListAdd(list, $OBJ number);
+			BO_Release($OBJ number);
+		}
+		BT_Assert(BO_ObjectGetAllocator($OBJ list) == kBC_AllocatorRefSlab, "List uses the slab allocator");
+		BT_Assert(BO_NumberGetInt32((BO_NumberRef)BO_ListGet(list, 999)) == 999, "List content is intact");
+		BO_Release($OBJ list);
+
+		BC_AllocatorSetDefault(previous);
+	}
+
+	// Test 3: Arena chunk chaining
+	{
+		BT_Test("Arena grows by chaining chunks");
+
+		const BC_ArenaRef arena = BC_ArenaCreate(NULL, 1024);
+		const BC_AllocatorRef allocator = BC_ArenaAllocator(arena);
+
+		for (int i = 0; i < 64; i++) {
+			void* ptr = BC_AllocatorAlloc(allocator, 100);
+			BT_AssertSilent(ptr != NULL, "Arena allocation beyond the first chunk failed");
+			memset(ptr, i, 100);
+		}
+		BT_Assert(BC_ArenaUsed(arena) >= 6400, "Used bytes span every chunk");
+		BT_Assert(BC_ArenaCapacity(arena) > 1024, "Capacity grew past the initial buffer");
+
+		const size_t grownCapacity = BC_ArenaCapacity(arena);
+		BC_ArenaReset(arena);
+		BT_Assert(BC_ArenaUsed(arena) == 0, "Reset clears used bytes");
+		BT_Assert(BC_ArenaCapacity(arena) == grownCapacity, "Reset keeps chunks under the retain limit");
+
+		for (int i = 0; i < 64; i++) {
+			BC_AllocatorAlloc(allocator, 100);
+		}
+		BT_Assert(BC_ArenaCapacity(arena) == grownCapacity, "Second frame reuses retained chunks");
+
+		BC_ArenaReset(arena);
+		BC_ArenaSetRetainLimit(arena, 0);
+		BT_Assert(BC_ArenaCapacity(arena) == 1024, "Zero retain limit releases chained chunks");
+
+		BC_ArenaDestroy(arena);
+	}
+
+	// Test 4: Arena savepoints
+	{
+		BT_Test("Arena mark and rewind");
+
+		const BC_ArenaRef arena = BC_ArenaCreate(NULL, 256);
+		const BC_AllocatorRef allocator = BC_ArenaAllocator(arena);
+
+		void* persistent = BC_AllocatorAlloc(allocator, 64);
+		const size_t usedBefore = BC_ArenaUsed(arena);
+
+		const BC_ArenaSavepoint savepoint = BC_ArenaMark(arena);
+		void* scratch = BC_AllocatorAlloc(allocator, 32);
+		BC_AllocatorAlloc(allocator, 2048);
+		BC_ArenaRewind(savepoint);
+
+		BT_Assert(BC_ArenaUsed(arena) == usedBefore, "Rewind restores used bytes across chunks");
+		BT_Assert(BC_AllocatorAlloc(allocator, 32) == scratch, "Rewound memory is handed out again");
+
+		size_t usedInScope = 0;
+		BC_ArenaScope(arena) {
+			BC_AllocatorAlloc(allocator, 512);
+			usedInScope = BC_ArenaUsed(arena);
+		}
+		BT_Assert(usedInScope > BC_ArenaUsed(arena), "BC_ArenaScope releases its temporaries");
+		BT_Assert(persistent != NULL, "Allocations before the savepoint are kept");
+
+		BC_ArenaDestroy(arena);
+	}
+
+	// Test 5: Aligned allocations
+	{
+		BT_Test("Aligned allocations");
+
+		void* system = BC_AllocatorAllocAligned(NULL, 100, BC_CACHE_LINE_SIZE);
+		BT_Assert(((uintptr_t)system & (BC_CACHE_LINE_SIZE - 1)) == 0, "System allocator honors alignment");
+		BC_AllocatorFreeAligned(NULL, system);
+
+		void* slab = BC_AllocatorAllocAligned(kBC_AllocatorRefSlab, 40, 32);
+		BT_Assert(((uintptr_t)slab & 31) == 0, "Fallback path honors alignment");
+		BC_AllocatorFreeAligned(kBC_AllocatorRefSlab, slab);
+
+		const BC_ArenaRef arena = BC_ArenaCreate(NULL, 256);
+		const BC_AllocatorRef allocator = BC_ArenaAllocator(arena);
+		BC_AllocatorAlloc(allocator, 3);
+		void* aligned = BC_AllocatorAllocAligned(allocator, 64, BC_CACHE_LINE_SIZE);
+		void* chained = BC_AllocatorAllocAligned(allocator, 512, 256);
+		BT_Assert(((uintptr_t)aligned & (BC_CACHE_LINE_SIZE - 1)) == 0, "Arena honors alignment");
+		BT_Assert(((uintptr_t)chained & 255) == 0, "Arena honors alignment in chained chunks");
+		BC_ArenaDestroy(arena);
+
+		BT_Assert(BC_AllocatorAllocAligned(NULL, 16, 24) == NULL, "Alignment must be a power of two");
+
+		const BO_BytesArrayRef bytes = BO_BytesArrayCreateAligned(48, BC_CACHE_LINE_SIZE);
+		BT_Assert(((uintptr_t)BO_BytesArrayBytes(bytes) & (BC_CACHE_LINE_SIZE - 1)) == 0, "Bytes array honors alignment");
+		const BO_BytesArrayRef copy = (BO_BytesArrayRef)BO_Copy((BO_ObjectRef)bytes);
+		BT_Assert(((uintptr_t)BO_BytesArrayBytes(copy) & (BC_CACHE_LINE_SIZE - 1)) == 0, "Bytes array copy keeps alignment");
+		BO_Release((BO_ObjectRef)copy);
+		BO_Release((BO_ObjectRef)bytes);
+	}
+
+	// Test 6: Reallocation in place
+	{
+		BT_Test("Realloc grows in place");
+
+		const BC_ArenaRef arena = BC_ArenaCreate(NULL, 1024);
+		const BC_AllocatorRef allocator = BC_ArenaAllocator(arena);
+		char* last = BC_AllocatorAlloc(allocator, 64);
+		memset(last, 'a', 64);
+		BT_Assert(BC_AllocatorRealloc(allocator, last, 64, 512) == last, "Arena grows its last block in place");
+		BT_Assert(BC_ArenaUsed(arena) == 512, "In place growth only consumes the difference");
+
+		char* moved = BC_AllocatorRealloc(allocator, last, 512, 2048);
+		BT_Assert(moved != last && moved[63] == 'a', "Arena moves a block that no longer fits");
+		BC_ArenaDestroy(arena);
+
+		void* small = BC_AllocatorAlloc(kBC_AllocatorRefSlab, 20);
+		BT_Assert(BC_AllocatorRealloc(kBC_AllocatorRefSlab, small, 20, 24) == small, "Slab keeps blocks within their size class");
+		BC_AllocatorFree(kBC_AllocatorRefSlab, small);
+
+		const BC_ArenaRef builderArena = BC_ArenaCreate(NULL, BC_KB(64));
+		const BO_StringBuilderRef builder = BO_StringBuilderCreate(BC_ArenaAllocator(builderArena));
+		for (int i = 0; i < 1000; i++) {
+			BO_StringBuilderAppendChar(builder, 'x');
+		}
+		BT_Assert(BO_StringBuilderLength(builder) == 1000, "String builder grows through the allocator");
+		BT_Assert(BC_ArenaUsed(builderArena) < 1536, "String builder buffer grew in place");
+		BO_Release((BO_ObjectRef)builder);
+		BC_ArenaDestroy(builderArena);
+	}
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_TRACK == 1
+	// Test 7: Sharded allocation tracking
+	{
+		BT_Test("Allocation tracking across threads");
+
+		BC_MemoryInfo before, after;
+		BC_MemoryInfoGet(&before);
+
+		void* block = BC_Malloc(BC_KB(128));
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1 && !defined(_WIN32)
+		pthread_t thread;
+		pthread_create(&thread, NULL, PRIV_TestMemoryFreeOnThread, block);
+		pthread_join(thread, NULL);
+		const size_t expectedAllocations = 101;
+#else
+		BC_Free(block);
+		const size_t expectedAllocations = 1;
+#endif
+
+		BC_MemoryInfoGet(&after);
+		BT_Assert(after.allocationCount - before.allocationCount == expectedAllocations, "Allocations from every thread are counted");
+		BT_Assert(after.freeCount - before.freeCount == expectedAllocations, "Frees from every thread are counted");
+		BT_Assert(after.currentAllocUsage == before.currentAllocUsage, "Freeing on another thread balances usage");
+		BT_Assert(after.peakAllocUsage >= before.currentAllocUsage + BC_KB(128), "Peak includes the large block");
+	}
+#endif
+
+#if BC_SETTINGS_DEBUG_ALLOCATION_PROFILE == 1
+	// Test 8: Heap profile snapshots
+	{
+		BT_Test("Heap snapshot diff by allocation site");
+
+		const BC_MemorySnapshotRef before = BC_MemorySnapshotTake();
+		void** blocks = PRIV_TestMemoryGrowHeap(10);
+		const BC_MemorySnapshotRef after = BC_MemorySnapshotTake();
+
+		BC_MemorySiteDiff diffs[4];
+		const size_t count = BC_MemorySnapshotDiff(before, after, diffs, 4);
+		BT_Assert(count >= 2, "Both allocation sites are reported");
+		BT_Assert(diffs[0].bytesDelta == 10000 && diffs[0].countDelta == 10, "Top grower is the loop allocation");
+		BT_Assert(BC_MemorySnapshotLiveBytes(after) - BC_MemorySnapshotLiveBytes(before) == 10000 + 10 * sizeof(void*), "Snapshots account every live byte");
+
+		for (size_t i = 0; i < 10; i++) {
+			BC_Free(blocks[i]);
+		}
+		BC_Free(blocks);
+
+		const BC_MemorySnapshotRef released = BC_MemorySnapshotTake();
+		BT_Assert(BC_MemorySnapshotDiff(before, released, diffs, 4) == 0, "Freed blocks leave no growth");
+
+		BC_MemorySnapshotDestroy(released);
+		BC_MemorySnapshotDestroy(after);
+		BC_MemorySnapshotDestroy(before);
+	}
+#endif
+
+#if BC_SETTINGS_ALLOCATION_SAMPLING == 1
+	// Test 9: Allocation sampling
+	{
+		BT_Test("Allocation sampler");
+
+		BC_MemorySamplerReset();
+		BC_MemorySamplerSetInterval(BC_KB(1));
+		for (int i = 0; i < 10000; i++) {
+			BC_Free(BC_Malloc(100));
+		}
+		BC_MemorySamplerSetInterval(0);
+
+		const size_t samples = BC_MemorySamplerSampleCount();
+		// Each 100 bytes block is sampled with probability 1 - e^(-100 / 1024), about 930 samples
+		BT_Assert(samples > 700 && samples < 1200, "Samples follow the interval");
+
+		FILE* file = tmpfile();
+		BT_Assert(BC_MemorySamplerWriteProfileToFile(file, BC_MemorySamplerFormatPprof), "Pprof profile is written");
+		char header[128] = {0};
+		rewind(file);
+		fgets(header, sizeof(header), file);
+		BT_Assert(strncmp(header, "heap profile:", 13) == 0, "Pprof profile has the heap profile header");
+		BT_Assert(strstr(header, "heap_v2/1024\n") != NULL, "Pprof header keeps the interval samples were taken at");
+		fclose(file);
+
+		file = tmpfile();
+		BT_Assert(BC_MemorySamplerWriteProfileToFile(file, BC_MemorySamplerFormatFolded), "Folded profile is written");
+		BT_Assert(ftell(file) > 0, "Folded profile has stacks");
+		fclose(file);
+
+		BC_MemorySamplerReset();
+		BT_Assert(BC_MemorySamplerSampleCount() == 0, "Reset drops samples");
+
+		// Stacks claimed again after a reset start from zero
+		BC_MemorySamplerSetInterval(BC_KB(1));
+		for (int i = 0; i < 1000; i++) {
+			BC_Free(BC_Malloc(100));
+		}
+		BC_MemorySamplerSetInterval(0);
+
+		file = tmpfile();
+		BC_MemorySamplerWriteProfileToFile(file, BC_MemorySamplerFormatPprof);
+		size_t totalCount = 0;
+		size_t totalBytes = 0;
+		rewind(file);
+		const int parsed = fscanf(file, "heap profile: %*u: %*u [ %zu: %zu]", &totalCount, &totalBytes);
+		fclose(file);
+		BT_Assert(parsed == 2 && totalCount == BC_MemorySamplerSampleCount(), "Profiles after a reset only hold new samples");
+		BC_MemorySamplerReset();
+	}
+#endif
+
+	// Test 10: Thread caching allocator
+	{
+		BT_Test("Thread cache allocator");
+
+		void* small = BC_AllocatorAlloc(kBC_AllocatorRefThreadCache, 24);
+		void* large = BC_AllocatorAlloc(kBC_AllocatorRefThreadCache, 4096);
+		BT_Assert(small && large, "Small and large blocks allocated");
+		BT_Assert(((uintptr_t)small & 15) == 0 && ((uintptr_t)large & 15) == 0, "Blocks are 16 bytes aligned");
+		BC_AllocatorFree(kBC_AllocatorRefThreadCache, small);
+		BT_Assert(BC_AllocatorAlloc(kBC_AllocatorRefThreadCache, 24) == small, "Local free is reused right away");
+		BC_AllocatorFree(kBC_AllocatorRefThreadCache, large);
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1 && !defined(_WIN32)
+		pthread_t thread;
+		pthread_create(&thread, NULL, PRIV_TestMemoryRemoteFree, small);
+		pthread_join(thread, NULL);
+		BT_Assert(BC_AllocatorAlloc(kBC_AllocatorRefThreadCache, 24) == small, "Remote free returns the block to its owner");
+		BC_AllocatorFree(kBC_AllocatorRefThreadCache, small);
+#endif
+
+		const BC_AllocatorRef previous = BC_AllocatorGetDefault();
+		BC_AllocatorSetDefault(kBC_AllocatorRefThreadCache);
+		$LET list = BO_ListCreate();
+		for (int i = 0; i < 100; i++) {
+			$LET number = BO_NumberCreateInt32(i);
+			BO_ListAdd(list, $OBJ number);
+			BO_Release($OBJ number);
+		}
+		BT_Assert(BO_ObjectGetAllocator($OBJ list) == kBC_AllocatorRefThreadCache, "List uses the thread cache");
+		BT_Assert(BO_NumberGetInt32((BO_NumberRef)BO_ListGet(list, 99)) == 99, "List content is intact");
+		BO_Release($OBJ list);
+
+		BC_AllocatorSetDefault(previous);
+	}
+
+	// Test 11: Virtual memory arena
+	{
+		BT_Test("Virtual arena commits on demand");
+
+		const BC_ArenaRef arena = BC_ArenaCreateVirtual(BC_MB(64), BC_ArenaFlagNone);
+		const BC_AllocatorRef allocator = BC_ArenaAllocator(arena);
+		BT_Assert(BC_ArenaCapacity(arena) == 0, "Nothing is committed up front");
+
+		char* first = BC_AllocatorAlloc(allocator, BC_KB(4));
+		char* previous = first;
+		BC_bool contiguous = BC_true;
+		for (int i = 1; i < 2048; i++) {
+			char* ptr = BC_AllocatorAlloc(allocator, BC_KB(4));
+			contiguous = contiguous && ptr == previous + BC_KB(4);
+			memset(ptr, 0xAB, BC_KB(4));
+			previous = ptr;
+		}
+		BT_Assert(contiguous, "Growth stays in the reserved range without chaining");
+		BT_Assert(BC_ArenaCapacity(arena) >= BC_MB(8), "Pages are committed as the offset advances");
+
+		BC_ArenaReset(arena);
+		BT_Assert(BC_ArenaCapacity(arena) == BC_ARENA_DEFAULT_RETAIN_LIMIT, "Reset decommits above the retain limit");
+		BT_Assert(BC_AllocatorAlloc(allocator, 16) == first, "Reset reuses the same range");
+
+		BC_ArenaReset(arena);
+		BC_ArenaSetRetainLimit(arena, 0);
+		BT_Assert(BC_ArenaCapacity(arena) == 0, "Zero retain limit decommits everything");
+
+		BT_Assert(BC_AllocatorAlloc(allocator, BC_MB(65)) == NULL, "Allocations past the reserved range fail");
+		BC_ArenaDestroy(arena);
+	}
+
+	// Test 12: Huge pages
+	{
+		BT_Test("Huge page arena and allocator");
+
+		const BC_ArenaRef arena = BC_ArenaCreateVirtual(BC_MB(16), BC_ArenaFlagHugePages);
+		const BC_AllocatorRef allocator = BC_ArenaAllocator(arena);
+		char* first = BC_AllocatorAlloc(allocator, 64);
+		BT_Assert(((uintptr_t)first & (BC_VIRTUAL_HUGE_PAGE_SIZE - 1)) == 0, "Reserved range is 2MB aligned");
+		BT_Assert(BC_ArenaCapacity(arena) == BC_VIRTUAL_HUGE_PAGE_SIZE, "Commits in huge page steps");
+		memset(BC_AllocatorAlloc(allocator, BC_MB(5)), 1, BC_MB(5));
+		BC_ArenaReset(arena);
+		BT_Assert(BC_ArenaCapacity(arena) == BC_ARENA_DEFAULT_RETAIN_LIMIT, "Reset keeps whole huge pages");
+		BC_ArenaDestroy(arena);
+
+		// Sizes that are not whole pages still get their tail unmapped
+		const size_t pageSize = BC_VirtualPageSize();
+		char* odd = BC_VirtualReserveAligned(pageSize + 100, BC_VIRTUAL_HUGE_PAGE_SIZE);
+		BT_Assert(odd && ((uintptr_t)odd & (BC_VIRTUAL_HUGE_PAGE_SIZE - 1)) == 0, "Odd sized reservation is aligned");
+		BT_Assert(BC_VirtualCommit(odd, pageSize + 100), "Odd sized reservation commits");
+		odd[pageSize + 99] = 1;
+#if defined(__linux__)
+		BT_Assert(msync(odd + 2 * pageSize, pageSize, MS_ASYNC) != 0, "Over-reservation past the rounded size is released");
+#endif
+		BC_VirtualRelease(odd, pageSize + 100);
+
+		uint64_t* table = BC_AllocatorAllocAligned(kBC_AllocatorRefHugePages, BC_MB(4), 4096);
+		BT_Assert(table && ((uintptr_t)table & 4095) == 0, "Large block honors alignment");
+		BT_Assert(table[0] == 0 && table[BC_MB(4) / sizeof(uint64_t) - 1] == 0, "Large block is zeroed");
+		BC_AllocatorFreeAligned(kBC_AllocatorRefHugePages, table);
+
+		char* wide = BC_AllocatorAllocAligned(kBC_AllocatorRefHugePages, BC_MB(4), BC_MB(8));
+		BT_Assert(wide && ((uintptr_t)wide & (BC_MB(8) - 1)) == 0, "Alignment past the huge page size is honored");
+		BC_AllocatorFreeAligned(kBC_AllocatorRefHugePages, wide);
+
+		uint64_t* smallArray = BC_HugePagesArrayAlloc(16, sizeof(uint64_t));
+		uint64_t* largeArray = BC_HugePagesArrayAlloc(BC_VIRTUAL_HUGE_PAGE_THRESHOLD / sizeof(uint64_t), sizeof(uint64_t));
+		BT_Assert(smallArray && largeArray && smallArray[15] == 0 && largeArray[BC_VIRTUAL_HUGE_PAGE_THRESHOLD / sizeof(uint64_t) - 1] == 0, "Huge page arrays are zeroed on both paths");
+		BC_HugePagesArrayFree(smallArray, 16, sizeof(uint64_t));
+		BC_HugePagesArrayFree(largeArray, BC_VIRTUAL_HUGE_PAGE_THRESHOLD / sizeof(uint64_t), sizeof(uint64_t));
+
+		char* small = BC_AllocatorAlloc(kBC_AllocatorRefHugePages, 100);
+		BT_Assert(small && small[99] == 0, "Small block falls back to the heap, zeroed");
+		BC_AllocatorFree(kBC_AllocatorRefHugePages, small);
+
+		const BO_BytesArrayRef bytes = BO_BytesArrayCreateAligned(BC_MB(3), BC_CACHE_LINE_SIZE);
+		BO_BytesArraySet(bytes, BC_MB(3) - 1, 0x42);
+		const BO_BytesArrayRef copy = (BO_BytesArrayRef)BO_Copy((BO_ObjectRef)bytes);
+		BT_Assert(((uintptr_t)BO_BytesArrayBytes(bytes) & (BC_CACHE_LINE_SIZE - 1)) == 0, "Large bytes array keeps alignment");
+		BT_Assert(BO_Equal((BO_ObjectRef)bytes, (BO_ObjectRef)copy), "Large bytes array copies its payload");
+		BO_Release((BO_ObjectRef)copy);
+		BO_Release((BO_ObjectRef)bytes);
+	}
+
+	// Test 13: Sized deallocation
+	{
+		BT_Test("Sized deallocation");
+
+		PRIV_TestSizedAllocator state = {0};
+		BC_Allocator sized = {IMPL_TestSizedAlloc, IMPL_TestSizedFree, &state, NULL, NULL, IMPL_TestSizedFreeSized};
+
+		const BC_AllocatorRef previous = BC_AllocatorGetDefault();
+		BC_AllocatorSetDefault(&sized);
+
+		$LET string = BO_StringCreate("sized string");
+		$LET bytes = BO_BytesArrayCreateAligned(100, 32);
+		$LET list = BO_ListCreate();
+		BO_ListAdd(list, $OBJ string);
+		$LET builder = BO_StringBuilderCreate(NULL);
+		for (int i = 0; i < 300; i++) {
+			BO_StringBuilderAppendChar(builder, 'x');
+		}
+
+		BC_AllocatorSetDefault(previous);
+
+		BO_Release($OBJ builder);
+		BO_Release($OBJ list);
+		BO_Release($OBJ bytes);
+		BO_Release($OBJ string);
+
+		BC_bool allFreed = BC_true;
+		for (size_t i = 0; i < 64; i++) {
+			if (state.blocks[i]) allFreed = BC_false;
+		}
+		BT_Assert(allFreed, "Every block went back to the allocator");
+		BT_Assert(state.unsizedFrees == 0, "Objects, buffers and reallocations free with a size");
+		BT_Assert(state.mismatches == 0, "Sizes match the allocation sizes");
+	}
+
+	// Test 14: Memory telemetry
+	{
+		BT_Test("Live RSS and memory monitor");
+
+		BC_MemoryInfo info;
+		BC_MemoryInfoGet(&info);
+		BT_Assert(info.system_current_rss > 0 && info.system_current_rss <= info.system_peak_rss, "Current RSS is at most the peak");
+		BT_Assert(info.system_pss > 0, "PSS is reported");
+#if defined(__linux__)
+		BT_Assert(info.system_rss_anonymous + info.system_rss_file == info.system_current_rss, "RSS splits into anonymous and file pages");
+#endif
+
+		BT_Assert(BC_MemoryMonitorStart(1, 8), "Monitor starts");
+		const uint64_t start = BC_TimeMonotonicNanoseconds();
+		const BC_ArenaRef arena = BC_ArenaCreate(NULL, BC_MB(1));
+		BC_MemoryMonitorRecord();
+		BC_ThreadSleep(30000000);
+		BC_MemoryMonitorStop();
+
+		BC_MemorySample samples[16];
+		const size_t count = BC_MemoryMonitorQuery(0, samples, 16);
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		BT_Assert(count == 8, "Ring buffer keeps the last samples");
+#else
+		BT_Assert(count == 1, "Only recorded samples without a background thread");
+#endif
+		BC_bool ordered = BC_true;
+		for (size_t i = 1; i < count; i++) {
+			if (samples[i].timestamp < samples[i - 1].timestamp) ordered = BC_false;
+		}
+		BT_Assert(ordered, "Samples come oldest first");
+		BT_Assert(samples[count - 1].rss > 0 && samples[count - 1].arenaCapacity >= BC_MB(1), "Samples carry RSS and arena capacity");
+		BT_Assert(BC_MemoryMonitorQuery(start, samples, 16) > 0, "Query filters by time");
+		BT_Assert(BC_MemoryMonitorQuery(BC_TimeMonotonicNanoseconds(), samples, 16) == 0, "No sample from the future");
+
+		BC_ArenaDestroy(arena);
+	}
+
+	// Test 15: Per allocator tracking
+	{
+		BT_Test("Allocator tracker");
+
+		const BC_SlabRef slab = BC_SlabCreate(NULL);
+		const BC_ArenaRef arena = BC_ArenaCreate(NULL, BC_KB(64));
+		const BC_AllocatorTrackerRef slabTracker = BC_AllocatorTrackerCreate("slab", BC_SlabAllocator(slab));
+		const BC_AllocatorTrackerRef arenaTracker = BC_AllocatorTrackerCreate("arena", BC_ArenaAllocator(arena));
+		const BC_AllocatorTrackerRef systemTracker = BC_AllocatorTrackerCreate("system", NULL);
+		BT_Assert(strcmp(BC_AllocatorTrackerName(slabTracker), "slab") == 0, "Tracker keeps its name");
+
+		const BC_AllocatorRef slabAlloc = BC_AllocatorTrackerAllocator(slabTracker);
+		void* blocks[32];
+		for (size_t i = 0; i < 32; i++) {
+			blocks[i] = BC_AllocatorAlloc(slabAlloc, 24);
+			memset(blocks[i], (int)i, 24);
+		}
+		for (size_t i = 0; i < 16; i++) {
+			BC_AllocatorFree(slabAlloc, blocks[i]);
+		}
+
+		BC_AllocatorTrackerStats stats;
+		BC_AllocatorTrackerGetStats(slabTracker, &stats);
+		BT_Assert(stats.allocationCount == 32 && stats.freeCount == 16, "Allocations and frees are counted");
+		BT_Assert(stats.currentUsage == 16 * 24 && stats.peakUsage == 32 * 24, "Live bytes and peak are tracked");
+		BT_Assert(stats.histogram[1] == 32, "24 byte blocks land in the 32 byte bucket");
+
+		for (size_t i = 16; i < 32; i++) {
+			BC_AllocatorFreeSized(slabAlloc, blocks[i], 24);
+		}
+		BC_AllocatorTrackerGetStats(slabTracker, &stats);
+		BT_Assert(stats.currentUsage == 0 && stats.freeCount == 32, "Sized frees are counted");
+
+		const BC_AllocatorRef arenaAlloc = BC_AllocatorTrackerAllocator(arenaTracker);
+		char* grown = BC_AllocatorAlloc(arenaAlloc, 100);
+		memset(grown, 7, 100);
+		grown = BC_AllocatorRealloc(arenaAlloc, grown, 100, 5000);
+		BT_Assert(grown[99] == 7, "Realloc keeps the contents");
+		void* aligned = BC_AllocatorAllocAligned(arenaAlloc, 64, 256);
+		BT_Assert(((uintptr_t)aligned & 255) == 0, "Aligned blocks keep their alignment");
+		BC_AllocatorTrackerGetStats(arenaTracker, &stats);
+		BT_Assert(stats.currentUsage == 5064 && stats.totalAllocated == 5164, "Realloc moves usage to the new size");
+		BT_Assert(stats.histogram[9] == 1 && stats.histogram[2] == 1, "Histogram buckets by size");
+		BC_AllocatorFreeAligned(arenaAlloc, aligned);
+		BC_AllocatorFree(arenaAlloc, grown);
+
+		const BC_AllocatorRef systemAlloc = BC_AllocatorTrackerAllocator(systemTracker);
+		void* huge = BC_AllocatorAlloc(systemAlloc, BC_MB(1));
+		BC_AllocatorTrackerGetStats(systemTracker, &stats);
+		BT_Assert(stats.histogram[BC_ALLOCATOR_TRACKER_HISTOGRAM_BUCKETS - 1] == 1, "Large blocks land in the last bucket");
+		BC_AllocatorTrackerReset(systemTracker);
+		BC_AllocatorTrackerGetStats(systemTracker, &stats);
+		BT_Assert(stats.allocationCount == 0 && stats.peakUsage == BC_MB(1), "Reset keeps live usage as the peak");
+		BC_AllocatorFree(systemAlloc, huge);
+
+		BC_AllocatorTrackerPrintAll();
+
+		BC_AllocatorTrackerDestroy(systemTracker);
+		BC_AllocatorTrackerDestroy(arenaTracker);
+		BC_AllocatorTrackerDestroy(slabTracker);
+		BC_ArenaDestroy(arena);
+		BC_SlabDestroy(slab);
+	}
+
+	// Test 16: Fixed size pool
+	{
+		BT_Test("Fixed size pool");
+
+		const BC_PoolRef pool = BC_PoolCreate(NULL, 40, 8);
+		const BC_AllocatorRef alloc = BC_PoolAllocator(pool);
+		BT_Assert(BC_PoolObjectSize(pool) == 48, "Object size is rounded to 16 bytes");
+
+		BT_Assert(BC_PoolPrefill(pool, 20), "Prefill succeeds");
+		BT_Assert(BC_PoolPageCount(pool) == 3 && BC_PoolAvailableCount(pool) == 24, "Prefill allocates whole pages");
+
+		void* objects[24];
+		BC_bool aligned = BC_true;
+		for (size_t i = 0; i < 24; i++) {
+			objects[i] = BC_AllocatorAlloc(alloc, 40);
+			memset(objects[i], (int)i, 40);
+			if ((uintptr_t)objects[i] & 15) aligned = BC_false;
+		}
+		BT_Assert(aligned, "Objects are 16 bytes aligned");
+		BT_Assert(BC_PoolPageCount(pool) == 3 && BC_PoolAvailableCount(pool) == 0, "Prefilled objects need no new page");
+		BT_Assert(BC_AllocatorAlloc(alloc, 64) == NULL, "Objects larger than the pool size are refused");
+
+		BC_AllocatorFree(alloc, objects[5]);
+		BT_Assert(BC_AllocatorAlloc(alloc, 8) == objects[5], "Freed objects are reused first");
+		BT_Assert(BC_AllocatorRealloc(alloc, objects[5], 8, 48) == objects[5], "Realloc within the object size stays in place");
+
+		void* extra = BC_AllocatorAlloc(alloc, 40);
+		BT_Assert(extra && BC_PoolPageCount(pool) == 4, "Pool grows by a page when exhausted");
+
+		BC_PoolReleaseAll(pool);
+		BT_Assert(BC_PoolAvailableCount(pool) == 32 && BC_PoolPageCount(pool) == 4, "Release all keeps the pages");
+		BT_Assert(BC_AllocatorAlloc(alloc, 40) == objects[0], "Pages are carved again from the first one");
+
+		BC_PoolDestroy(pool);
+	}
+}
@@ -0,0 +1,946 @@
+#include "BT_Tests.h"
+
+#include <BCore/Memory/BC_Memory.h>
+#include <BCore/Thread/BC_Atomics.h>
+#include <BCore/Thread/BC_Epoch.h>
+#include <BCore/Thread/BC_Fiber.h>
+#include <BCore/Thread/BC_Queue.h>
+#include <BCore/Thread/BC_RunLoop.h>
+#include <BCore/Thread/BC_TaskPool.h>
+#include <BCore/Thread/BC_Threads.h>
+
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// =========================================================
+// MARK: Helpers
+// =========================================================
+
+static void PRIV_TestTaskIncrement(void* arg) {
+	BC_atomic_fetch_add((BC_atomic_size*)arg, 1);
+}
+
+typedef struct PRIV_TestFib {
+	BC_TaskPoolRef pool;
+	size_t n;
+	size_t result;
+} PRIV_TestFib;
+
+static void PRIV_TestTaskFib(void* arg) {
+	PRIV_TestFib* fib = arg;
+	if (fib->n < 2) {
+		fib->result = fib->n;
+		return;
+	}
+
+	// Waits from inside a task, the waiting worker keeps running the subtasks
+	PRIV_TestFib left = {fib->pool, fib->n - 1, 0};
+	PRIV_TestFib right = {fib->pool, fib->n - 2, 0};
+	BC_TaskGroup group = BC_TASK_GROUP_INIT;
+	BC_TaskPoolSubmit(fib->pool, &group, PRIV_TestTaskFib, &left);
+	PRIV_TestTaskFib(&right);
+	BC_TaskGroupWait(fib->pool, &group);
+	fib->result = left.result + right.result;
+}
+
+static void PRIV_TestTaskRange(const size_t begin, const size_t end, void* arg) {
+	BC_atomic_uint8* visits = arg;
+	for (size_t i = begin; i < end; i++) {
+		BC_atomic_fetch_add(&visits[i], 1);
+	}
+}
+
+static void PRIV_TestTaskAutorelease(void* arg) {
+	// Released by the pool pushed around the task, leaks show up in the allocation report
+	const BO_ObjectRef string = BF_Autorelease($OBJ BO_StringCreate("autoreleased in a task"));
+	if (string) BC_atomic_fetch_add((BC_atomic_size*)arg, 1);
+}
+
+// Counts the items queues still hold when they are destroyed
+static size_t gTestQueueReleased = 0;
+
+static void PRIV_TestQueueRelease(void* item) {
+	gTestQueueReleased++;
+	kBO_QueueCallbacksObject.release(item);
+}
+
+static BO_ObjectRef PRIV_TestListDouble(const BO_ObjectRef item, const size_t index, void* ctx) {
+	(void)index;
+	(void)ctx;
+	return BF_Autorelease($OBJ BO_NumberCreateInt64(BO_NumberGetInt64((BO_NumberRef)item) * 2));
+}
+
+static BC_bool PRIV_TestListIsEven(const BO_ObjectRef item, const size_t index, void* ctx) {
+	(void)index;
+	(void)ctx;
+	return BO_NumberGetInt64((BO_NumberRef)item) % 2 == 0;
+}
+
+static BO_ObjectRef PRIV_TestListSum(const BO_ObjectRef accumulator, const BO_ObjectRef item, void* ctx) {
+	(void)ctx;
+	return BF_Autorelease($OBJ BO_NumberCreateInt64(BO_NumberGetInt64((BO_NumberRef)accumulator) + BO_NumberGetInt64((BO_NumberRef)item)));
+}
+
+static void PRIV_TestListVisit(const BO_ObjectRef item, const size_t index, void* ctx) {
+	(void)item;
+	BC_atomic_fetch_add((BC_atomic_size*)ctx, index + 1);
+}
+
+static BO_ObjectRef PRIV_TestFutureCompute(void* ctx) {
+	return BF_Autorelease($OBJ BO_NumberCreateInt64((int64_t)(intptr_t)ctx));
+}
+
+static BO_ObjectRef PRIV_TestFutureDouble(const BO_ObjectRef value, void* ctx) {
+	(void)ctx;
+	return BF_Autorelease($OBJ BO_NumberCreateInt64(BO_NumberGetInt64((BO_NumberRef)value) * 2));
+}
+
+static BO_ObjectRef PRIV_TestFutureChain(const BO_ObjectRef value, void* ctx) {
+	(void)ctx;
+	return BF_Autorelease($OBJ BO_FutureAsync(PRIV_TestFutureCompute, (void*)(intptr_t)(BO_NumberGetInt64((BO_NumberRef)value) + 1)));
+}
+
+static void PRIV_TestFutureCount(const BO_FutureRef future, void* ctx) {
+	(void)future;
+	BC_atomic_fetch_add((BC_atomic_size*)ctx, 1);
+}
+
+typedef struct PRIV_TestFiberTrace {
+	int steps[8];
+	size_t count;
+} PRIV_TestFiberTrace;
+
+static void PRIV_TestFiberSteps(void* arg) {
+	PRIV_TestFiberTrace* trace = arg;
+	for (int i = 1; i < 6; i += 2) {
+		trace->steps[trace->count++] = i;
+		if (i < 5) BC_FiberYield();
+	}
+}
+
+static void PRIV_TestFiberCount(void* arg) {
+	for (int i = 0; i < 3; i++) {
+		BC_atomic_fetch_add((BC_atomic_size*)arg, 1);
+		BC_FiberYield();
+	}
+}
+
+// Keeps an autoreleased number across a yield, the resumer drains its own pool meanwhile
+static void PRIV_TestFiberAutorelease(void* arg) {
+	const BO_NumberRef number = (BO_NumberRef)BF_Autorelease($OBJ BO_NumberCreateInt64(5));
+	BC_FiberYield();
+	*(int64_t*)arg = BO_NumberGetInt64(number);
+	BF_AutoreleaseScope() {
+		BF_Autorelease($OBJ BO_StringCreate("nested pool on a fiber"));
+		BC_FiberYield();
+	}
+}
+
+typedef struct PRIV_TestRunLoop {
+	BC_RunLoopRef loop;
+	int order[8];
+	size_t count;
+	size_t periodicRuns;
+	BC_RunLoopTimerId periodic;
+	size_t posted;
+	BC_bool current;
+	size_t readBytes;
+	BC_RunLoopSourceId source;
+} PRIV_TestRunLoop;
+
+typedef struct PRIV_TestRunLoopMark {
+	PRIV_TestRunLoop* test;
+	int label;
+} PRIV_TestRunLoopMark;
+
+static void PRIV_TestRunLoopMarkTimer(void* arg) {
+	const PRIV_TestRunLoopMark* mark = arg;
+	mark->test->order[mark->test->count++] = mark->label;
+	mark->test->current = BC_RunLoopCurrent() == mark->test->loop;
+}
+
+static void PRIV_TestRunLoopPeriodic(void* arg) {
+	PRIV_TestRunLoop* test = arg;
+	if (++test->periodicRuns == 3) BC_RunLoopCancelTimer(test->loop, test->periodic);
+}
+
+static void PRIV_TestRunLoopStop(void* arg) {
+	BC_RunLoopStop(((PRIV_TestRunLoop*)arg)->loop);
+}
+
+static void PRIV_TestRunLoopIncrement(void* arg) {
+	// Released when the iteration ends
+	BF_Autorelease($OBJ BO_StringCreate("autoreleased in a run loop task"));
+	((PRIV_TestRunLoop*)arg)->posted++;
+}
+
+static void PRIV_TestRunLoopPoster(void* arg) {
+	PRIV_TestRunLoop* test = arg;
+	for (int i = 0; i < 1000; i++) {
+		BC_RunLoopPost(test->loop, PRIV_TestRunLoopIncrement, test);
+	}
+	BC_RunLoopPost(test->loop, PRIV_TestRunLoopStop, test);
+}
+
+static void PRIV_TestRunLoopNested(void* arg) {
+	PRIV_TestRunLoop* test = arg;
+	for (int i = 0; i < 100; i++) {
+		BC_RunLoopPost(test->loop, PRIV_TestRunLoopIncrement, test);
+	}
+	BC_RunLoopRunOnce(test->loop, 0);
+
+	// Grows the queue past anything used so far while the outer iteration still walks its batch
+	for (int i = 0; i < 4000; i++) {
+		BC_RunLoopPost(test->loop, PRIV_TestRunLoopIncrement, test);
+	}
+}
+
+static void PRIV_TestRunLoopRead(const int fd, const uint32_t events, void* arg) {
+	PRIV_TestRunLoop* test = arg;
+	char buffer[16];
+	const ssize_t count = (events & BC_RunLoopEventReadable) ? read(fd, buffer, sizeof(buffer)) : -1;
+	if (count > 0) test->readBytes += (size_t)count;
+	BC_RunLoopRemoveSource(test->loop, test->source);
+}
+
+#define PRIV_TEST_QUEUE_ITEMS 100000
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+static void PRIV_TestFiberMigrate(void* arg) {
+	BC_FiberResume(arg);
+}
+
+static void PRIV_TestSPSCProducer(void* arg) {
+	const BC_SPSCQueueRef queue = arg;
+	for (uintptr_t i = 1; i <= PRIV_TEST_QUEUE_ITEMS; i++) {
+		while (!BC_SPSCQueuePush(queue, (void*)i)) BC_ThreadYield();
+	}
+}
+
+typedef struct PRIV_TestMPMC {
+	BC_MPMCQueueRef queue;
+	BC_atomic_size consumed;
+	BC_atomic_size sum;
+} PRIV_TestMPMC;
+
+static void PRIV_TestMPMCProducer(void* arg) {
+	PRIV_TestMPMC* test = arg;
+	for (uintptr_t i = 1; i <= PRIV_TEST_QUEUE_ITEMS; i++) {
+		while (!BC_MPMCQueuePush(test->queue, (void*)i)) BC_ThreadYield();
+	}
+}
+
+static void PRIV_TestMPMCConsumer(void* arg) {
+	PRIV_TestMPMC* test = arg;
+	while (BC_atomic_load(&test->consumed) < 2 * PRIV_TEST_QUEUE_ITEMS) {
+		void* item = BC_MPMCQueuePop(test->queue);
+		if (!item) {
+			BC_ThreadYield();
+			continue;
+		}
+		BC_atomic_fetch_add(&test->sum, (size_t)(uintptr_t)item);
+		BC_atomic_fetch_add(&test->consumed, 1);
+	}
+}
+
+typedef struct PRIV_TestLock {
+	BCLock lock;
+	size_t counter;
+} PRIV_TestLock;
+
+static void PRIV_TestLockWorker(void* arg) {
+	PRIV_TestLock* test = arg;
+	for (int i = 0; i < PRIV_TEST_QUEUE_ITEMS; i++) {
+		BC_LockLock(&test->lock);
+		test->counter++;
+		BC_LockUnlock(&test->lock);
+	}
+}
+
+// Writers keep both fields equal, readers fail the invariant on a torn section
+typedef struct PRIV_TestReadMostly {
+	BCRWLock rwlock;
+	BCSeqlock seqlock;
+	size_t first;
+	size_t second;
+	BC_atomic_size seqFirst;
+	BC_atomic_size seqSecond;
+	BC_atomic_size torn;
+} PRIV_TestReadMostly;
+
+static void PRIV_TestRWLockReader(void* arg) {
+	PRIV_TestReadMostly* test = arg;
+	for (int i = 0; i < PRIV_TEST_QUEUE_ITEMS / 10; i++) {
+		BC_RWLockReadLock(&test->rwlock);
+		if (test->first != test->second) BC_atomic_fetch_add(&test->torn, 1);
+		BC_RWLockReadUnlock(&test->rwlock);
+	}
+}
+
+static void PRIV_TestRWLockWriter(void* arg) {
+	PRIV_TestReadMostly* test = arg;
+	for (int i = 0; i < PRIV_TEST_QUEUE_ITEMS / 10; i++) {
+		BC_RWLockWriteLock(&test->rwlock);
+		test->first++;
+		test->second++;
+		BC_RWLockWriteUnlock(&test->rwlock);
+	}
+}
+
+static void PRIV_TestSeqlockReader(void* arg) {
+	PRIV_TestReadMostly* test = arg;
+	for (int i = 0; i < PRIV_TEST_QUEUE_ITEMS / 10; i++) {
+		uint32_t sequence;
+		size_t first, second;
+		do {
+			sequence = BC_SeqlockReadBegin(&test->seqlock);
+			first = BC_atomic_load_relaxed(&test->seqFirst);
+			second = BC_atomic_load_relaxed(&test->seqSecond);
+		} while (BC_SeqlockReadRetry(&test->seqlock, sequence));
+		if (first != second) BC_atomic_fetch_add(&test->torn, 1);
+	}
+}
+
+static void PRIV_TestSeqlockWriter(void* arg) {
+	PRIV_TestReadMostly* test = arg;
+	for (int i = 0; i < PRIV_TEST_QUEUE_ITEMS / 10; i++) {
+		BC_SeqlockWriteLock(&test->seqlock);
+		BC_atomic_store_relaxed(&test->seqFirst, BC_atomic_load_relaxed(&test->seqFirst) + 1);
+		BC_atomic_store_relaxed(&test->seqSecond, BC_atomic_load_relaxed(&test->seqSecond) + 1);
+		BC_SeqlockWriteUnlock(&test->seqlock);
+	}
+}
+
+// Writers swap the shared node and retire the old one while readers check it is intact
+typedef struct PRIV_TestEpochNode {
+	size_t first;
+	size_t second;
+} PRIV_TestEpochNode;
+
+typedef struct PRIV_TestEpoch {
+	BC_ATOMIC_PTR(PRIV_TestEpochNode) current;
+	BC_atomic_size torn;
+	BC_atomic_size reclaimed;
+} PRIV_TestEpoch;
+
+static void PRIV_TestEpochReclaim(void* pointer, void* context) {
+	PRIV_TestEpoch* test = context;
+	PRIV_TestEpochNode* node = pointer;
+	node->first = 0;
+	node->second = 1;
+	BC_AllocatorFree(NULL, node);
+	BC_atomic_fetch_add(&test->reclaimed, 1);
+}
+
+static void PRIV_TestEpochReader(void* arg) {
+	PRIV_TestEpoch* test = arg;
+	for (int i = 0; i < PRIV_TEST_QUEUE_ITEMS / 10; i++) {
+		BC_EpochEnter();
+		const PRIV_TestEpochNode* node = BC_atomic_load_acquire(&test->current);
+		if (node->first != node->second) BC_atomic_fetch_add(&test->torn, 1);
+		BC_EpochExit();
+	}
+}
+
+static void PRIV_TestEpochWriter(void* arg) {
+	PRIV_TestEpoch* test = arg;
+	for (size_t i = 0; i < PRIV_TEST_QUEUE_ITEMS / 10; i++) {
+		PRIV_TestEpochNode* node = BC_AllocatorAlloc(NULL, sizeof(PRIV_TestEpochNode));
+		node->first = i;
+		node->second = i;
+		PRIV_TestEpochNode* old = BC_atomic_exchange_explicit(&test->current, node, BC_memory_order_acq_rel);
+		BC_EpochRetire(old, PRIV_TestEpochReclaim, test);
+	}
+	BC_EpochSynchronize();
+}
+#endif
+
+// =========================================================
+// MARK: Tests
+// =========================================================
+
+void BT_TestThreads(void) {
+	BT_Title("Threads");
+
+	// Test 1: Task groups
+	{
+		BT_Test("Task pool submit and wait");
+
+		const BC_TaskPoolRef pool = BC_TaskPoolCreate(3);
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		BT_Assert(BC_TaskPoolWorkerCount(pool) == 3, "Workers are started");
+#endif
+
+		BC_atomic_size counter = 0;
+		BC_TaskGroup group = BC_TASK_GROUP_INIT;
+		for (int i = 0; i < 1000; i++) {
+			BC_TaskPoolSubmit(pool, &group, PRIV_TestTaskIncrement, &counter);
+		}
+		BC_TaskGroupWait(pool, &group);
+		BT_Assert(BC_atomic_load(&counter) == 1000, "Every task ran once the group is done");
+
+		BC_TaskPoolDestroy(pool);
+	}
+
+	// Test 2: Nested waits
+	{
+		BT_Test("Task pool nested waits");
+
+		const BC_TaskPoolRef pool = BC_TaskPoolCreate(2);
+		PRIV_TestFib fib = {pool, 18, 0};
+		BC_TaskGroup group = BC_TASK_GROUP_INIT;
+		BC_TaskPoolSubmit(pool, &group, PRIV_TestTaskFib, &fib);
+		BC_TaskGroupWait(pool, &group);
+		BT_Assert(fib.result == 2584, "Recursive tasks complete without deadlock");
+
+		BC_TaskPoolDestroy(pool);
+	}
+
+	// Test 3: Parallel for
+	{
+		BT_Test("Task pool parallel for");
+
+		const BC_TaskPoolRef pool = BC_TaskPoolShared();
+		static BC_atomic_uint8 visits[10000];
+		BC_TaskPoolParallelFor(pool, 0, 10000, 0, PRIV_TestTaskRange, visits);
+		BC_TaskPoolParallelFor(pool, 5000, 10000, 7, PRIV_TestTaskRange, visits);
+
+		BC_bool exact = BC_true;
+		for (size_t i = 0; i < 10000; i++) {
+			if (BC_atomic_load(&visits[i]) != (i < 5000 ? 1 : 2)) exact = BC_false;
+		}
+		BT_Assert(exact, "Every index is visited exactly once per call");
+
+		BC_TaskPoolParallelFor(pool, 10, 10, 0, PRIV_TestTaskRange, visits);
+		BT_Assert(BC_atomic_load(&visits[10]) == 1, "Empty ranges run nothing");
+	}
+
+	// Test 4: Autorelease pools on workers
+	{
+		BT_Test("Task pool autorelease pools");
+
+		const BC_TaskPoolRef pool = BC_TaskPoolCreate(2);
+		BC_atomic_size counter = 0;
+		BC_TaskGroup group = BC_TASK_GROUP_INIT;
+		for (int i = 0; i < 64; i++) {
+			BC_TaskPoolSubmit(pool, &group, PRIV_TestTaskAutorelease, &counter);
+		}
+		BC_TaskGroupWait(pool, &group);
+		BT_Assert(BC_atomic_load(&counter) == 64, "Tasks can autorelease objects");
+
+		BC_TaskPoolDestroy(pool);
+	}
+
+	// Test 5: Single producer single consumer queue
+	{
+		BT_Test("SPSC queue");
+
+		const BC_SPSCQueueRef queue = BC_SPSCQueueCreate(100, NULL);
+		BT_Assert(BC_SPSCQueueCapacity(queue) == 128, "Capacity is rounded to a power of two");
+		BT_Assert(BC_SPSCQueuePop(queue) == NULL, "Empty queue pops NULL");
+		BT_Assert(!BC_SPSCQueuePush(queue, NULL), "NULL items are refused");
+
+		BC_bool accepted = BC_true;
+		for (uintptr_t i = 1; i <= 128; i++) {
+			if (!BC_SPSCQueuePush(queue, (void*)i)) accepted = BC_false;
+		}
+		BT_Assert(accepted && !BC_SPSCQueuePush(queue, (void*)1), "Push fails once full");
+		BT_Assert(BC_SPSCQueueCount(queue) == 128, "Count follows pushes");
+		BT_Assert(BC_SPSCQueuePop(queue) == (void*)1, "Items come out in order");
+		while (BC_SPSCQueuePop(queue)) {}
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		BCThread producer;
+		BC_ThreadCreate(&producer, PRIV_TestSPSCProducer, queue);
+		BC_bool ordered = BC_true;
+		for (uintptr_t expected = 1; expected <= PRIV_TEST_QUEUE_ITEMS;) {
+			void* item = BC_SPSCQueuePop(queue);
+			if (!item) {
+				BC_ThreadYield();
+				continue;
+			}
+			if (item != (void*)expected) ordered = BC_false;
+			expected++;
+		}
+		BC_ThreadJoin(producer);
+		BT_Assert(ordered, "Items cross threads in order");
+#endif
+
+		BC_SPSCQueueDestroy(queue);
+	}
+
+	// Test 6: Multi producer multi consumer queue
+	{
+		BT_Test("MPMC queue");
+
+		const BC_MPMCQueueRef queue = BC_MPMCQueueCreate(64, NULL);
+		BT_Assert(BC_MPMCQueueCapacity(queue) == 64, "Capacity is kept when already a power of two");
+		for (uintptr_t i = 1; i <= 64; i++) {
+			BC_MPMCQueuePush(queue, (void*)i);
+		}
+		BT_Assert(!BC_MPMCQueuePush(queue, (void*)1), "Push fails once full");
+		BT_Assert(BC_MPMCQueuePop(queue) == (void*)1 && BC_MPMCQueueCount(queue) == 63, "Items come out in order");
+		while (BC_MPMCQueuePop(queue)) {}
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		PRIV_TestMPMC test = {queue, 0, 0};
+		BCThread threads[4];
+		BC_ThreadCreate(&threads[0], PRIV_TestMPMCProducer, &test);
+		BC_ThreadCreate(&threads[1], PRIV_TestMPMCProducer, &test);
+		BC_ThreadCreate(&threads[2], PRIV_TestMPMCConsumer, &test);
+		BC_ThreadCreate(&threads[3], PRIV_TestMPMCConsumer, &test);
+		for (int i = 0; i < 4; i++) {
+			BC_ThreadJoin(threads[i]);
+		}
+		const size_t expected = (size_t)PRIV_TEST_QUEUE_ITEMS * (PRIV_TEST_QUEUE_ITEMS + 1);
+		BT_Assert(BC_atomic_load(&test.sum) == expected, "Every item is consumed exactly once");
+#endif
+
+		BC_MPMCQueueDestroy(queue);
+	}
+
+	// Test 7: Objects in queues
+	{
+		BT_Test("Queues retain objects");
+
+		const BC_QueueCallbacks counted = {kBO_QueueCallbacksObject.retain, PRIV_TestQueueRelease};
+		gTestQueueReleased = 0;
+
+		const BC_MPMCQueueRef queue = BC_MPMCQueueCreate(8, &counted);
+		const BO_StringRef first = BO_StringCreate("queued first");
+		const BO_StringRef second = BO_StringCreate("queued second");
+		BC_MPMCQueuePush(queue, first);
+		BC_MPMCQueuePush(queue, second);
+
+		// The queue keeps its own references
+		BO_Release($OBJ first);
+		BO_Release($OBJ second);
+
+		const BO_StringRef popped = BC_MPMCQueuePop(queue);
+		BT_Assert(popped == first && strcmp(BO_StringCPtr(popped), "queued first") == 0, "Popped object is still alive");
+		BO_Release($OBJ popped);
+
+		// Popped items are handed over, only the second string is released with the queue
+		BT_Assert(gTestQueueReleased == 0, "Popping hands the reference over");
+		BC_MPMCQueueDestroy(queue);
+		BT_Assert(gTestQueueReleased == 1, "MPMC queue releases the objects it still holds");
+
+		const BC_SPSCQueueRef spsc = BC_SPSCQueueCreate(4, &counted);
+		const BO_StringRef third = BO_StringCreate("queued third");
+		const BO_StringRef fourth = BO_StringCreate("queued fourth");
+		BC_SPSCQueuePush(spsc, third);
+		BC_SPSCQueuePush(spsc, fourth);
+		BO_Release($OBJ third);
+		BO_Release($OBJ fourth);
+		BC_SPSCQueueDestroy(spsc);
+		BT_Assert(gTestQueueReleased == 3, "SPSC queue releases the objects it still holds");
+	}
+
+	// Test 8: Adaptive lock
+	{
+		BT_Test("Adaptive lock");
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		PRIV_TestLock test;
+		BC_LockInit(&test.lock);
+		test.counter = 0;
+
+		BT_Assert(BC_LockTryLock(&test.lock), "Try lock takes a free lock");
+		BT_Assert(!BC_LockTryLock(&test.lock), "Try lock fails on a held lock");
+		BC_LockUnlock(&test.lock);
+
+		BCThread threads[4];
+		for (int i = 0; i < 4; i++) {
+			BC_ThreadCreate(&threads[i], PRIV_TestLockWorker, &test);
+		}
+		for (int i = 0; i < 4; i++) {
+			BC_ThreadJoin(threads[i]);
+		}
+		BT_Assert(test.counter == 4 * PRIV_TEST_QUEUE_ITEMS, "Lock keeps increments exclusive");
+
+		BC_LockStats stats;
+		BC_LockGetStats(&test.lock, &stats);
+#if BC_SETTINGS_LOCK_STATS == 1
+		BT_Assert(stats.acquisitions == 4 * PRIV_TEST_QUEUE_ITEMS + 1, "Acquisitions are counted");
+		BT_Assert(stats.contentions <= stats.acquisitions, "Contentions are a subset of acquisitions");
+#else
+		BT_Assert(stats.acquisitions == 0, "Stats stay empty when disabled");
+#endif
+		BC_LockDestroy(&test.lock);
+#endif
+
+		BC_LockStats poolStats;
+		BO_StringPoolGetLockStats(&poolStats);
+		BT_Assert(poolStats.contentions <= poolStats.acquisitions, "Runtime locks report their stats");
+	}
+
+	// Test 9: Reader writer lock and sequence lock
+	{
+		BT_Test("Reader writer lock and sequence lock");
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		PRIV_TestReadMostly test;
+		BC_RWLockInit(&test.rwlock);
+		BC_SeqlockInit(&test.seqlock);
+		test.first = 0;
+		test.second = 0;
+		BC_atomic_store(&test.seqFirst, 0);
+		BC_atomic_store(&test.seqSecond, 0);
+		BC_atomic_store(&test.torn, 0);
+
+		// Readers share the lock
+		BC_RWLockReadLock(&test.rwlock);
+		BC_RWLockReadLock(&test.rwlock);
+		BC_RWLockReadUnlock(&test.rwlock);
+		BC_RWLockReadUnlock(&test.rwlock);
+
+		BCThread threads[4];
+		BC_ThreadCreate(&threads[0], PRIV_TestRWLockReader, &test);
+		BC_ThreadCreate(&threads[1], PRIV_TestRWLockReader, &test);
+		BC_ThreadCreate(&threads[2], PRIV_TestRWLockWriter, &test);
+		BC_ThreadCreate(&threads[3], PRIV_TestRWLockWriter, &test);
+		for (int i = 0; i < 4; i++) {
+			BC_ThreadJoin(threads[i]);
+		}
+		BT_Assert(test.first == 2 * (PRIV_TEST_QUEUE_ITEMS / 10), "Writers stay exclusive");
+		BT_Assert(BC_atomic_load(&test.torn) == 0, "Readers never see a half written value");
+
+		BC_ThreadCreate(&threads[0], PRIV_TestSeqlockReader, &test);
+		BC_ThreadCreate(&threads[1], PRIV_TestSeqlockReader, &test);
+		BC_ThreadCreate(&threads[2], PRIV_TestSeqlockWriter, &test);
+		BC_ThreadCreate(&threads[3], PRIV_TestSeqlockWriter, &test);
+		for (int i = 0; i < 4; i++) {
+			BC_ThreadJoin(threads[i]);
+		}
+		BT_Assert(BC_atomic_load(&test.seqFirst) == 2 * (PRIV_TEST_QUEUE_ITEMS / 10), "Sequence lock writers stay exclusive");
+		BT_Assert(BC_atomic_load(&test.torn) == 0, "Sequence lock readers retry torn sections");
+
+		BC_SeqlockDestroy(&test.seqlock);
+		BC_RWLockDestroy(&test.rwlock);
+#endif
+
+		// Interning the same text twice goes through the read path the second time
+		const BO_StringPooledRef first = BO_StringPooled("rwlock interned");
+		const BO_StringPooledRef second = BO_StringPooled("rwlock interned");
+		BT_Assert(first == second, "Pooled lookups still find interned strings");
+		BO_Release($OBJ first);
+		BO_Release($OBJ second);
+	}
+
+	// Test 10: Explicit memory order atomics
+	{
+		BT_Test("Explicit memory order atomics");
+
+		BC_atomic_uint64 wide;
+		BC_atomic_store_explicit(&wide, UINT64_C(1) << 40, BC_memory_order_relaxed);
+		BT_Assert(BC_atomic_fetch_add_explicit(&wide, 1, BC_memory_order_relaxed) == UINT64_C(1) << 40, "Fetch add returns the full 64 bit value");
+		BT_Assert(BC_atomic_load_explicit(&wide, BC_memory_order_acquire) == (UINT64_C(1) << 40) + 1, "Fetch add stores the sum");
+
+		BC_atomic_uint32 bits;
+		BC_atomic_store_release(&bits, 0x0F);
+		BT_Assert(BC_atomic_fetch_or_explicit(&bits, 0xF0, BC_memory_order_acq_rel) == 0x0F, "Fetch or returns the old value");
+		BT_Assert(BC_atomic_fetch_and_explicit(&bits, 0x3C, BC_memory_order_acq_rel) == 0xFF, "Fetch and returns the old value");
+		BT_Assert(BC_atomic_exchange_explicit(&bits, 7, BC_memory_order_acq_rel) == 0x3C, "Exchange returns the old value");
+
+		uint32_t expected = 1;
+		BT_Assert(!BC_atomic_compare_exchange_explicit(&bits, &expected, 9, BC_memory_order_acq_rel, BC_memory_order_acquire), "Compare exchange fails on a mismatch");
+		BT_Assert(expected == 7, "Failed compare exchange reports the current value");
+		while (!BC_atomic_compare_exchange_weak_explicit(&bits, &expected, 9, BC_memory_order_acq_rel, BC_memory_order_relaxed)) {}
+		BT_Assert(BC_atomic_load_relaxed(&bits) == 9, "Weak compare exchange succeeds in a loop");
+
+		int value = 42;
+		BC_ATOMIC_PTR(int) pointer;
+		BC_atomic_store_release(&pointer, &value);
+		int* previous = BC_atomic_exchange_explicit(&pointer, NULL, BC_memory_order_acq_rel);
+		BT_Assert(previous == &value && BC_atomic_load_acquire(&pointer) == NULL, "Typed pointers exchange");
+	}
+
+	// Test 11: Epoch reclamation
+	{
+		BT_Test("Epoch reclamation");
+
+		size_t* value = BC_AllocatorAlloc(NULL, sizeof(size_t));
+		const size_t pendingBefore = BC_EpochPendingCount();
+
+		BC_EpochEnter();
+		BC_EpochEnter();
+		BC_EpochRetire(value, BC_EpochReclaimFree, NULL);
+		BC_EpochCollect();
+		BT_Assert(BC_EpochPendingCount() == pendingBefore + 1, "Retired pointers wait while a section is open");
+		BC_EpochExit();
+		BC_EpochExit();
+		BC_EpochSynchronize();
+		BT_Assert(BC_EpochPendingCount() == pendingBefore, "Synchronize reclaims once sections are left");
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		PRIV_TestEpoch test;
+		PRIV_TestEpochNode* first = BC_AllocatorAlloc(NULL, sizeof(PRIV_TestEpochNode));
+		first->first = 0;
+		first->second = 0;
+		BC_atomic_store(&test.current, first);
+		BC_atomic_store(&test.torn, 0);
+		BC_atomic_store(&test.reclaimed, 0);
+
+		BCThread threads[4];
+		BC_ThreadCreate(&threads[0], PRIV_TestEpochReader, &test);
+		BC_ThreadCreate(&threads[1], PRIV_TestEpochReader, &test);
+		BC_ThreadCreate(&threads[2], PRIV_TestEpochWriter, &test);
+		BC_ThreadCreate(&threads[3], PRIV_TestEpochWriter, &test);
+		for (int i = 0; i < 4; i++) {
+			BC_ThreadJoin(threads[i]);
+		}
+
+		BT_Assert(BC_atomic_load(&test.torn) == 0, "Readers never see a reclaimed node");
+		BT_Assert(BC_atomic_load(&test.reclaimed) == 2 * (PRIV_TEST_QUEUE_ITEMS / 10), "Every retired node is reclaimed");
+		BC_AllocatorFree(NULL, BC_atomic_load(&test.current));
+#endif
+	}
+
+	// Test 12: Parallel list algorithms
+	{
+		BT_Test("Parallel list algorithms");
+
+		const size_t count = BO_LIST_PARALLEL_THRESHOLD * 4;
+		const BO_ListRef list = BO_ListCreate();
+		for (size_t i = 0; i < count; i++) {
+			const BO_NumberRef number = (BO_NumberRef)BO_NumberCreateInt64((int64_t)i);
+			BO_ListAdd(list, $OBJ number);
+			BO_Release($OBJ number);
+		}
+
+		const BO_ListRef doubled = BO_ListParallelMap(list, PRIV_TestListDouble, NULL);
+		BC_bool ordered = BO_ListCount(doubled) == count;
+		for (size_t i = 0; ordered && i < count; i++) {
+			ordered = BO_NumberGetInt64((BO_NumberRef)BO_ListGet(doubled, i)) == (int64_t)i * 2;
+		}
+		BT_Assert(ordered, "Map keeps the list order");
+
+		const BO_ListRef even = BO_ListParallelFilter(list, PRIV_TestListIsEven, NULL);
+		BT_Assert(BO_ListCount(even) == count / 2, "Filter keeps matching items");
+		BT_Assert(BO_NumberGetInt64((BO_NumberRef)BO_ListLast(even)) == (int64_t)count - 2, "Filter keeps the list order");
+
+		const BO_ObjectRef zero = $OBJ BO_NumberCreateInt64(0);
+		const BO_ObjectRef sum = BO_ListParallelReduce(list, zero, PRIV_TestListSum, NULL);
+		BT_Assert(BO_NumberGetInt64((BO_NumberRef)sum) == (int64_t)(count * (count - 1) / 2), "Reduce folds every item");
+
+		BC_atomic_size visited = 0;
+		BO_ListParallelForEach(list, PRIV_TestListVisit, &visited);
+		BT_Assert(BC_atomic_load(&visited) == count * (count + 1) / 2, "For each visits every index once");
+
+		const BO_ListRef empty = BO_ListCreate();
+		const BO_ObjectRef emptySum = BO_ListParallelReduce(empty, zero, PRIV_TestListSum, NULL);
+		BT_Assert(emptySum == zero, "Reduce of an empty list is the initial value");
+
+		BO_Release(emptySum);
+		BO_Release($OBJ empty);
+		BO_Release(sum);
+		BO_Release(zero);
+		BO_Release($OBJ even);
+		BO_Release($OBJ doubled);
+		BO_Release($OBJ list);
+	}
+
+	// Test 13: Futures
+	{
+		BT_Test("Futures");
+
+		const BO_FutureRef promise = BO_FutureCreate();
+		BT_Assert(!BO_FutureWait(promise, 1000000), "Wait times out on a pending future");
+		BC_atomic_size completions = 0;
+		BO_FutureOnComplete(promise, PRIV_TestFutureCount, &completions);
+		const BO_ObjectRef value = $OBJ BO_NumberCreateInt64(7);
+		BT_Assert(BO_FutureResolve(promise, value), "First completion wins");
+		BT_Assert(!BO_FutureReject(promise, value), "Later completions are refused");
+		BO_FutureOnComplete(promise, PRIV_TestFutureCount, &completions);
+		BT_Assert(BC_atomic_load(&completions) == 2, "Callbacks run on completion and right away once done");
+		BT_Assert(BO_FutureValue(promise) == value && BO_FutureError(promise) == NULL, "Resolved future holds its value");
+
+		const BO_FutureRef async = BO_FutureAsync(PRIV_TestFutureCompute, (void*)(intptr_t)21);
+		const BO_FutureRef doubled = BO_FutureThen(async, PRIV_TestFutureDouble, NULL);
+		BT_Assert(BO_FutureWait(doubled, BO_FUTURE_WAIT_FOREVER), "Chained future completes");
+		BT_Assert(BO_NumberGetInt64((BO_NumberRef)BO_FutureValue(doubled)) == 42, "Then transforms the value");
+
+		const BO_FutureRef followed = BO_FutureThen(async, PRIV_TestFutureChain, NULL);
+		BO_FutureWait(followed, BO_FUTURE_WAIT_FOREVER);
+		BT_Assert(BO_NumberGetInt64((BO_NumberRef)BO_FutureValue(followed)) == 22, "Then follows a returned future");
+
+		const BO_FutureRef rejected = BO_FutureCreateRejected(value);
+		const BO_FutureRef skipped = BO_FutureThen(rejected, PRIV_TestFutureDouble, NULL);
+		BT_Assert(BO_FutureGetState(skipped) == BO_FutureStateRejected && BO_FutureError(skipped) == value, "Rejections pass through then");
+
+		const BO_ListRef futures = BO_ListCreate();
+		for (intptr_t i = 0; i < 8; i++) {
+			const BO_FutureRef future = BO_FutureAsync(PRIV_TestFutureCompute, (void*)i);
+			BO_ListAdd(futures, $OBJ future);
+			BO_Release($OBJ future);
+		}
+		const BO_FutureRef all = BO_FutureWhenAll(futures);
+		BO_FutureWait(all, BO_FUTURE_WAIT_FOREVER);
+		const BO_ListRef values = (BO_ListRef)BO_FutureValue(all);
+		BC_bool ordered = values && BO_ListCount(values) == 8;
+		for (size_t i = 0; ordered && i < 8; i++) {
+			ordered = BO_NumberGetInt64((BO_NumberRef)BO_ListGet(values, i)) == (int64_t)i;
+		}
+		BT_Assert(ordered, "When all resolves with the values in order");
+
+		// The pending source is released with the any callback still attached
+		const BO_FutureRef never = BO_FutureCreate();
+		const BO_ListRef race = BO_ListCreate();
+		BO_ListAdd(race, $OBJ never);
+		BO_ListAdd(race, $OBJ promise);
+		const BO_FutureRef any = BO_FutureWhenAny(race);
+		BT_Assert(BO_FutureValue(any) == value, "When any completes with the first done future");
+		BT_Assert(BO_FutureWhenAll(values) == NULL, "Combinators refuse lists of non futures");
+
+		BO_Release($OBJ any);
+		BO_Release($OBJ race);
+		BO_Release($OBJ never);
+		BO_Release($OBJ all);
+		BO_Release($OBJ futures);
+		BO_Release($OBJ skipped);
+		BO_Release($OBJ rejected);
+		BO_Release($OBJ followed);
+		BO_Release($OBJ doubled);
+		BO_Release($OBJ async);
+		BO_Release(value);
+		BO_Release($OBJ promise);
+	}
+
+	// Test 14: Fibers
+	{
+		BT_Test("Fibers");
+
+		PRIV_TestFiberTrace trace = {.count = 0};
+		const BC_FiberRef steps = BC_FiberCreate(PRIV_TestFiberSteps, &trace, 0);
+		BT_Assert(steps && BC_FiberCurrent() == NULL, "Fiber created, the caller is not on one");
+		for (int i = 0; i < 6; i += 2) {
+			trace.steps[trace.count++] = i;
+			BC_FiberResume(steps);
+		}
+		BC_bool ordered = trace.count == 6;
+		for (size_t i = 0; ordered && i < 6; i++) {
+			ordered = trace.steps[i] == (int)i;
+		}
+		BT_Assert(ordered, "Yield and resume interleave with the caller");
+		BT_Assert(BC_FiberIsFinished(steps) && !BC_FiberResume(steps), "Finished fiber cannot be resumed");
+		BC_FiberDestroy(steps);
+
+		// Small stacks, only the pages touched are paid for
+		const size_t fiberCount = 10000;
+		BC_FiberRef* fibers = BC_Malloc(fiberCount * sizeof(BC_FiberRef));
+		BC_atomic_size counter = 0;
+		for (size_t i = 0; i < fiberCount; i++) {
+			fibers[i] = BC_FiberCreate(PRIV_TestFiberCount, &counter, BC_KB(16));
+		}
+		size_t finished = 0;
+		for (int round = 0; round < 4; round++) {
+			for (size_t i = 0; i < fiberCount; i++) {
+				BC_FiberResume(fibers[i]);
+			}
+		}
+		for (size_t i = 0; i < fiberCount; i++) {
+			finished += BC_FiberIsFinished(fibers[i]);
+			BC_FiberDestroy(fibers[i]);
+		}
+		BC_Free(fibers);
+		BT_Assert(BC_atomic_load(&counter) == 3 * fiberCount && finished == fiberCount, "Ten thousand fibers resumed round robin");
+
+		int64_t kept = 0;
+		const BC_FiberRef isolated = BC_FiberCreate(PRIV_TestFiberAutorelease, &kept, 0);
+		BF_AutoreleaseScope() {
+			BC_FiberResume(isolated);
+		}
+		BC_FiberResume(isolated);
+		BT_Assert(kept == 5, "Fiber objects outlive the pool of the resumer");
+		BT_Assert(BC_FiberGetState(isolated) == BC_FiberStateSuspended, "Fiber suspended inside a nested pool");
+		BC_FiberDestroy(isolated);
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		PRIV_TestFiberTrace moved = {.count = 0};
+		const BC_FiberRef migrating = BC_FiberCreate(PRIV_TestFiberSteps, &moved, 0);
+		BC_FiberResume(migrating);
+		BCThread thread;
+		BC_ThreadCreate(&thread, PRIV_TestFiberMigrate, migrating);
+		BC_ThreadJoin(thread);
+		BC_FiberResume(migrating);
+		BT_Assert(moved.count == 3 && BC_FiberIsFinished(migrating), "Suspended fiber resumed on another thread");
+		BC_FiberDestroy(migrating);
+#endif
+	}
+
+	// Test 15: Run loop
+	{
+		BT_Test("Run loop");
+
+#if defined(__linux__)
+		PRIV_TestRunLoop test = {.count = 0};
+		test.loop = BC_RunLoopCreate();
+		BT_Assert(test.loop != NULL && BC_RunLoopCurrent() == NULL, "Run loop created");
+
+		// 100ms is past the first level of the wheel and gets cascaded
+		PRIV_TestRunLoopMark marks[4] = {{&test, 1}, {&test, 2}, {&test, 3}, {&test, 9}};
+		const uint64_t start = BC_TimeMonotonicNanoseconds();
+		BC_RunLoopAddTimer(test.loop, 30000000, 0, PRIV_TestRunLoopMarkTimer, &marks[2]);
+		BC_RunLoopAddTimer(test.loop, 10000000, 0, PRIV_TestRunLoopMarkTimer, &marks[0]);
+		BC_RunLoopAddTimer(test.loop, 20000000, 0, PRIV_TestRunLoopMarkTimer, &marks[1]);
+		const BC_RunLoopTimerId cancelled = BC_RunLoopAddTimer(test.loop, 15000000, 0, PRIV_TestRunLoopMarkTimer, &marks[3]);
+		test.periodic = BC_RunLoopAddTimer(test.loop, 5000000, 5000000, PRIV_TestRunLoopPeriodic, &test);
+		BC_RunLoopAddTimer(test.loop, 100000000, 0, PRIV_TestRunLoopStop, &test);
+		BT_Assert(BC_RunLoopCancelTimer(test.loop, cancelled) && !BC_RunLoopCancelTimer(test.loop, cancelled), "Timers cancel once");
+
+		BC_RunLoopRun(test.loop);
+		const uint64_t elapsed = BC_TimeMonotonicNanoseconds() - start;
+		BT_Assert(test.count == 3 && test.order[0] == 1 && test.order[1] == 2 && test.order[2] == 3, "Timers fire in deadline order");
+		BT_Assert(test.current, "Handlers see their loop as current");
+		BT_Assert(test.periodicRuns == 3, "Periodic timer cancels itself");
+		BT_Assert(elapsed >= 100000000, "Timers never fire early");
+
+		const uint64_t idleStart = BC_TimeMonotonicNanoseconds();
+		const size_t idleHandled = BC_RunLoopRunOnce(test.loop, 5000000);
+		BT_Assert(idleHandled == 0 && BC_TimeMonotonicNanoseconds() - idleStart >= 5000000, "Idle iteration sleeps until its timeout");
+
+		int fds[2];
+		if (pipe(fds) == 0) {
+			test.source = BC_RunLoopAddSource(test.loop, fds[0], BC_RunLoopEventReadable, PRIV_TestRunLoopRead, &test);
+			const ssize_t written = write(fds[1], "abc", 3);
+			const size_t handled = BC_RunLoopRunOnce(test.loop, 1000000000);
+			BT_Assert(written == 3 && handled == 1 && test.readBytes == 3, "Readable descriptor calls its source");
+			BT_Assert(!BC_RunLoopModifySource(test.loop, test.source, BC_RunLoopEventWritable), "Removed source is refused");
+			close(fds[0]);
+			close(fds[1]);
+		}
+
+#if BC_SETTINGS_ENABLE_THREAD_SAFETY == 1
+		BCThread thread;
+		BC_ThreadCreate(&thread, PRIV_TestRunLoopPoster, &test);
+		BC_RunLoopRun(test.loop);
+		BC_ThreadJoin(thread);
+#else
+		PRIV_TestRunLoopPoster(&test);
+		BC_RunLoopRun(test.loop);
+#endif
+		BT_Assert(test.posted == 1000, "Posted tasks all run before the stop posted after them");
+
+		test.posted = 0;
+		BC_RunLoopPost(test.loop, PRIV_TestRunLoopNested, &test);
+		for (int i = 0; i < 4; i++) {
+			BC_RunLoopPost(test.loop, PRIV_TestRunLoopIncrement, &test);
+		}
+		BC_RunLoopRunOnce(test.loop, 0);
+		BT_Assert(test.posted == 104, "Nested iterations leave the outer batch intact");
+		BC_RunLoopRunOnce(test.loop, 0);
+		BT_Assert(test.posted == 4104, "Tasks posted during the nested iteration run next");
+
+		// A wrapped deadline would land in the past and fire on the next tick
+		test.count = 0;
+		const BC_RunLoopTimerId never = BC_RunLoopAddTimer(test.loop, UINT64_MAX, UINT64_MAX, PRIV_TestRunLoopMarkTimer, &marks[3]);
+		BC_RunLoopRunOnce(test.loop, 3 * BC_RUN_LOOP_TICK_NANOSECONDS);
+		BT_Assert(test.count == 0 && BC_RunLoopCancelTimer(test.loop, never), "Huge delays saturate instead of wrapping");
+
+		BC_RunLoopDestroy(test.loop);
+#endif
+	}
+}
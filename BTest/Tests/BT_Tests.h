@@ -11,5 +11,7 @@ void BT_TestMap();
 void BT_TestReleasePool();
 void BT_TestClassRegistry();
 void BT_TestBytesArray();
+void BT_TestMemory();
+void BT_TestThreads();
 
 #endif // BCRUNTIME_TESTS_H
@@ -83,6 +83,8 @@ int BF_Main() {
 			BT_TestReleasePool();
 			BT_TestClassRegistry();
 			BT_TestBytesArray();
+			BT_TestMemory();
+			BT_TestThreads();
 
 			BT_Demo();
 
@@ -95,6 +97,8 @@ int BF_Main() {
 	}
 
 	BT_BenchmarkAutoreleasePool();
+	BT_BenchmarkAllocators();
+	BT_BenchmarkLocks();
 
 	return 0;
 }